@@ -0,0 +1,580 @@
+#include "affine_equality_av.hpp"
+
+#include <algorithm>
+
+namespace abstract_domain
+{
+  // Constructors
+  // ============
+  AffineEqualityAv::AffineEqualityAv(const Vocabulary& voc, bool is_universe)
+    : AbstractValue(voc), is_bottom_(!is_universe) {
+  }
+
+  AffineEqualityAv::AffineEqualityAv(const AffineEqualityAv& orig)
+    : AbstractValue(orig.voc_), rows_(orig.rows_), is_bottom_(orig.is_bottom_) {
+  }
+
+  AffineEqualityAv::~AffineEqualityAv() {
+  }
+
+  ref_ptr<AbstractValue> AffineEqualityAv::Copy() const {
+    ref_ptr<AffineEqualityAv> ret = new AffineEqualityAv(*this);
+    return ret.get_ptr();
+  }
+
+  bool AffineEqualityAv::IsDistributive() const {
+    return false;
+  }
+
+  ref_ptr<AbstractValue> AffineEqualityAv::Top() const {
+    return new AffineEqualityAv(this->voc_, true);
+  }
+
+  ref_ptr<AbstractValue> AffineEqualityAv::Bottom() const {
+    return new AffineEqualityAv(this->voc_, false);
+  }
+
+  // The reduced row echelon form is unique, so equal values have equal rows
+  bool AffineEqualityAv::operator==(const AbstractValue& that) const {
+    const AffineEqualityAv* that_ae = static_cast<const AffineEqualityAv*>(&that);
+    if(is_bottom_ || that_ae->is_bottom_)
+      return (is_bottom_ == that_ae->is_bottom_);
+    return (rows_ == that_ae->rows_);
+  }
+
+  // this contains that if each row of this reduces to 0 = 0 with the rows of that
+  bool AffineEqualityAv::Overapproximates(const ref_ptr<AbstractValue>& that) const {
+    const AffineEqualityAv* that_ae = static_cast<const AffineEqualityAv*>(that.get_ptr());
+    if(that_ae->is_bottom_)
+      return true;
+    if(is_bottom_)
+      return false;
+
+    for(rows_type::const_iterator it = rows_.begin(); it != rows_.end(); it++) {
+      Row r = it->second;
+      that_ae->ReduceRow(r);
+      if(!r.coeffs.empty() || r.cst != 0)
+        return false;
+    }
+    return true;
+  }
+
+  bool AffineEqualityAv::IsBottom() const {
+    return is_bottom_;
+  }
+
+  bool AffineEqualityAv::IsTop() const {
+    return !is_bottom_ && rows_.empty();
+  }
+
+  // Join computes the affine hull of this and that. A point x of the hull is x = y + z, where y is in this
+  // scaled by lambda and z is in that scaled by (1 - lambda). Each row sum(a.k) + c = 0 of this gives
+  // sum(a.y_k) + c.lambda = 0, and each row of that gives sum(a.(k - y_k)) + c.(1 - lambda) = 0.
+  // Existentially quantifying y and lambda out of these rows gives the rows of the hull.
+  void AffineEqualityAv::Join(const ref_ptr<AbstractValue>& that) {
+    const AffineEqualityAv* that_ae = static_cast<const AffineEqualityAv*>(that.get_ptr());
+    AddVocabulary(that_ae->GetVocabulary());
+
+    if(that_ae->is_bottom_)
+      return;
+    if(is_bottom_) {
+      rows_ = that_ae->rows_;
+      is_bottom_ = false;
+      return;
+    }
+    if(rows_ == that_ae->rows_)
+      return;
+
+    DimensionKey lambda("__join_lambda", UNVERSIONED_VERSION, utils::thirty_two);
+    Vocabulary elim_voc;
+    elim_voc.insert(lambda);
+
+    std::vector<Row> rows;
+    for(rows_type::const_iterator it = rows_.begin(); it != rows_.end(); it++) {
+      Row r;
+      for(row_coeffs_type::const_iterator cit = it->second.coeffs.begin(); cit != it->second.coeffs.end(); cit++) {
+        DimensionKey y(cit->first.name + "__join", cit->first.ver, cit->first.bitsize);
+        elim_voc.insert(y);
+        r.coeffs.insert(row_coeffs_type::value_type(y, cit->second));
+      }
+      if(it->second.cst != 0)
+        r.coeffs.insert(row_coeffs_type::value_type(lambda, it->second.cst));
+      r.cst = 0;
+      rows.push_back(r);
+    }
+    for(rows_type::const_iterator it = that_ae->rows_.begin(); it != that_ae->rows_.end(); it++) {
+      Row r;
+      for(row_coeffs_type::const_iterator cit = it->second.coeffs.begin(); cit != it->second.coeffs.end(); cit++) {
+        DimensionKey y(cit->first.name + "__join", cit->first.ver, cit->first.bitsize);
+        elim_voc.insert(y);
+        r.coeffs.insert(row_coeffs_type::value_type(cit->first, cit->second));
+        r.coeffs.insert(row_coeffs_type::value_type(y, -cit->second));
+      }
+      if(it->second.cst != 0)
+        r.coeffs.insert(row_coeffs_type::value_type(lambda, -it->second.cst));
+      r.cst = it->second.cst;
+      rows.push_back(r);
+    }
+
+    EliminateVocabulary(rows, elim_voc);
+    Canonicalize(rows);
+  }
+
+  void AffineEqualityAv::Meet(const ref_ptr<AbstractValue>& that) {
+    const AffineEqualityAv* that_ae = static_cast<const AffineEqualityAv*>(that.get_ptr());
+    AddVocabulary(that_ae->GetVocabulary());
+
+    if(that_ae->is_bottom_) {
+      is_bottom_ = true;
+      rows_.clear();
+      return;
+    }
+    for(rows_type::const_iterator it = that_ae->rows_.begin(); it != that_ae->rows_.end(); it++) {
+      AddRow(it->second);
+    }
+  }
+
+  bool AffineEqualityAv::IsConstant(mpz_class& val) const {
+    // Assume that the vocabulary size is 1
+    assert(this->GetVocabulary().size() == 1);
+    if(is_bottom_)
+      return false;
+
+    rows_type::const_iterator it = rows_.find(*(this->voc_.begin()));
+    if(it == rows_.end() || it->second.coeffs.size() != 1)
+      return false;
+
+    mpq_class c = -it->second.cst;
+    if(c.get_den() != 1)
+      return false;
+    val = c.get_num();
+    return true;
+  }
+
+  // Only the constant dimensions are bounded
+  bool AffineEqualityAv::GetIntervals(interval_map_type& im) const {
+    if(is_bottom_)
+      return false;
+
+    for(Vocabulary::const_iterator it = this->voc_.begin(); it != this->voc_.end(); it++) {
+      DimensionInterval itv;
+      rows_type::const_iterator rit = rows_.find(*it);
+      if(rit != rows_.end() && rit->second.coeffs.size() == 1 && rit->second.cst.get_den() == 1) {
+        itv.has_lb = itv.has_ub = true;
+        itv.lb = itv.ub = -rit->second.cst.get_num();
+      }
+      im.insert(interval_map_type::value_type(*it, itv));
+    }
+    return true;
+  }
+
+  // Each row is scaled by the lcm of its denominators to get integral coefficients.
+  // Bottom is given as the equality 0 = 1.
+  bool AffineEqualityAv::GetEqualities(std::vector<constraint_type>& eqs) const {
+    affexp_type zero(linexp_type(), mpz_class(0));
+    if(is_bottom_) {
+      eqs.push_back(constraint_type(std::make_pair(zero, affexp_type(linexp_type(), mpz_class(1))), EQ));
+      return true;
+    }
+
+    for(rows_type::const_iterator it = rows_.begin(); it != rows_.end(); it++) {
+      const Row& r = it->second;
+      mpz_class l = r.cst.get_den();
+      for(row_coeffs_type::const_iterator cit = r.coeffs.begin(); cit != r.coeffs.end(); cit++) {
+        mpz_lcm(l.get_mpz_t(), l.get_mpz_t(), cit->second.get_den_mpz_t());
+      }
+
+      linexp_type le;
+      for(row_coeffs_type::const_iterator cit = r.coeffs.begin(); cit != r.coeffs.end(); cit++) {
+        mpq_class c = cit->second * l;
+        le.insert(linexp_type::value_type(cit->first, c.get_num()));
+      }
+      mpq_class cst = r.cst * l;
+      eqs.push_back(constraint_type(std::make_pair(affexp_type(le, cst.get_num()), zero), EQ));
+    }
+    return true;
+  }
+
+  // Get the vocabulary which directly or indirectly depends on k
+  Vocabulary AffineEqualityAv::GetDependentVocabulary(DimensionKey& k) const {
+    Vocabulary v;
+    v.insert(k);
+    bool reached_fixpoint = false;
+    do {
+      Vocabulary new_v = v;
+      for(rows_type::const_iterator it = rows_.begin(); it != rows_.end(); it++) {
+        bool depends = false;
+        for(row_coeffs_type::const_iterator cit = it->second.coeffs.begin(); cit != it->second.coeffs.end() && !depends; cit++) {
+          depends = (v.find(cit->first) != v.end());
+        }
+        if(depends) {
+          for(row_coeffs_type::const_iterator cit = it->second.coeffs.begin(); cit != it->second.coeffs.end(); cit++) {
+            new_v.insert(cit->first);
+          }
+        }
+      }
+      reached_fixpoint = (new_v.size() == v.size());
+      v = new_v;
+    }
+    while(!reached_fixpoint);
+
+    v.erase(k);
+    return v;
+  }
+
+  void AffineEqualityAv::AddEquality(const DimensionKey& k1, const DimensionKey& k2) {
+    // If k1 and k2 are equal, then equality stands by itself
+    if(k1 == k2)
+      return;
+
+    Row r;
+    r.coeffs.insert(row_coeffs_type::value_type(k1, mpq_class(1)));
+    r.coeffs.insert(row_coeffs_type::value_type(k2, mpq_class(-1)));
+    r.cst = 0;
+    AddRow(r);
+  }
+
+  // The inequalities are dropped
+  void AffineEqualityAv::AddConstraint(affexp_type lhs, affexp_type rhs, OpType op) {
+    if(op != EQ)
+      return;
+    AddRow(GetRow(lhs, rhs));
+  }
+
+  // If e depends on k, with coefficient a, the assignment is invertible: the old value of k is
+  // (k - (e - a.k)) / a, and it is substituted in each row. Otherwise k is forgotten, and k = e is added.
+  void AffineEqualityAv::AssignAffine(const DimensionKey& k, const affexp_type& e) {
+    if(is_bottom_)
+      return;
+
+    linexp_type::const_iterator kit = e.first.find(k);
+    if(kit == e.first.end() || kit->second == 0) {
+      std::vector<Row> rows = GetRows();
+      Vocabulary voc_k; voc_k.insert(k);
+      EliminateVocabulary(rows, voc_k);
+      Canonicalize(rows);
+
+      linexp_type k_le; k_le.insert(linexp_type::value_type(k, mpz_class(1)));
+      AddRow(GetRow(affexp_type(k_le, mpz_class(0)), e));
+      return;
+    }
+
+    mpq_class a = kit->second;
+    Row old_k;
+    for(linexp_type::const_iterator it = e.first.begin(); it != e.first.end(); it++) {
+      if(it->first == k)
+        old_k.coeffs.insert(row_coeffs_type::value_type(k, 1/a));
+      else if(it->second != 0)
+        old_k.coeffs.insert(row_coeffs_type::value_type(it->first, -it->second/a));
+    }
+    old_k.cst = -e.second/a;
+
+    std::vector<Row> rows;
+    for(rows_type::const_iterator it = rows_.begin(); it != rows_.end(); it++) {
+      Row r = it->second;
+      row_coeffs_type::iterator rkit = r.coeffs.find(k);
+      if(rkit != r.coeffs.end()) {
+        mpq_class c = rkit->second;
+        r.coeffs.erase(rkit);
+        AddScaledRow(r, c, old_k);
+      }
+      rows.push_back(r);
+    }
+    Canonicalize(rows);
+  }
+
+  // The dimensions of dirty that are constant in that are added as rows. A new constant k = c gives new
+  // equalities on the dimensions of the rows with k, which are reported as changed.
+  void AffineEqualityAv::ReduceDimensions(const ref_ptr<AbstractValue>& that, const Vocabulary& dirty, Vocabulary& changed) {
+    interval_map_type im;
+    if(is_bottom_ || !that->GetIntervals(im))
+      return;
+
+    for(Vocabulary::const_iterator it = dirty.begin(); it != dirty.end(); it++) {
+      interval_map_type::const_iterator iit = im.find(*it);
+      mpz_class c;
+      if(iit == im.end() || !iit->second.IsConstant(c))
+        continue;
+
+      rows_type::const_iterator rit = rows_.find(*it);
+      if(rit != rows_.end() && rit->second.coeffs.size() == 1 && rit->second.cst == -c)
+        continue; // k = c is already known
+
+      Row r;
+      r.coeffs.insert(row_coeffs_type::value_type(*it, mpq_class(1)));
+      r.cst = -c;
+      for(rows_type::const_iterator rit = rows_.begin(); rit != rows_.end(); rit++) {
+        if(rit->second.coeffs.find(*it) == rit->second.coeffs.end())
+          continue;
+        for(row_coeffs_type::const_iterator cit = rit->second.coeffs.begin(); cit != rit->second.coeffs.end(); cit++) {
+          changed.insert(cit->first);
+        }
+      }
+      AddRow(r);
+      if(is_bottom_)
+        return;
+    }
+  }
+
+  // Havoc: Havoc out the vocabulary v, i.e. remove any constraints on them
+  ref_ptr<AbstractValue> AffineEqualityAv::Havoc(const Vocabulary& v) const {
+    ref_ptr<AffineEqualityAv> ret = new AffineEqualityAv(*this);
+    if(!is_bottom_) {
+      std::vector<Row> rows = GetRows();
+      EliminateVocabulary(rows, v);
+      ret->Canonicalize(rows);
+    }
+    return ret.get_ptr();
+  }
+
+  // =====================
+  // Vocabulary operations
+  // =====================
+  // project: project onto Vocabulary v.
+  void AffineEqualityAv::Project(const Vocabulary& v) {
+    Vocabulary proj_out_voc;
+    SubtractVocabularies(this->voc_, v, proj_out_voc);
+    if(proj_out_voc.size() == 0)
+      return; // Projecting on all the variables changes nothing
+
+    Vocabulary inters;
+    IntersectVocabularies(v, this->voc_, inters);
+    this->voc_ = inters;
+
+    if(is_bottom_)
+      return;
+    std::vector<Row> rows = GetRows();
+    EliminateVocabulary(rows, proj_out_voc);
+    Canonicalize(rows);
+  }
+
+  // The new dimensions are unconstrained
+  void AffineEqualityAv::AddVocabulary(const Vocabulary& v) {
+    Vocabulary union_voc;
+    UnionVocabularies(this->voc_, v, union_voc);
+    this->voc_ = union_voc;
+  }
+
+  // The renaming can change the order of the dimensions, so the rows are put back in echelon form
+  void AffineEqualityAv::ReplaceVersions(const std::map<Version, Version>& map) {
+    this->voc_ = abstract_domain::replaceVersions(this->voc_, map);
+    if(is_bottom_)
+      return;
+
+    std::vector<Row> rows;
+    for(rows_type::const_iterator it = rows_.begin(); it != rows_.end(); it++) {
+      Row r;
+      for(row_coeffs_type::const_iterator cit = it->second.coeffs.begin(); cit != it->second.coeffs.end(); cit++) {
+        r.coeffs.insert(row_coeffs_type::value_type(abstract_domain::replaceVersions(cit->first, map), cit->second));
+      }
+      r.cst = it->second.cst;
+      rows.push_back(r);
+    }
+    Canonicalize(rows);
+  }
+
+  // Input/output
+  std::string AffineEqualityAv::ToString() const {
+    std::stringstream o;
+    o << "AffineEqualityAv(voc_size: " << this->voc_.size() << ", num rows: " << rows_.size() << "), ptr is " << this << ":";
+    if(is_bottom_)
+      o << "\nfalse";
+    for(rows_type::const_iterator it = rows_.begin(); it != rows_.end(); it++) {
+      o << "\n";
+      for(row_coeffs_type::const_iterator cit = it->second.coeffs.begin(); cit != it->second.coeffs.end(); cit++) {
+        o << cit->second << "*";
+        abstract_domain::print(o, cit->first);
+        o << " + ";
+      }
+      o << it->second.cst << " = 0";
+    }
+    o << "\n";
+    return o.str();
+  }
+
+  // Serialized form: is_bottom_, the vocabulary, and then the rows. Each row is written as its
+  // coefficients as (position in the sorted vocabulary, coeff) pairs and its constant.
+  void AffineEqualityAv::Serialize(std::ostream& out) const {
+    out << is_bottom_ << " ";
+    SerializeVocabulary(out, this->voc_);
+    out << rows_.size() << " ";
+    for(rows_type::const_iterator it = rows_.begin(); it != rows_.end(); it++) {
+      out << it->second.coeffs.size() << " ";
+      for(row_coeffs_type::const_iterator cit = it->second.coeffs.begin(); cit != it->second.coeffs.end(); cit++) {
+        out << std::distance(this->voc_.begin(), this->voc_.find(cit->first)) << " " << cit->second << " ";
+      }
+      out << it->second.cst << " ";
+    }
+  }
+
+  ref_ptr<AbstractValue> AffineEqualityAv::Deserialize(std::istream& in) const {
+    bool is_bottom;
+    in >> is_bottom;
+    Vocabulary voc = DeserializeVocabulary(in);
+    ref_ptr<AffineEqualityAv> ret = new AffineEqualityAv(voc, !is_bottom);
+    std::vector<DimensionKey> keys(voc.begin(), voc.end());
+
+    unsigned num_rows = 0;
+    in >> num_rows;
+    for(unsigned i = 0; i < num_rows; i++) {
+      unsigned num_coeffs = 0;
+      in >> num_coeffs;
+      Row r;
+      for(unsigned j = 0; j < num_coeffs; j++) {
+        unsigned idx;
+        mpq_class coeff;
+        in >> idx >> coeff;
+        r.coeffs.insert(row_coeffs_type::value_type(keys[idx], coeff));
+      }
+      in >> r.cst;
+      ret->AddRow(r);
+    }
+    return ret.get_ptr();
+  }
+
+  // The rows are in reduced row echelon form, so equal values have the same rows
+  size_t AffineEqualityAv::Hash() const {
+    size_t h = HashCombine(HashVocabulary(this->voc_), is_bottom_);
+    for(rows_type::const_iterator it = rows_.begin(); it != rows_.end(); it++) {
+      const Row& r = it->second;
+      for(row_coeffs_type::const_iterator c_it = r.coeffs.begin(); c_it != r.coeffs.end(); c_it++) {
+        h = HashCombine(h, HashDimensionKey(c_it->first));
+        h = HashCombine(h, (size_t)c_it->second.get_num().get_si());
+        h = HashCombine(h, (size_t)c_it->second.get_den().get_si());
+      }
+      h = HashCombine(h, (size_t)r.cst.get_num().get_si());
+      h = HashCombine(h, (size_t)r.cst.get_den().get_si());
+    }
+    return h;
+  }
+
+  bool AffineEqualityAv::StructurallyEqual(const AbstractValue& that) const {
+    const AffineEqualityAv* that_ae = static_cast<const AffineEqualityAv*>(&that);
+    return (this->voc_ == that_ae->voc_) && (is_bottom_ == that_ae->is_bottom_) && (rows_ == that_ae->rows_);
+  }
+
+  // ==================
+  // Row operations
+  // ==================
+  void AffineEqualityAv::AddRow(Row r) {
+    if(is_bottom_)
+      return;
+
+    ReduceRow(r);
+    if(r.coeffs.empty()) {
+      // 0 = cst is either redundant or unsatisfiable
+      if(r.cst != 0) {
+        is_bottom_ = true;
+        rows_.clear();
+      }
+      return;
+    }
+
+    // The pivot of r is its smallest dimension, it is normalized to coefficient 1
+    DimensionKey p = r.coeffs.begin()->first;
+    mpq_class inv = 1 / r.coeffs.begin()->second;
+    for(row_coeffs_type::iterator it = r.coeffs.begin(); it != r.coeffs.end(); it++) {
+      it->second *= inv;
+    }
+    r.cst *= inv;
+
+    // Eliminate p from the other rows, p is larger than their pivots and so are the dimensions of r
+    for(rows_type::iterator it = rows_.begin(); it != rows_.end(); it++) {
+      row_coeffs_type::const_iterator pit = it->second.coeffs.find(p);
+      if(pit != it->second.coeffs.end()) {
+        mpq_class c = pit->second;
+        AddScaledRow(it->second, -c, r);
+      }
+    }
+    rows_.insert(rows_type::value_type(p, r));
+  }
+
+  // The pivots of the rows do not appear in the other rows, so subtracting a row never adds a pivot to r
+  void AffineEqualityAv::ReduceRow(Row& r) const {
+    std::vector<DimensionKey> keys;
+    for(row_coeffs_type::const_iterator it = r.coeffs.begin(); it != r.coeffs.end(); it++) {
+      keys.push_back(it->first);
+    }
+    for(std::vector<DimensionKey>::const_iterator it = keys.begin(); it != keys.end(); it++) {
+      rows_type::const_iterator rit = rows_.find(*it);
+      if(rit == rows_.end())
+        continue;
+      row_coeffs_type::const_iterator cit = r.coeffs.find(*it);
+      if(cit == r.coeffs.end())
+        continue;
+      mpq_class c = cit->second;
+      AddScaledRow(r, -c, rit->second);
+    }
+  }
+
+  // For each k of voc, a row with k is used to substitute k in the other rows, and then dropped
+  void AffineEqualityAv::EliminateVocabulary(std::vector<Row>& rows, const Vocabulary& voc) {
+    for(Vocabulary::const_iterator vit = voc.begin(); vit != voc.end(); vit++) {
+      std::vector<Row>::iterator r_it = rows.begin();
+      for(; r_it != rows.end(); r_it++) {
+        if(r_it->coeffs.find(*vit) != r_it->coeffs.end())
+          break;
+      }
+      if(r_it == rows.end())
+        continue;
+
+      Row r = *r_it;
+      rows.erase(r_it);
+      mpq_class a = r.coeffs[*vit];
+      for(std::vector<Row>::iterator it = rows.begin(); it != rows.end(); it++) {
+        row_coeffs_type::const_iterator cit = it->coeffs.find(*vit);
+        if(cit != it->coeffs.end()) {
+          mpq_class c = cit->second / a;
+          AddScaledRow(*it, -c, r);
+        }
+      }
+    }
+  }
+
+  std::vector<AffineEqualityAv::Row> AffineEqualityAv::GetRows() const {
+    std::vector<Row> rows;
+    for(rows_type::const_iterator it = rows_.begin(); it != rows_.end(); it++) {
+      rows.push_back(it->second);
+    }
+    return rows;
+  }
+
+  void AffineEqualityAv::Canonicalize(const std::vector<Row>& rows) {
+    rows_.clear();
+    is_bottom_ = false;
+    for(std::vector<Row>::const_iterator it = rows.begin(); it != rows.end(); it++) {
+      AddRow(*it);
+    }
+  }
+
+  // r := r + c.s
+  void AffineEqualityAv::AddScaledRow(Row& r, const mpq_class& c, const Row& s) {
+    for(row_coeffs_type::const_iterator it = s.coeffs.begin(); it != s.coeffs.end(); it++) {
+      mpq_class& r_coeff = r.coeffs[it->first];
+      r_coeff += c * it->second;
+      if(r_coeff == 0)
+        r.coeffs.erase(it->first);
+    }
+    r.cst += c * s.cst;
+  }
+
+  // The row lhs - rhs = 0
+  AffineEqualityAv::Row AffineEqualityAv::GetRow(const affexp_type& lhs, const affexp_type& rhs) {
+    Row r;
+    for(linexp_type::const_iterator it = lhs.first.begin(); it != lhs.first.end(); it++) {
+      r.coeffs[it->first] += mpq_class(it->second);
+    }
+    for(linexp_type::const_iterator it = rhs.first.begin(); it != rhs.first.end(); it++) {
+      r.coeffs[it->first] -= mpq_class(it->second);
+    }
+    for(row_coeffs_type::iterator it = r.coeffs.begin(); it != r.coeffs.end(); ) {
+      if(it->second == 0)
+        r.coeffs.erase(it++);
+      else
+        it++;
+    }
+    r.cst = lhs.second - rhs.second;
+    return r;
+  }
+
+} // abstract_domain
@@ -0,0 +1,132 @@
+#ifndef src_AbstractDomain_AffineEquality_affine_equality_av_hpp
+#define src_AbstractDomain_AffineEquality_affine_equality_av_hpp
+
+#include <sstream>
+#include <vector>
+
+#include "src/AbstractDomain/common/AbstractValue.hpp"
+
+namespace abstract_domain
+{
+  /* AffineEqualityAv: Karr's domain of affine equalities over the rationals.
+     A value is kept as a matrix of equalities sum(coeff.k) + cst = 0 in reduced row echelon form:
+     each row has a pivot, which is the smallest dimension of the row, its coefficient is 1, and it
+     does not appear in the other rows. This form is unique, so two values are equal when their rows
+     are equal. All the operations are gaussian eliminations over these rows, and the inequalities
+     are dropped.
+
+     It is meant to be used as the equality component of a ReducedProductAbsVal, in place of
+     PointsetPowersetAv<C_Polyhedron> with equalities_only set, which uses double description
+     polyhedra to represent the same equalities.
+  */
+  class AffineEqualityAv : public AbstractValue {
+  public:
+    typedef std::map<DimensionKey, mpq_class> row_coeffs_type;
+    // An equality sum(coeffs.k) + cst = 0
+    struct Row {
+      row_coeffs_type coeffs;
+      mpq_class cst;
+
+      bool operator==(const Row& that) const {
+        return (coeffs == that.coeffs) && (cst == that.cst);
+      }
+    };
+    // The rows indexed by their pivot
+    typedef std::map<DimensionKey, Row> rows_type;
+
+    // Constructors
+    // ============
+    // Default constructor builds top -- no equality.
+    AffineEqualityAv(const Vocabulary& voc, bool is_universe = true);
+    AffineEqualityAv(const AffineEqualityAv& orig);
+    ~AffineEqualityAv();
+
+    ref_ptr<AbstractValue> Copy() const;
+
+    bool IsDistributive() const;
+
+    // Other ways to create AffineEqualityAv elements
+    // ====================================
+    ref_ptr<AbstractValue> Top() const;
+    ref_ptr<AbstractValue> Bottom() const;
+
+    // Comparison operations
+    bool operator== (const AbstractValue& that) const;
+    bool Overapproximates(const ref_ptr<AbstractValue>&) const;
+
+    // Abstract Domain operations
+    bool IsBottom() const;
+    bool IsTop() const;
+    void Join(const ref_ptr<AbstractValue>&);
+    void JoinSingleton(const ref_ptr<AbstractValue>& av) {
+      Join(av);
+    }
+    void Meet(const ref_ptr<AbstractValue>&);
+
+    // Wrap is ignored, as for PointsetPowersetAv with equalities_only set
+    void Wrap(const std::map<DimensionKey, bool>& vs) {
+    }
+
+    bool IsConstant(mpz_class& val) const;
+    bool GetIntervals(interval_map_type& im) const;
+    bool GetEqualities(std::vector<constraint_type>& eqs) const;
+    Vocabulary GetDependentVocabulary(DimensionKey& k) const;
+
+    void AddEquality(const DimensionKey& v1, const DimensionKey& v2);
+    void AddConstraint(affexp_type lhs, affexp_type rhs, OpType op);
+    void AssignAffine(const DimensionKey& k, const affexp_type& e);
+
+    // Havoc: Havoc out the vocabulary v
+    ref_ptr<AbstractValue> Havoc(const Vocabulary& v) const;
+
+    // The rows are always reduced
+    void Reduce() {
+    }
+    void Reduce(const ref_ptr<AbstractValue>& that) {
+    }
+    void ReduceDimensions(const ref_ptr<AbstractValue>& that, const Vocabulary& dirty, Vocabulary& changed);
+
+    // Vocabulary operations
+    // =====================
+    // project: project onto Vocabulary v.
+    void Project(const Vocabulary&);
+    void AddVocabulary(const Vocabulary&);
+    void ReplaceVersions(const std::map<Version, Version>&);
+
+    // Input/output
+    std::string ToString() const;
+    void Serialize(std::ostream& out) const;
+    ref_ptr<AbstractValue> Deserialize(std::istream& in) const;
+    size_t Hash() const;
+    bool StructurallyEqual(const AbstractValue& that) const;
+
+    // Budget support
+    size_t NumConstraints() const {
+      return rows_.size();
+    }
+
+  private:
+    // Reduces r with the rows, and adds it as a new row if it is not implied by them
+    void AddRow(Row r);
+
+    // Reduces r with the rows, so that r has no pivot of the rows
+    void ReduceRow(Row& r) const;
+
+    // Existentially quantifies the dimensions of voc out of rows
+    static void EliminateVocabulary(std::vector<Row>& rows, const Vocabulary& voc);
+    std::vector<Row> GetRows() const;
+
+    // Rebuilds the rows in reduced row echelon form
+    void Canonicalize(const std::vector<Row>& rows);
+
+    static void AddScaledRow(Row& r, const mpq_class& c, const Row& s);
+    static Row GetRow(const affexp_type& lhs, const affexp_type& rhs);
+
+    // Data members
+    rows_type rows_;
+    bool is_bottom_;
+  };
+
+} // abstract_domain
+
+#endif // src_AbstractDomain_AffineEquality_affine_equality_av_hpp
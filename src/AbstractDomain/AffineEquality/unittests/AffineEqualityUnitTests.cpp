@@ -0,0 +1,193 @@
+#include "src/AbstractDomain/AffineEquality/affine_equality_av.hpp"
+
+//Avoid mutiple macro redefinition
+#define GTEST_DONT_DEFINE_TEST 1
+#include "gtest/gtest.h"
+
+using namespace abstract_domain;
+
+typedef AbstractValue AV;
+
+class AffineEqualityTest : public ::testing::Test {
+public:
+  AffineEqualityTest()
+    : k0("k0", 0, utils::thirty_two), k1("k1", 0, utils::thirty_two), k2("k2", 0, utils::thirty_two) {
+    voc.insert(k0);
+    voc.insert(k1);
+    voc.insert(k2);
+    av = new AffineEqualityAv(voc);
+  }
+
+  // k = c
+  void AddConstant(wali::ref_ptr<AV> a, const DimensionKey& k, int c) {
+    AV::linexp_type k_le;
+    k_le.insert(AV::linexp_type::value_type(k, mpz_class(1)));
+    a->AddConstraint(AV::affexp_type(k_le, mpz_class(0)), AV::affexp_type(AV::linexp_type(), mpz_class(c)), AV::OpType::EQ);
+  }
+
+  DimensionKey k0, k1, k2;
+  Vocabulary voc;
+  wali::ref_ptr<AV> av;
+};
+
+TEST_F(AffineEqualityTest, TopAndBottom) {
+  EXPECT_TRUE(av->Top()->IsTop());
+  EXPECT_TRUE(av->Bottom()->IsBottom());
+  EXPECT_TRUE(av->Overapproximates(av->Bottom()));
+  EXPECT_FALSE(av->Bottom()->Overapproximates(av));
+}
+
+// The join of the points (1, 2) and (3, 6) is the line k1 = 2*k0
+TEST_F(AffineEqualityTest, JoinIsAffineHull) {
+  wali::ref_ptr<AV> a = av->Copy();
+  AddConstant(a, k0, 1);
+  AddConstant(a, k1, 2);
+  wali::ref_ptr<AV> b = av->Copy();
+  AddConstant(b, k0, 3);
+  AddConstant(b, k1, 6);
+
+  wali::ref_ptr<AV> aJoinB = a->Copy();
+  aJoinB->Join(b);
+  wali::ref_ptr<AV> bJoinA = b->Copy();
+  bJoinA->Join(a);
+  EXPECT_EQ(*aJoinB, *bJoinA);
+
+  wali::ref_ptr<AV> line = av->Copy();
+  AV::linexp_type k0_le, k1_le;
+  k0_le.insert(AV::linexp_type::value_type(k0, mpz_class(2)));
+  k1_le.insert(AV::linexp_type::value_type(k1, mpz_class(1)));
+  line->AddConstraint(AV::affexp_type(k1_le, mpz_class(0)), AV::affexp_type(k0_le, mpz_class(0)), AV::OpType::EQ);
+  EXPECT_EQ(*line, *aJoinB);
+  EXPECT_TRUE(aJoinB->Overapproximates(a));
+  EXPECT_FALSE(a->Overapproximates(aJoinB));
+
+  wali::ref_ptr<AV> aMeetB = a->Copy();
+  aMeetB->Meet(b);
+  EXPECT_TRUE(aMeetB->IsBottom());
+}
+
+// k2 := k0 + 1 followed by the invertible k0 := k0 + k2 gives k0 = 2*k2 - 1
+TEST_F(AffineEqualityTest, AssignAffineAndProject) {
+  wali::ref_ptr<AV> a = av->Copy();
+  AV::linexp_type e1, e2;
+  e1.insert(AV::linexp_type::value_type(k0, mpz_class(1)));
+  a->AssignAffine(k2, AV::affexp_type(e1, mpz_class(1)));
+  e2.insert(AV::linexp_type::value_type(k0, mpz_class(1)));
+  e2.insert(AV::linexp_type::value_type(k2, mpz_class(1)));
+  a->AssignAffine(k0, AV::affexp_type(e2, mpz_class(0)));
+
+  wali::ref_ptr<AV> expected = av->Copy();
+  AV::linexp_type k0_le, k2_le;
+  k0_le.insert(AV::linexp_type::value_type(k0, mpz_class(1)));
+  k2_le.insert(AV::linexp_type::value_type(k2, mpz_class(2)));
+  expected->AddConstraint(AV::affexp_type(k0_le, mpz_class(0)), AV::affexp_type(k2_le, mpz_class(-1)), AV::OpType::EQ);
+  EXPECT_EQ(*expected, *a);
+
+  std::vector<AV::constraint_type> eqs;
+  EXPECT_TRUE(a->GetEqualities(eqs));
+  EXPECT_EQ(1u, eqs.size());
+
+  Vocabulary k0_voc;
+  k0_voc.insert(k0);
+  a->Project(k0_voc);
+  EXPECT_TRUE(a->IsTop());
+}
+
+// k0 = k1 + k2 and the constant k2 = 2 of that give k0 = k1 + 2, only k2 is dirty
+TEST_F(AffineEqualityTest, ReduceDimensionsWithConstants) {
+  wali::ref_ptr<AV> a = av->Copy();
+  AV::linexp_type k0_le, k12_le;
+  k0_le.insert(AV::linexp_type::value_type(k0, mpz_class(1)));
+  k12_le.insert(AV::linexp_type::value_type(k1, mpz_class(1)));
+  k12_le.insert(AV::linexp_type::value_type(k2, mpz_class(1)));
+  a->AddConstraint(AV::affexp_type(k0_le, mpz_class(0)), AV::affexp_type(k12_le, mpz_class(0)), AV::OpType::EQ);
+
+  wali::ref_ptr<AV> that = av->Copy();
+  AddConstant(that, k2, 2);
+  AddConstant(that, k1, 7);
+
+  Vocabulary dirty, changed;
+  dirty.insert(k2);
+  a->ReduceDimensions(that, dirty, changed);
+  EXPECT_EQ(3u, changed.size());
+
+  wali::ref_ptr<AV> expected = av->Copy();
+  AV::linexp_type k1_le;
+  k1_le.insert(AV::linexp_type::value_type(k1, mpz_class(1)));
+  expected->AddConstraint(AV::affexp_type(k0_le, mpz_class(0)), AV::affexp_type(k1_le, mpz_class(2)), AV::OpType::EQ);
+  AddConstant(expected, k2, 2);
+  EXPECT_EQ(*expected, *a);
+
+  // Nothing changes when k2 = 2 is already known
+  changed.clear();
+  a->ReduceDimensions(that, dirty, changed);
+  EXPECT_TRUE(changed.empty());
+}
+
+// k0 := k1 and k1 := k0 + 10 at once from (1, 2) gives (2, 11), each expression reads the values before the assignments
+TEST_F(AffineEqualityTest, AssignAffineParallel) {
+  wali::ref_ptr<AV> a = av->Copy();
+  AddConstant(a, k0, 1);
+  AddConstant(a, k1, 2);
+  AV::linexp_type k0_le, k1_le;
+  k0_le.insert(AV::linexp_type::value_type(k0, mpz_class(1)));
+  k1_le.insert(AV::linexp_type::value_type(k1, mpz_class(1)));
+  std::vector<AV::assignment_type> as;
+  as.push_back(AV::assignment_type(k0, AV::affexp_type(k1_le, mpz_class(0))));
+  as.push_back(AV::assignment_type(k1, AV::affexp_type(k0_le, mpz_class(10))));
+  a->AssignAffineParallel(as);
+
+  wali::ref_ptr<AV> expected = av->Copy();
+  AddConstant(expected, k0, 2);
+  AddConstant(expected, k1, 11);
+  EXPECT_EQ(*expected, *a);
+  EXPECT_EQ(a->GetVocabulary(), voc);
+}
+
+// The join of (1, 2) and (3, 6) and the line k1 = 2*k0 are equal, and so are their hashes
+TEST_F(AffineEqualityTest, EqualValuesHaveEqualHashes) {
+  wali::ref_ptr<AV> a = av->Copy();
+  AddConstant(a, k0, 1);
+  AddConstant(a, k1, 2);
+  wali::ref_ptr<AV> b = av->Copy();
+  AddConstant(b, k0, 3);
+  AddConstant(b, k1, 6);
+  a->Join(b);
+
+  wali::ref_ptr<AV> line = av->Copy();
+  AV::linexp_type k0_le, k1_le;
+  k0_le.insert(AV::linexp_type::value_type(k0, mpz_class(2)));
+  k1_le.insert(AV::linexp_type::value_type(k1, mpz_class(1)));
+  line->AddConstraint(AV::affexp_type(k1_le, mpz_class(0)), AV::affexp_type(k0_le, mpz_class(0)), AV::OpType::EQ);
+  EXPECT_EQ(*line, *a);
+  EXPECT_EQ(line->Hash(), a->Hash());
+  EXPECT_NE(line->Hash(), b->Hash());
+  EXPECT_NE(av->Hash(), av->Bottom()->Hash());
+}
+
+// The rows are kept in reduced row echelon form, so equal values are also structurally equal
+TEST_F(AffineEqualityTest, EqualValuesAreStructurallyEqual) {
+  wali::ref_ptr<AV> a = av->Copy();
+  AddConstant(a, k0, 1);
+  AddConstant(a, k1, 2);
+  wali::ref_ptr<AV> b = av->Copy();
+  AddConstant(b, k0, 3);
+  AddConstant(b, k1, 6);
+  wali::ref_ptr<AV> b_copy = b->Copy();
+  a->Join(b);
+
+  wali::ref_ptr<AV> line = av->Copy();
+  AV::linexp_type k0_le, k1_le;
+  k0_le.insert(AV::linexp_type::value_type(k0, mpz_class(2)));
+  k1_le.insert(AV::linexp_type::value_type(k1, mpz_class(1)));
+  line->AddConstraint(AV::affexp_type(k1_le, mpz_class(0)), AV::affexp_type(k0_le, mpz_class(0)), AV::OpType::EQ);
+  EXPECT_TRUE(line->StructurallyEqual(*a));
+  EXPECT_TRUE(b->StructurallyEqual(*b_copy));
+  EXPECT_FALSE(line->StructurallyEqual(*b));
+  EXPECT_FALSE(av->StructurallyEqual(*av->Bottom()));
+}
+
+int main(int argc, char* argv[]) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -2,6 +2,7 @@
 
 #include "ppl.hh"
 
+// Certificate of the BHZ03 widening for the weakly-relational shapes, Octagonal_Shape and BD_Shape
 class Octagonal_Shape_Certificate {
 public:
   //! Default constructor.
@@ -11,14 +12,14 @@ public:
   }
 
   //! Constructor: computes the certificate for \p ph.
-  Octagonal_Shape_Certificate(const Parma_Polyhedra_Library::Octagonal_Shape<mpz_class>& ph) 
-    : affine_dim(ph.affine_dimension()), num_constraints(0) {
-    // It is assumed that `ph' is not an empty polyhedron.
-    PPL_ASSERT(!ph.marked_empty());
-    Parma_Polyhedra_Library::Constraint_System cs = ph.minimized_constraints();
-    for(Parma_Polyhedra_Library::Constraint_System::const_iterator it = cs.begin(); it != cs.end(); it++) {
-      num_constraints++;
-    }
+  template <typename T>
+  Octagonal_Shape_Certificate(const Parma_Polyhedra_Library::Octagonal_Shape<T>& ph) 
+    : affine_dim(ph.affine_dimension()), num_constraints(NumConstraints(ph)) {
+  }
+
+  template <typename T>
+  Octagonal_Shape_Certificate(const Parma_Polyhedra_Library::BD_Shape<T>& ph) 
+    : affine_dim(ph.affine_dimension()), num_constraints(NumConstraints(ph)) {
   }
 
   //! Copy constructor.
@@ -43,7 +44,14 @@ public:
   }
 
   //! Compares \p *this with the certificate for polyhedron \p ph.
-  int compare(const Parma_Polyhedra_Library::Octagonal_Shape<mpz_class>& ph) const {
+  template <typename T>
+  int compare(const Parma_Polyhedra_Library::Octagonal_Shape<T>& ph) const {
+    Octagonal_Shape_Certificate y(ph);
+    return compare(y);
+  }
+
+  template <typename T>
+  int compare(const Parma_Polyhedra_Library::BD_Shape<T>& ph) const {
     Octagonal_Shape_Certificate y(ph);
     return compare(y);
   }
@@ -54,7 +62,8 @@ public:
     octagon \p ph is strictly smaller than \p *this.
   */
 #endif // defined(PPL_DOXYGEN_INCLUDE_IMPLEMENTATION_DETAILS)
-  bool is_stabilizing(const Parma_Polyhedra_Library::Octagonal_Shape<mpz_class>& ph) const {
+  template <typename SHAPE>
+  bool is_stabilizing(const SHAPE& ph) const {
     return compare(ph) == 1;
   }
 
@@ -80,6 +89,17 @@ public:
   bool OK() const;
 
 private:
+  //! Cardinality of a non-redundant constraint system for \p ph, which is assumed not to be empty.
+  template <typename SHAPE>
+  static Parma_Polyhedra_Library::dimension_type NumConstraints(const SHAPE& ph) {
+    Parma_Polyhedra_Library::dimension_type num_constraints = 0;
+    Parma_Polyhedra_Library::Constraint_System cs = ph.minimized_constraints();
+    for(Parma_Polyhedra_Library::Constraint_System::const_iterator it = cs.begin(); it != cs.end(); it++) {
+      num_constraints++;
+    }
+    return num_constraints;
+  }
+
   //! Affine dimension of the polyhedron.
   Parma_Polyhedra_Library::dimension_type affine_dim;
   //! Cardinality of a non-redundant constraint system for the polyhedron.
@@ -88,6 +108,295 @@ private:
 
 namespace abstract_domain
 {
+  // Rounds q up (resp. down) to an integer, the dimensions of the abstract values are integral
+  static mpz_class Ceil(const mpq_class& q) {
+    mpz_class r;
+    mpz_cdiv_q(r.get_mpz_t(), q.get_num_mpz_t(), q.get_den_mpz_t());
+    return r;
+  }
+
+  static mpz_class Floor(const mpq_class& q) {
+    mpz_class r;
+    mpz_fdiv_q(r.get_mpz_t(), q.get_num_mpz_t(), q.get_den_mpz_t());
+    return r;
+  }
+
+  // Adds to derived_cs the octagonal constraints implied by e >= 0 and the bounds of box. For a term a_j*x_j
+  // of e, a_j*x_j >= -b - sum_{i != j} max(a_i*x_i) bounds x_j. For two terms with |a_j| = |a_k| = c, the
+  // same gives a bound on the octagonal sum s_j*x_j + s_k*x_k.
+  static void PropagateInequality(const Parma_Polyhedra_Library::Linear_Expression& e,
+                                  const Parma_Polyhedra_Library::Box<Parma_Polyhedra_Library::Rational_Interval>& box,
+                                  Parma_Polyhedra_Library::Constraint_System& derived_cs) {
+    typedef Parma_Polyhedra_Library::Rational_Interval ITV;
+    typedef Parma_Polyhedra_Library::dimension_type ppl_dimension_type;
+
+    // Maximum of each term a_i*x_i, and the sum of the finite ones
+    std::vector<ppl_dimension_type> dims;
+    std::vector<mpz_class> coeffs;
+    std::vector<mpq_class> term_max;
+    std::vector<bool> term_max_inf;
+    unsigned num_inf = 0;
+    mpq_class sum_max = 0;
+    for(ppl_dimension_type i = 0; i < e.space_dimension(); i++) {
+      Parma_Polyhedra_Library::Variable v_i(i);
+      mpz_class a = e.coefficient(v_i);
+      if(a == 0)
+        continue;
+      ITV itv = box.get_interval(v_i);
+      bool is_inf = (a > 0) ? itv.upper_is_boundary_infinity() : itv.lower_is_boundary_infinity();
+      mpq_class m;
+      if(!is_inf) {
+        m = (a > 0) ? mpq_class(a * itv.upper()) : mpq_class(a * itv.lower());
+        sum_max += m;
+      } else {
+        num_inf++;
+      }
+      dims.push_back(i);
+      coeffs.push_back(a);
+      term_max.push_back(m);
+      term_max_inf.push_back(is_inf);
+    }
+    // Nothing can be derived when more than two terms are unbounded
+    if(num_inf > 2)
+      return;
+
+    mpq_class b = mpz_class(e.inhomogeneous_term());
+    for(unsigned j = 0; j < dims.size(); j++) {
+      Parma_Polyhedra_Library::Linear_Expression x_j = Parma_Polyhedra_Library::Variable(dims[j]);
+
+      // Bound on x_j, when the terms other than a_j*x_j are bounded
+      if(num_inf == 0 || (num_inf == 1 && term_max_inf[j])) {
+        mpq_class r = -b - sum_max + (term_max_inf[j] ? mpq_class(0) : term_max[j]);
+        mpq_class q = r / coeffs[j];
+        if(coeffs[j] > 0) {
+          derived_cs.insert(x_j >= Ceil(q));
+        } else {
+          derived_cs.insert(x_j <= Floor(q));
+        }
+      }
+
+      // Bound on s_j*x_j + s_k*x_k, when the terms other than a_j*x_j and a_k*x_k are bounded
+      for(unsigned k = j + 1; k < dims.size(); k++) {
+        if(abs(coeffs[j]) != abs(coeffs[k]))
+          continue;
+        unsigned num_inf_jk = (term_max_inf[j] ? 1 : 0) + (term_max_inf[k] ? 1 : 0);
+        if(num_inf != num_inf_jk)
+          continue;
+        mpq_class r = -b - sum_max + (term_max_inf[j] ? mpq_class(0) : term_max[j]) + (term_max_inf[k] ? mpq_class(0) : term_max[k]);
+        mpz_class c = abs(coeffs[j]);
+        Parma_Polyhedra_Library::Linear_Expression x_k = Parma_Polyhedra_Library::Variable(dims[k]);
+        Parma_Polyhedra_Library::Linear_Expression s_jk = (coeffs[j] > 0 ? x_j : -x_j) + (coeffs[k] > 0 ? x_k : -x_k);
+        derived_cs.insert(s_jk >= Ceil(mpq_class(r / c)));
+      }
+    }
+  }
+
+  // Refines shape with the constraints of non_shape_cs, which it cannot represent. Each round reads the bounds of
+  // the variables from shape, and adds the octagonal constraints that they imply with non_shape_cs. A BD_Shape
+  // drops the octagonal sums among them. The rounds stop after max_rounds, or when shape does not change.
+  template <typename SHAPE>
+  static void PropagateConstraints(SHAPE& shape,
+                                   const Parma_Polyhedra_Library::Constraint_System& non_shape_cs,
+                                   unsigned max_rounds) {
+    typedef Parma_Polyhedra_Library::Box<Parma_Polyhedra_Library::Rational_Interval> TBox;
+
+    for(unsigned round = 0; round < max_rounds; round++) {
+      if(shape.is_empty())
+        return;
+
+      TBox box(shape);
+      Parma_Polyhedra_Library::Constraint_System derived_cs;
+      for(Parma_Polyhedra_Library::Constraint_System::const_iterator it = non_shape_cs.begin(); it != non_shape_cs.end(); it++) {
+        Parma_Polyhedra_Library::Linear_Expression e(*it);
+        PropagateInequality(e, box, derived_cs);
+        // An equality e = 0 is also -e >= 0
+        if(it->is_equality()) {
+          PropagateInequality(-e, box, derived_cs);
+        }
+      }
+
+      SHAPE shape_before(shape);
+      shape.refine_with_constraints(derived_cs);
+      if(shape == shape_before)
+        return;
+    }
+  }
+
+  // Is c of the form +/-x_i +/- x_j op b, or +/-x_i op b?
+  static bool IsOctagonalConstraint(const Parma_Polyhedra_Library::Constraint& c) {
+    unsigned num_non_zero_coeffs = 0;
+    for(Parma_Polyhedra_Library::dimension_type i = c.space_dimension(); i-- > 0; ) {
+      Parma_Polyhedra_Library::Variable v_i(i);
+      const Parma_Polyhedra_Library::GMP_Integer coeff = c.coefficient(v_i);
+      if(coeff != 0 && coeff != 1 && coeff != -1)
+        return false;
+      if(coeff != 0)
+        num_non_zero_coeffs++;
+    }
+    return (num_non_zero_coeffs <= 2);
+  }
+
+  // Is c of the form x_i - x_j op b, or +/-x_i op b?
+  static bool IsBoundedDifferenceConstraint(const Parma_Polyhedra_Library::Constraint& c) {
+    unsigned num_non_zero_coeffs = 0;
+    Parma_Polyhedra_Library::GMP_Integer coeff_sum = 0;
+    for(Parma_Polyhedra_Library::dimension_type i = c.space_dimension(); i-- > 0; ) {
+      Parma_Polyhedra_Library::Variable v_i(i);
+      const Parma_Polyhedra_Library::GMP_Integer coeff = c.coefficient(v_i);
+      if(coeff != 0 && coeff != 1 && coeff != -1)
+        return false;
+      if(coeff != 0) {
+        num_non_zero_coeffs++;
+        coeff_sum += coeff;
+      }
+    }
+    return (num_non_zero_coeffs <= 1 || (num_non_zero_coeffs == 2 && coeff_sum == 0));
+  }
+
+  // Adds cs to each disjunct of pp. The constraints for which is_shape_constraint does not hold cannot be
+  // represented by SHAPE, converting each disjunct to a polyhedron to add them is too costly. They are instead
+  // bound-propagated onto the disjuncts for propagation_rounds rounds.
+  template <typename SHAPE>
+  static void AddShapeConstraints(Parma_Polyhedra_Library::Pointset_Powerset<SHAPE>& pp,
+                                  const Parma_Polyhedra_Library::Constraint_System& cs,
+                                  bool (*is_shape_constraint)(const Parma_Polyhedra_Library::Constraint&),
+                                  unsigned propagation_rounds) {
+    Parma_Polyhedra_Library::Constraint_System shape_cs;
+    Parma_Polyhedra_Library::dimension_type non_shape_cs_size = 0;
+    Parma_Polyhedra_Library::Constraint_System non_shape_cs;
+    for(Parma_Polyhedra_Library::Constraint_System::const_iterator it = cs.begin(); it != cs.end(); it++) {
+      if(is_shape_constraint(*it)) {
+        shape_cs.insert(*it);
+      } else {
+        non_shape_cs.insert(*it);
+        non_shape_cs_size++;
+      }
+    }
+
+    pp.add_constraints(shape_cs);
+
+    if(non_shape_cs_size != 0 && propagation_rounds != 0) {
+      Parma_Polyhedra_Library::Pointset_Powerset<SHAPE> pp_prop(pp.space_dimension(), Parma_Polyhedra_Library::EMPTY);
+      for(typename Parma_Polyhedra_Library::Pointset_Powerset<SHAPE>::const_iterator it = pp.begin(); it != pp.end(); it++) {
+        SHAPE shape(it->pointset());
+        PropagateConstraints(shape, non_shape_cs, propagation_rounds);
+        if(!shape.is_empty())
+          pp_prop.add_disjunct(shape);
+      }
+      pp = pp_prop;
+    }
+  }
+
+  // Widens pp with that_pp, which must definitely entail pp
+  template <typename SHAPE>
+  static void WidenShapes(Parma_Polyhedra_Library::Pointset_Powerset<SHAPE>& pp,
+                          const Parma_Polyhedra_Library::Pointset_Powerset<SHAPE>& that_pp,
+                          unsigned use_extrapolation, unsigned max_disjunctions) {
+    typedef Octagonal_Shape_Certificate T1;
+    typename Parma_Polyhedra_Library::Widening_Function<SHAPE> 
+      widen_fun = Parma_Polyhedra_Library::widen_fun_ref(&SHAPE::widening_assign);
+
+    if(use_extrapolation) {
+      unsigned max_disjunctions_local = max_disjunctions;
+      pp.BGP99_extrapolation_assign(that_pp, widen_fun, max_disjunctions_local);
+    } else {
+      pp.template BHZ03_widening_assign<T1>(that_pp, widen_fun);
+    }
+  }
+
+  template <typename SHAPE>
+  static void ReduceShape(PointsetPowersetAv<SHAPE>& av, const ref_ptr<AbstractValue>& that) {
+    utils::Timer reduce_timer("Reduce:", std::cout, false);
+    DEBUG_PRINTING(DBG_PRINT_DETAILS, std::cout << "\nIn reduce:";);
+    ref_ptr<abstract_domain::PointsetPowersetAv<Parma_Polyhedra_Library::C_Polyhedron> > eqav = 
+      dynamic_cast<abstract_domain::PointsetPowersetAv<Parma_Polyhedra_Library::C_Polyhedron> *>(that.get_ptr());
+    if(eqav != NULL && eqav->equalities_only()) {
+      assert(eqav->num_disjuncts() == 1u);
+      const Parma_Polyhedra_Library::C_Polyhedron eqs = eqav->GetDisjunct(0);
+      DEBUG_PRINTING(DBG_PRINT_DETAILS, 
+                     eqav->print(std::cout << "\neqav:");
+                     av.print(std::cout << "\nthis before addEqualities:"););
+      av.AddConstraints(eqs.constraints());
+      DEBUG_PRINTING(DBG_PRINT_DETAILS, 
+                     av.print(std::cout << "\nthis after addEqualities:"););
+    }
+    else if(eqav == NULL) {
+      // Any other domain that keeps equalities, such as AffineEqualityAv
+      std::vector<AbstractValue::constraint_type> eqs;
+      if(that->GetEqualities(eqs)) {
+        DEBUG_PRINTING(DBG_PRINT_DETAILS, 
+                       that->print(std::cout << "\neqav:");
+                       av.print(std::cout << "\nthis before addEqualities:"););
+        av.AddConstraints(eqs);
+        DEBUG_PRINTING(DBG_PRINT_DETAILS, 
+                       av.print(std::cout << "\nthis after addEqualities:"););
+      }
+    }
+    DEBUG_PRINTING(DBG_PRINT_OVERVIEW, std::cout << "\nReduce:" << reduce_timer.elapsed(););
+  }
+
+  // Only the equalities of that which are connected to dirty, directly or through other equalities, can differ
+  // from the ones added by the last reduction. The dimensions whose bounds got tighter are reported as changed.
+  template <typename SHAPE>
+  static void ReduceShapeDimensions(PointsetPowersetAv<SHAPE>& av, const ref_ptr<AbstractValue>& that,
+                                    const Vocabulary& dirty, Vocabulary& changed) {
+    typedef AbstractValue::constraint_type constraint_type;
+    typedef AbstractValue::linexp_type linexp_type;
+    typedef AbstractValue::interval_map_type interval_map_type;
+
+    utils::Timer reduce_timer("ReduceDimensions:", std::cout, false);
+    std::vector<constraint_type> eqs;
+    if(!that->GetEqualities(eqs))
+      return;
+
+    // Collect the equalities connected to dirty, the ones without dimensions are always unsatisfiable
+    Vocabulary conn_voc = dirty;
+    std::vector<bool> is_conn(eqs.size(), false);
+    bool reached_fixpoint = false;
+    while(!reached_fixpoint) {
+      reached_fixpoint = true;
+      for(unsigned i = 0; i < eqs.size(); i++) {
+        if(is_conn[i])
+          continue;
+        const linexp_type& le = eqs[i].first.first.first;
+        bool conn = le.empty();
+        for(linexp_type::const_iterator it = le.begin(); it != le.end() && !conn; it++) {
+          conn = (conn_voc.find(it->first) != conn_voc.end());
+        }
+        if(!conn)
+          continue;
+        is_conn[i] = true;
+        reached_fixpoint = false;
+        for(linexp_type::const_iterator it = le.begin(); it != le.end(); it++) {
+          conn_voc.insert(it->first);
+        }
+      }
+    }
+
+    std::vector<constraint_type> conn_eqs;
+    for(unsigned i = 0; i < eqs.size(); i++) {
+      if(is_conn[i])
+        conn_eqs.push_back(eqs[i]);
+    }
+    if(conn_eqs.empty())
+      return;
+
+    // Nothing more is reported once this is bottom
+    interval_map_type im_before, im_after;
+    bool was_bottom = !av.GetIntervals(im_before);
+    av.AddConstraints(conn_eqs);
+    if(was_bottom || !av.GetIntervals(im_after))
+      return;
+    for(interval_map_type::const_iterator it = im_after.begin(); it != im_after.end(); it++) {
+      const DimensionInterval& before = im_before[it->first];
+      const DimensionInterval& after = it->second;
+      if((after.has_lb && (!before.has_lb || after.lb > before.lb)) || (after.has_ub && (!before.has_ub || after.ub < before.ub)))
+        changed.insert(it->first);
+    }
+    DEBUG_PRINTING(DBG_PRINT_OVERVIEW, std::cout << "\nReduceDimensions:" << reduce_timer.elapsed()
+                   << ", num eqs:" << conn_eqs.size() << "/" << eqs.size(););
+  }
+
   // Widen specialization for C_Polyhedron
   // that_av must definitely entail *this
   template <>
@@ -108,90 +417,104 @@ namespace abstract_domain
     MergeHeuristic();
   }
 
-  // Widen specialization for Octagons
-  // Convert Octogons to Polyhedron, call that widen operation and then convert back
+  // Specializations for Octagons
   template <>
   void PointsetPowersetAv<Parma_Polyhedra_Library::Octagonal_Shape<mpz_class> >::WidenHomogeneous (const ref_ptr<AbstractValue> & that_av) {
-    typedef Octagonal_Shape_Certificate T1;
     const PointsetPowersetAv* that = static_cast<const PointsetPowersetAv *>(that_av.get_ptr());
-    typename Parma_Polyhedra_Library::Widening_Function<Parma_Polyhedra_Library::Octagonal_Shape<mpz_class> > 
-      widen_fun = Parma_Polyhedra_Library::widen_fun_ref(&Parma_Polyhedra_Library::Octagonal_Shape<mpz_class>::widening_assign);
-
-    if(use_extrapolation) {
-      unsigned max_disjunctions_local = max_disjunctions;
-      pp_.BGP99_extrapolation_assign(that->pp_, widen_fun, max_disjunctions_local);
-    } else {
-      pp_.BHZ03_widening_assign<T1>(that->pp_, widen_fun);
-    }
+    WidenShapes(pp_, that->pp_, use_extrapolation, max_disjunctions);
 
     // Merge so that the size of pp_ does not exceed max_disjunctions
     MergeHeuristic();
   }
 
-  // Add constraint specialization for octagons
   template <>
   void PointsetPowersetAv<Parma_Polyhedra_Library::Octagonal_Shape<mpz_class> >::AddConstraints(const Parma_Polyhedra_Library::Constraint_System & cs) {
-    typedef Parma_Polyhedra_Library::C_Polyhedron POLY_T;
-    typedef Parma_Polyhedra_Library::Octagonal_Shape<mpz_class> OCT_T;
+    AddShapeConstraints(pp_, cs, IsOctagonalConstraint, propagation_rounds);
+  }
 
-    Parma_Polyhedra_Library::Constraint_System oct_cs;
-    ppl_dimension_type non_oct_cs_size = 0;
-    Parma_Polyhedra_Library::Constraint_System non_oct_cs;
-    for(Parma_Polyhedra_Library::Constraint_System::const_iterator it = cs.begin(); it != cs.end(); it++) {
-      bool is_octogonal_constraint = true;
-      unsigned num_non_zero_coeffs = 0;
-      for(ppl_dimension_type i = it->space_dimension(); i-- > 0; ) {
-        Parma_Polyhedra_Library::Variable v_i(i);
-        const Parma_Polyhedra_Library::GMP_Integer coeff = it->coefficient(v_i);
-        if(coeff != 0 && coeff != 1 && coeff != -1) {
-          is_octogonal_constraint = false;
-          break;
-        }
-        if(coeff != 0) {
-          num_non_zero_coeffs++;
-        }
-      }
-      if(num_non_zero_coeffs > 2)
-        is_octogonal_constraint = false;
+  template <>
+  void PointsetPowersetAv<Parma_Polyhedra_Library::Octagonal_Shape<mpz_class> >::AddConstraint(const Parma_Polyhedra_Library::Constraint & c) {
+    Parma_Polyhedra_Library::Constraint_System cs;
+    cs.insert(c);
+    AddConstraints(cs);
+  }
 
-      if(is_octogonal_constraint) {
-        oct_cs.insert(*it);
-      } else {
-        non_oct_cs.insert(*it);
-        non_oct_cs_size++;
-      }
-    }
+  template <>
+  void PointsetPowersetAv<Parma_Polyhedra_Library::Octagonal_Shape<mpz_class> >::Reduce(const ref_ptr<AbstractValue>& that) {
+    ReduceShape(*this, that);
+  }
 
-    pp_.add_constraints(oct_cs);
+  template <>
+  void PointsetPowersetAv<Parma_Polyhedra_Library::Octagonal_Shape<mpz_class> >::ReduceDimensions
+  (const ref_ptr<AbstractValue>& that, const Vocabulary& dirty, Vocabulary& changed) {
+    ReduceShapeDimensions(*this, that, dirty, changed);
+  }
 
-    // Performance optimization
-    if(false) {
-    if(non_oct_cs_size != 0) {
-      // Convert pp_ to a polyhedron representing an octagon
-      Parma_Polyhedra_Library::Pointset_Powerset<POLY_T> pp_poly(pp_.space_dimension(), Parma_Polyhedra_Library::EMPTY);
-      for(Parma_Polyhedra_Library::Pointset_Powerset<OCT_T>::const_iterator it = pp_.begin(); it != pp_.end(); it++) {
-        POLY_T poly_it(it->pointset());
-        poly_it.add_constraints(cs);
-        pp_poly.add_disjunct(poly_it);
-      }
+  // Specializations for Octagons with int64_t coefficients
+  template <>
+  void PointsetPowersetAv<Parma_Polyhedra_Library::Octagonal_Shape<int64_t> >::WidenHomogeneous (const ref_ptr<AbstractValue> & that_av) {
+    const PointsetPowersetAv* that = static_cast<const PointsetPowersetAv *>(that_av.get_ptr());
+    WidenShapes(pp_, that->pp_, use_extrapolation, max_disjunctions);
 
-      pp_.clear();
-      for(Parma_Polyhedra_Library::Pointset_Powerset<POLY_T>::const_iterator it = pp_poly.begin(); it != pp_poly.end(); it++) {
-        OCT_T p(it->pointset());
-        pp_.add_disjunct(p);
-      }
-    }
-    }
+    // Merge so that the size of pp_ does not exceed max_disjunctions
+    MergeHeuristic();
   }
 
-  // Add constraint specialization for octagons
   template <>
-  void PointsetPowersetAv<Parma_Polyhedra_Library::Octagonal_Shape<mpz_class> >::AddConstraint(const Parma_Polyhedra_Library::Constraint & c) {
+  void PointsetPowersetAv<Parma_Polyhedra_Library::Octagonal_Shape<int64_t> >::AddConstraints(const Parma_Polyhedra_Library::Constraint_System & cs) {
+    AddShapeConstraints(pp_, cs, IsOctagonalConstraint, propagation_rounds);
+  }
+
+  template <>
+  void PointsetPowersetAv<Parma_Polyhedra_Library::Octagonal_Shape<int64_t> >::AddConstraint(const Parma_Polyhedra_Library::Constraint & c) {
     Parma_Polyhedra_Library::Constraint_System cs;
     cs.insert(c);
     AddConstraints(cs);
   }
 
+  template <>
+  void PointsetPowersetAv<Parma_Polyhedra_Library::Octagonal_Shape<int64_t> >::Reduce(const ref_ptr<AbstractValue>& that) {
+    ReduceShape(*this, that);
+  }
+
+  template <>
+  void PointsetPowersetAv<Parma_Polyhedra_Library::Octagonal_Shape<int64_t> >::ReduceDimensions
+  (const ref_ptr<AbstractValue>& that, const Vocabulary& dirty, Vocabulary& changed) {
+    ReduceShapeDimensions(*this, that, dirty, changed);
+  }
+
+  // Specializations for BD shapes with int64_t coefficients
+  template <>
+  void PointsetPowersetAv<Parma_Polyhedra_Library::BD_Shape<int64_t> >::WidenHomogeneous (const ref_ptr<AbstractValue> & that_av) {
+    const PointsetPowersetAv* that = static_cast<const PointsetPowersetAv *>(that_av.get_ptr());
+    WidenShapes(pp_, that->pp_, use_extrapolation, max_disjunctions);
+
+    // Merge so that the size of pp_ does not exceed max_disjunctions
+    MergeHeuristic();
+  }
+
+  template <>
+  void PointsetPowersetAv<Parma_Polyhedra_Library::BD_Shape<int64_t> >::AddConstraints(const Parma_Polyhedra_Library::Constraint_System & cs) {
+    AddShapeConstraints(pp_, cs, IsBoundedDifferenceConstraint, propagation_rounds);
+  }
+
+  template <>
+  void PointsetPowersetAv<Parma_Polyhedra_Library::BD_Shape<int64_t> >::AddConstraint(const Parma_Polyhedra_Library::Constraint & c) {
+    Parma_Polyhedra_Library::Constraint_System cs;
+    cs.insert(c);
+    AddConstraints(cs);
+  }
+
+  template <>
+  void PointsetPowersetAv<Parma_Polyhedra_Library::BD_Shape<int64_t> >::Reduce(const ref_ptr<AbstractValue>& that) {
+    ReduceShape(*this, that);
+  }
+
+  template <>
+  void PointsetPowersetAv<Parma_Polyhedra_Library::BD_Shape<int64_t> >::ReduceDimensions
+  (const ref_ptr<AbstractValue>& that, const Vocabulary& dirty, Vocabulary& changed) {
+    ReduceShapeDimensions(*this, that, dirty, changed);
+  }
 
   template <>
   std::ostream& PointsetPowersetAv<Parma_Polyhedra_Library::Octagonal_Shape<mpz_class> >::PrintPSET(std::ostream& o, const Parma_Polyhedra_Library::Octagonal_Shape<mpz_class>& p) const {
@@ -203,25 +526,4 @@ namespace abstract_domain
     Parma_Polyhedra_Library::IO_Operators::operator<<(o, cs);
     return o;
   }
-
-  template <>
-  void PointsetPowersetAv<Parma_Polyhedra_Library::Octagonal_Shape<mpz_class> >::Reduce
-  (const ref_ptr<AbstractValue>& that) {
-    utils::Timer reduce_timer("Reduce:", std::cout, false);
-    DEBUG_PRINTING(DBG_PRINT_DETAILS, std::cout << "\nIn reduce:";);
-    ref_ptr<abstract_domain::PointsetPowersetAv<Parma_Polyhedra_Library::C_Polyhedron> > eqav = 
-      static_cast<abstract_domain::PointsetPowersetAv<Parma_Polyhedra_Library::C_Polyhedron> *>(that.get_ptr());
-    if(eqav != NULL && eqav->equalities_only()) {
-      assert(eqav->num_disjuncts() == 1u);
-      const Parma_Polyhedra_Library::C_Polyhedron eqs = eqav->GetDisjunct(0);
-      DEBUG_PRINTING(DBG_PRINT_DETAILS, 
-                     eqav->print(std::cout << "\neqav:");
-                     print(std::cout << "\nthis before addEqualities:"););
-      AddConstraints(eqs.constraints());
-      DEBUG_PRINTING(DBG_PRINT_DETAILS, 
-                     print(std::cout << "\nthis after addEqualities:"););
-    }
-    DEBUG_PRINTING(DBG_PRINT_OVERVIEW, std::cout << "\nReduce:" << reduce_timer.elapsed(););
-  }
-
 }
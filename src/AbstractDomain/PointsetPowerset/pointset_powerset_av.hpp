@@ -3,6 +3,7 @@
 
 #include <algorithm>
 #include <sstream>
+#include <stdint.h>
 
 #include "src/AbstractDomain/common/AbstractValue.hpp"
 #include "ppl.hh"
@@ -25,6 +26,8 @@ namespace abstract_domain
      <CODE>Box\<T\></CODE>.
 
      Note that of these domains, only C_Polyhedron and Octogonal_Shape have been tested.
+     Octagonal_Shape<int64_t> and BD_Shape<int64_t> use machine coefficients. PPL rounds a bound
+     that overflows them up to +infinity, which is sound but loses the bound.
   */
   template <typename PSET>
   class PointsetPowersetAv : public AbstractValue {
@@ -33,10 +36,21 @@ namespace abstract_domain
     typedef boost::bimap<DimensionKey, ppl_dimension_type> bm_type;
     typedef std::map<DimensionKey, bool> VocabularySignedness;
     typedef std::pair<std::map<DimensionKey, mpz_class>, mpz_class> equality_type;
+    // The integral bounds of a disjunct, indexed by the ppl dimensions
+    typedef std::vector<DimensionInterval> disjunct_box_type;
 
     // Parameter to control the maximum number of disjunctions
     static unsigned max_disjunctions;
     static unsigned use_extrapolation;
+    // Parameter to control the number of rounds of bound propagation of the constraints that the PSET
+    // cannot represent, such as the non-octagonal constraints for octagons. 0 drops these constraints.
+    static unsigned propagation_rounds;
+    // Parameter to control whether meet, Overapproximates and equality first compare the bounding boxes of the
+    // disjuncts, and skip the pairs of disjuncts that are disjoint, or that cannot contain or be equal to each other
+    static bool box_filter;
+    // Parameter to control the hard limit on the number of disjuncts that Join appends without merging them. Below
+    // it, the merge is deferred until the value is compared, widened or met. 0 merges after each Join.
+    static unsigned lazy_merge_limit;
 
     // Constructors
     // ============
@@ -72,6 +86,8 @@ namespace abstract_domain
     void Widen(const ref_ptr<AbstractValue>&);
     void Wrap(const VocabularySignedness& voc_to_wrap);
     bool IsConstant(mpz_class& val) const;
+    bool GetIntervals(interval_map_type& im) const;
+    bool GetEqualities(std::vector<constraint_type>& eqs) const;
     Vocabulary GetDependentVocabulary(DimensionKey& k) const;
 
     void AddEquality(const DimensionKey& v1, 
@@ -85,13 +101,17 @@ namespace abstract_domain
     // PSET Operations
     void AddConstraint(affexp_type lhs, affexp_type rhs, OpType op);
     void AddConstraint(const Parma_Polyhedra_Library::Constraint & c);
+    void AddConstraints(const std::vector<constraint_type>& cs);
+    void AssignAffine(const DimensionKey& k, const affexp_type& e);
     void AddConstraints(const Parma_Polyhedra_Library::Constraint_System& cs);
-    unsigned num_disjuncts() const { return pp_.size(); }
+    unsigned num_disjuncts() const { MergePending(); return pp_.size(); }
     //In - place reduction
     void Reduce();
     void Reduce(const ref_ptr<AbstractValue>& that);
+    void ReduceDimensions(const ref_ptr<AbstractValue>& that, const Vocabulary& dirty, Vocabulary& changed);
 
     const PSET& GetDisjunct(unsigned i) const {
+      MergePending();
       typename Parma_Polyhedra_Library::Pointset_Powerset<PSET>::const_iterator it = pp_.begin();
       std::advance(it, i);
       return it->pointset();
@@ -113,6 +133,14 @@ namespace abstract_domain
     // Input/output
     std::string ToString() const;
     std::ostream & PrintVocabularyIndexMap(std::ostream & o) const;
+    void Serialize(std::ostream & out) const;
+    ref_ptr<AbstractValue> Deserialize(std::istream & in) const;
+    size_t Hash() const;
+    bool StructurallyEqual(const AbstractValue& that) const;
+
+    // Budget support
+    size_t NumConstraints() const;
+    void Coarsen(unsigned max_disjuncts, bool use_octagons);
 
     bool equalities_only() const { return equalities_only_;}
   private:
@@ -121,10 +149,33 @@ namespace abstract_domain
 
     // Calling this function ensures that the number of disjunctions
     // in the powerset don't go beyond max_disjunctions
-    void MergeHeuristic();
+    void MergeHeuristic() const;
+    void MergeHeuristic(unsigned max_disjuncts) const;
+    // Perform the merge deferred by Join, if any
+    void MergePending() const;
 
     void raw_join(const ref_ptr<PointsetPowersetAv>&);
 
+    // Same as meet_assign, contains and == on pp_, with the pairs of disjuncts filtered by their boxes
+    void MeetWithBoxFilter(const Parma_Polyhedra_Library::Pointset_Powerset<PSET>& that);
+    bool ContainsWithBoxFilter(const Parma_Polyhedra_Library::Pointset_Powerset<PSET>& that) const;
+    bool EqualsWithBoxFilter(const Parma_Polyhedra_Library::Pointset_Powerset<PSET>& that) const;
+
+    // Get the box of d, returns false if d has no integral point
+    static bool GetDisjunctBox(const PSET& d, disjunct_box_type& box);
+    static void GetDisjunctBoxes(const Parma_Polyhedra_Library::Pointset_Powerset<PSET>& pp,
+                                 std::vector<disjunct_box_type>& boxes, std::vector<bool>& has_box);
+    static bool AreDisjoint(const disjunct_box_type& b1, const disjunct_box_type& b2);
+    // Does b1 contain b2?
+    static bool Contains(const disjunct_box_type& b1, const disjunct_box_type& b2);
+
+    // Lexicographic order on the boxes, to index the disjuncts by their boxes
+    struct BoxLess {
+      bool operator()(const disjunct_box_type& b1, const disjunct_box_type& b2) const;
+    };
+
+    bool GetPplConstraint(const affexp_type& lhs, const affexp_type& rhs, OpType op, Parma_Polyhedra_Library::Constraint& c) const;
+
     ppl_dimension_type GetPplDimensionTypeFromDimensionKey(const DimensionKey&) const;
     static ppl_dimension_type GetPplDimensionTypeFromDimensionKey(const bm_type&, const DimensionKey&, bool& found);
     DimensionKey GetDimensionKeyAtPplDimensionType(const ppl_dimension_type&) const;
@@ -138,9 +189,13 @@ namespace abstract_domain
     std::ostream& PrintPSET(std::ostream& o, const PSET& p) const;
 
     // Data members
-    Parma_Polyhedra_Library::Pointset_Powerset<PSET> pp_;
+    // pp_ is mutable for the merge deferred by Join, which the const members complete (see MergePending)
+    mutable Parma_Polyhedra_Library::Pointset_Powerset<PSET> pp_;
     bm_type key_index_bimap_;
     bool equalities_only_; // Flag that specifies the domain to only add equalities
+    // Set when Join has deferred the merge of pp_, see lazy_merge_limit. The merge only overapproximates
+    // pp_ as the eager merge would, hence the const comparisons perform it as well.
+    mutable bool merge_pending_;
   };
     
 } // abstract_value
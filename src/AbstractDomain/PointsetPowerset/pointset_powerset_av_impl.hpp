@@ -7,6 +7,7 @@
 #include <algorithm>
 #include <sstream>
 #include <memory>
+#include <map>
 
 // By default, max_disjunctions is 1, hence this class behaves like normal polyhedron
 template <typename PSET>
@@ -16,19 +17,31 @@ unsigned abstract_domain::PointsetPowersetAv<PSET>::max_disjunctions = 1;
 template <typename PSET>
 unsigned abstract_domain::PointsetPowersetAv<PSET>::use_extrapolation = false;
 
+// By default, the constraints that the domain cannot represent are not propagated
+template <typename PSET>
+unsigned abstract_domain::PointsetPowersetAv<PSET>::propagation_rounds = 0;
+
+// By default, the disjuncts are not filtered by their boxes
+template <typename PSET>
+bool abstract_domain::PointsetPowersetAv<PSET>::box_filter = false;
+
+// By default, each join merges the disjuncts
+template <typename PSET>
+unsigned abstract_domain::PointsetPowersetAv<PSET>::lazy_merge_limit = 0;
+
 namespace abstract_domain
 {
   // Constructors
   // ============
   template <typename PSET>
   PointsetPowersetAv<PSET>::PointsetPowersetAv(const Vocabulary& voc, bool is_universe, bool equalities_only)
-    : AbstractValue(voc), pp_(voc.size(), (is_universe? Parma_Polyhedra_Library::UNIVERSE : Parma_Polyhedra_Library::EMPTY)), equalities_only_(equalities_only) {
+    : AbstractValue(voc), pp_(voc.size(), (is_universe? Parma_Polyhedra_Library::UNIVERSE : Parma_Polyhedra_Library::EMPTY)), equalities_only_(equalities_only), merge_pending_(false) {
     key_index_bimap_ = GetVocabularyIndexMap(voc);
   }
 
   template <typename PSET>
   PointsetPowersetAv<PSET>::PointsetPowersetAv(const PointsetPowersetAv& orig)
-    : AbstractValue(orig.voc_), pp_(orig.pp_), key_index_bimap_(orig.key_index_bimap_), equalities_only_(orig.equalities_only_) {
+    : AbstractValue(orig.voc_), pp_(orig.pp_), key_index_bimap_(orig.key_index_bimap_), equalities_only_(orig.equalities_only_), merge_pending_(orig.merge_pending_) {
   } 
 
   template <typename PSET>
@@ -44,6 +57,7 @@ namespace abstract_domain
     this->pp_ = a.pp_;
     this->key_index_bimap_ = a.key_index_bimap_;
     this->equalities_only_ = this->equalities_only_;
+    this->merge_pending_ = a.merge_pending_;
     return *this; 
   }
 
@@ -79,6 +93,10 @@ namespace abstract_domain
   // Heterogeneous equality
   template <typename PSET>
   inline bool PointsetPowersetAv<PSET>::operator== (const PointsetPowersetAv&that) const {
+    MergePending();
+    that.MergePending();
+    if(box_filter && (pp_.size() > 1 || that.pp_.size() > 1))
+      return EqualsWithBoxFilter(that.pp_);
     return (pp_ == that.pp_);
   }
 
@@ -86,6 +104,10 @@ namespace abstract_domain
   inline bool PointsetPowersetAv<PSET>::Overapproximates(const ref_ptr<AbstractValue>& that) const {
     const ref_ptr<PointsetPowersetAv> that_pp = static_cast<PointsetPowersetAv *>(that.get_ptr());
     assert(equalities_only_ == that_pp->equalities_only_);
+    MergePending();
+    that_pp->MergePending();
+    if(box_filter && (pp_.size() > 1 || that_pp->pp_.size() > 1))
+      return ContainsWithBoxFilter(that_pp->pp_);
     return pp_.contains(that_pp->pp_);
   }
 
@@ -128,8 +150,12 @@ namespace abstract_domain
       pp_.upper_bound_assign(that_pp->pp_);
     }
 
-    // Merge so that the size of pp_ does not exceed max_disjunctions
-    MergeHeuristic();
+    // Merge so that the size of pp_ does not exceed max_disjunctions. In the lazy mode, the merge is deferred
+    // while the size of pp_ does not exceed the hard limit.
+    if(lazy_merge_limit != 0 && pp_.size() <= std::max(lazy_merge_limit, max_disjunctions))
+      merge_pending_ = true;
+    else
+      MergeHeuristic();
     DEBUG_PRINTING(DBG_PRINT_OVERVIEW, std::cout << "\nPointsetPowersetAv raw_join time:" << timer.elapsed() 
                    << ", voc_size:" << this->voc_.size(););
   }
@@ -139,6 +165,8 @@ namespace abstract_domain
     utils::Timer timer("PointsetPowersetAv meet", std::cout, false);
     ref_ptr<PointsetPowersetAv> that_pp = static_cast<PointsetPowersetAv *>(that.get_ptr());
     assert(equalities_only_ == that_pp->equalities_only_);
+    MergePending();
+    that_pp->MergePending();
 
     AddVocabulary(that->GetVocabulary());
 
@@ -158,7 +186,10 @@ namespace abstract_domain
                    print(std::cout << "\nIn pointsetpowersetav meet, this:");
                    that->print(std::cout << "\nthat:"););
 
-    pp_.meet_assign(that_pp->pp_);
+    if(box_filter && (pp_.size() > 1 || that_pp->pp_.size() > 1))
+      MeetWithBoxFilter(that_pp->pp_);
+    else
+      pp_.meet_assign(that_pp->pp_);
 
     DEBUG_PRINTING(DBG_PRINT_MORE_DETAILS, print(std::cout << "\nResult meet:"););
 
@@ -170,6 +201,8 @@ namespace abstract_domain
 
   template <typename PSET>
   void PointsetPowersetAv<PSET>::Widen (const ref_ptr<AbstractValue> & that_av) {
+    MergePending();
+    static_cast<const PointsetPowersetAv *>(that_av.get_ptr())->MergePending();
     AddVocabulary(that_av->GetVocabulary());
 
     if(GetVocabulary() == that_av->GetVocabulary()) {
@@ -200,6 +233,10 @@ namespace abstract_domain
   void PointsetPowersetAv<Parma_Polyhedra_Library::C_Polyhedron>::WidenHomogeneous (const ref_ptr<AbstractValue> & that_av);
   template <>
   void PointsetPowersetAv<Parma_Polyhedra_Library::Octagonal_Shape<mpz_class> >::WidenHomogeneous (const ref_ptr<AbstractValue> & that_av);
+  template <>
+  void PointsetPowersetAv<Parma_Polyhedra_Library::Octagonal_Shape<int64_t> >::WidenHomogeneous (const ref_ptr<AbstractValue> & that_av);
+  template <>
+  void PointsetPowersetAv<Parma_Polyhedra_Library::BD_Shape<int64_t> >::WidenHomogeneous (const ref_ptr<AbstractValue> & that_av);
 
   template <typename PSET>
   void PointsetPowersetAv<PSET>::Wrap(const VocabularySignedness& vs) {
@@ -329,6 +366,237 @@ namespace abstract_domain
     return false;
   }
 
+  // As the dimensions are integral, the rational bounds of the box of d are rounded inwards.
+  template <typename PSET>
+  bool PointsetPowersetAv<PSET>::GetDisjunctBox(const PSET& d, disjunct_box_type& dbox) {
+    typedef Parma_Polyhedra_Library::Rational_Interval ITV;
+    typedef Parma_Polyhedra_Library::Box<ITV> TBox;
+
+    TBox box(d);
+    if(box.is_empty())
+      return false;
+
+    dbox.resize(d.space_dimension());
+    for(ppl_dimension_type i = 0; i < d.space_dimension(); i++) {
+      ITV itv = box.get_interval(Parma_Polyhedra_Library::Variable(i));
+      DimensionInterval& ditv = dbox[i];
+      if(!itv.lower_is_boundary_infinity()) {
+        const mpq_class& l = itv.lower();
+        ditv.has_lb = true;
+        mpz_cdiv_q(ditv.lb.get_mpz_t(), l.get_num_mpz_t(), l.get_den_mpz_t());
+        if(itv.lower_is_open() && ditv.lb == l)
+          ditv.lb += 1;
+      }
+      if(!itv.upper_is_boundary_infinity()) {
+        const mpq_class& u = itv.upper();
+        ditv.has_ub = true;
+        mpz_fdiv_q(ditv.ub.get_mpz_t(), u.get_num_mpz_t(), u.get_den_mpz_t());
+        if(itv.upper_is_open() && ditv.ub == u)
+          ditv.ub -= 1;
+      }
+      // The disjunct has no integral point
+      if(ditv.has_lb && ditv.has_ub && ditv.lb > ditv.ub)
+        return false;
+    }
+    return true;
+  }
+
+  template <typename PSET>
+  void PointsetPowersetAv<PSET>::GetDisjunctBoxes(const Parma_Polyhedra_Library::Pointset_Powerset<PSET>& pp,
+                                                  std::vector<disjunct_box_type>& boxes, std::vector<bool>& has_box) {
+    for (typename Parma_Polyhedra_Library::Pointset_Powerset<PSET>::const_iterator it = pp.begin(); it != pp.end(); it++) {
+      boxes.push_back(disjunct_box_type());
+      has_box.push_back(GetDisjunctBox(it->pointset(), boxes.back()));
+    }
+  }
+
+  // Is there a dimension on which the bounds of b1 and b2 do not overlap?
+  template <typename PSET>
+  bool PointsetPowersetAv<PSET>::AreDisjoint(const disjunct_box_type& b1, const disjunct_box_type& b2) {
+    for(unsigned i = 0; i < b1.size(); i++) {
+      if((b1[i].has_ub && b2[i].has_lb && b1[i].ub < b2[i].lb) || (b2[i].has_ub && b1[i].has_lb && b2[i].ub < b1[i].lb))
+        return true;
+    }
+    return false;
+  }
+
+  template <typename PSET>
+  bool PointsetPowersetAv<PSET>::Contains(const disjunct_box_type& b1, const disjunct_box_type& b2) {
+    for(unsigned i = 0; i < b1.size(); i++) {
+      if(b1[i].has_lb && (!b2[i].has_lb || b2[i].lb < b1[i].lb))
+        return false;
+      if(b1[i].has_ub && (!b2[i].has_ub || b2[i].ub > b1[i].ub))
+        return false;
+    }
+    return true;
+  }
+
+  template <typename PSET>
+  bool PointsetPowersetAv<PSET>::BoxLess::operator()(const disjunct_box_type& b1, const disjunct_box_type& b2) const {
+    if(b1.size() != b2.size())
+      return b1.size() < b2.size();
+    for(unsigned i = 0; i < b1.size(); i++) {
+      if(b1[i].has_lb != b2[i].has_lb)
+        return b1[i].has_lb < b2[i].has_lb;
+      if(b1[i].has_lb && b1[i].lb != b2[i].lb)
+        return b1[i].lb < b2[i].lb;
+      if(b1[i].has_ub != b2[i].has_ub)
+        return b1[i].has_ub < b2[i].has_ub;
+      if(b1[i].has_ub && b1[i].ub != b2[i].ub)
+        return b1[i].ub < b2[i].ub;
+    }
+    return false;
+  }
+
+  // The boxes of the disjuncts are computed once, and the intersection of a pair of disjuncts is only computed
+  // when their boxes overlap. The intersections without integral points are dropped.
+  template <typename PSET>
+  void PointsetPowersetAv<PSET>::MeetWithBoxFilter(const Parma_Polyhedra_Library::Pointset_Powerset<PSET>& that) {
+    std::vector<disjunct_box_type> boxes, that_boxes;
+    std::vector<bool> has_box, that_has_box;
+    GetDisjunctBoxes(pp_, boxes, has_box);
+    GetDisjunctBoxes(that, that_boxes, that_has_box);
+
+    unsigned num_skipped = 0;
+    Parma_Polyhedra_Library::Pointset_Powerset<PSET> meet_pp(pp_.space_dimension(), Parma_Polyhedra_Library::EMPTY);
+    unsigned i = 0;
+    for (typename Parma_Polyhedra_Library::Pointset_Powerset<PSET>::const_iterator it = pp_.begin(); it != pp_.end(); it++, i++) {
+      if(!has_box[i])
+        continue;
+      unsigned j = 0;
+      for (typename Parma_Polyhedra_Library::Pointset_Powerset<PSET>::const_iterator that_it = that.begin(); that_it != that.end(); that_it++, j++) {
+        if(!that_has_box[j] || AreDisjoint(boxes[i], that_boxes[j])) {
+          num_skipped++;
+          continue;
+        }
+        PSET d = it->pointset();
+        d.intersection_assign(that_it->pointset());
+        if(!d.is_empty())
+          meet_pp.add_disjunct(d);
+      }
+    }
+    pp_ = meet_pp;
+    DEBUG_PRINTING(DBG_PRINT_DETAILS, std::cout << "\nMeetWithBoxFilter skipped " << num_skipped << " pairs of disjuncts";);
+  }
+
+  // A disjunct with integral points can only be contained in a disjunct whose box contains its box
+  template <typename PSET>
+  bool PointsetPowersetAv<PSET>::ContainsWithBoxFilter(const Parma_Polyhedra_Library::Pointset_Powerset<PSET>& that) const {
+    std::vector<disjunct_box_type> boxes, that_boxes;
+    std::vector<bool> has_box, that_has_box;
+    GetDisjunctBoxes(pp_, boxes, has_box);
+    GetDisjunctBoxes(that, that_boxes, that_has_box);
+
+    unsigned j = 0;
+    for (typename Parma_Polyhedra_Library::Pointset_Powerset<PSET>::const_iterator that_it = that.begin(); that_it != that.end(); that_it++, j++) {
+      bool is_contained = false;
+      unsigned i = 0;
+      for (typename Parma_Polyhedra_Library::Pointset_Powerset<PSET>::const_iterator it = pp_.begin(); it != pp_.end() && !is_contained; it++, i++) {
+        if(that_has_box[j] && (!has_box[i] || !Contains(boxes[i], that_boxes[j])))
+          continue;
+        is_contained = it->pointset().contains(that_it->pointset());
+      }
+      if(!is_contained)
+        return false;
+    }
+    return true;
+  }
+
+  // Equal disjuncts have equal boxes, so the disjuncts of that are indexed by their boxes, and each disjunct of
+  // this is only compared with the disjuncts of that with the same box
+  template <typename PSET>
+  bool PointsetPowersetAv<PSET>::EqualsWithBoxFilter(const Parma_Polyhedra_Library::Pointset_Powerset<PSET>& that) const {
+    typedef std::multimap<disjunct_box_type, const PSET*, BoxLess> box_index_type;
+    pp_.omega_reduce();
+    that.omega_reduce();
+    if(pp_.size() != that.size())
+      return false;
+
+    std::vector<disjunct_box_type> boxes, that_boxes;
+    std::vector<bool> has_box, that_has_box;
+    GetDisjunctBoxes(pp_, boxes, has_box);
+    GetDisjunctBoxes(that, that_boxes, that_has_box);
+
+    // The disjuncts without integral points are indexed by an empty box
+    box_index_type that_index;
+    unsigned j = 0;
+    for (typename Parma_Polyhedra_Library::Pointset_Powerset<PSET>::const_iterator that_it = that.begin(); that_it != that.end(); that_it++, j++) {
+      that_index.insert(typename box_index_type::value_type(that_has_box[j] ? that_boxes[j] : disjunct_box_type(), &that_it->pointset()));
+    }
+
+    unsigned i = 0;
+    for (typename Parma_Polyhedra_Library::Pointset_Powerset<PSET>::const_iterator it = pp_.begin(); it != pp_.end(); it++, i++) {
+      std::pair<typename box_index_type::iterator, typename box_index_type::iterator> range = that_index.equal_range(has_box[i] ? boxes[i] : disjunct_box_type());
+      typename box_index_type::iterator match = range.first;
+      while(match != range.second && !(*match->second == it->pointset()))
+        match++;
+      if(match == range.second)
+        return false;
+      that_index.erase(match);
+    }
+    return true;
+  }
+
+  // The bounds of all the dimensions are read from one box per disjunct, and joined over the disjuncts.
+  template <typename PSET>
+  bool PointsetPowersetAv<PSET>::GetIntervals(interval_map_type& im) const {
+    bool is_bottom = true;
+    for (typename Parma_Polyhedra_Library::Pointset_Powerset<PSET>::const_iterator it = pp_.begin(); it != pp_.end(); it++) {
+      disjunct_box_type box;
+      if(!GetDisjunctBox(it->pointset(), box))
+        continue;
+
+      interval_map_type box_im;
+      for(bm_type::left_const_iterator kit = key_index_bimap_.left.begin(); kit != key_index_bimap_.left.end(); kit++) {
+        box_im.insert(interval_map_type::value_type(kit->first, box[kit->second]));
+      }
+
+      if(is_bottom) {
+        im = box_im;
+        is_bottom = false;
+        continue;
+      }
+      for(interval_map_type::iterator imit = im.begin(); imit != im.end(); imit++) {
+        DimensionInterval& itv = imit->second;
+        const DimensionInterval& bitv = box_im[imit->first];
+        itv.has_lb = itv.has_lb && bitv.has_lb;
+        if(itv.has_lb && bitv.lb < itv.lb)
+          itv.lb = bitv.lb;
+        itv.has_ub = itv.has_ub && bitv.has_ub;
+        if(itv.has_ub && bitv.ub > itv.ub)
+          itv.ub = bitv.ub;
+      }
+    }
+    return !is_bottom;
+  }
+
+  // The equalities are only given for a single disjunct, such as for equalities_only. Bottom is given as 0 = 1.
+  template <typename PSET>
+  bool PointsetPowersetAv<PSET>::GetEqualities(std::vector<constraint_type>& eqs) const {
+    MergePending();
+    affexp_type zero(linexp_type(), mpz_class(0));
+    if(pp_.size() == 0) {
+      eqs.push_back(constraint_type(std::make_pair(zero, affexp_type(linexp_type(), mpz_class(1))), EQ));
+      return true;
+    }
+    if(pp_.size() != 1)
+      return false;
+
+    Parma_Polyhedra_Library::Constraint_System cs = pp_.begin()->pointset().constraints();
+    for(Parma_Polyhedra_Library::Constraint_System::const_iterator cs_it = cs.begin(); cs_it != cs.end(); cs_it++) {
+      if(!cs_it->is_equality())
+        continue;
+      linexp_type le;
+      for(ppl_dimension_type i = 0; i < cs_it->space_dimension(); i++) {
+        const Parma_Polyhedra_Library::GMP_Integer coeff = cs_it->coefficient(Parma_Polyhedra_Library::Variable(i));
+        if(coeff != 0)
+          le.insert(linexp_type::value_type(GetDimensionKeyAtPplDimensionType(i), mpz_class(coeff)));
+      }
+      eqs.push_back(constraint_type(std::make_pair(affexp_type(le, mpz_class(cs_it->inhomogeneous_term())), zero), EQ));
+    }
+    return true;
+  }
+
   // Get the vocabulary which directly or indirectly depends on k
   template <typename PSET>
   Vocabulary PointsetPowersetAv<PSET>::GetDependentVocabulary(DimensionKey& k) const {
@@ -408,6 +676,40 @@ namespace abstract_domain
 
   template <typename PSET>
   void PointsetPowersetAv<PSET>::AddConstraint(PointsetPowersetAv<PSET>::affexp_type lhs, PointsetPowersetAv<PSET>::affexp_type rhs, PointsetPowersetAv<PSET>::OpType op) {
+    Parma_Polyhedra_Library::Constraint c;
+    if(GetPplConstraint(lhs, rhs, op, c))
+      AddConstraint(c);
+  }
+
+  // All the constraints are added to each disjunct in a single update
+  template <typename PSET>
+  void PointsetPowersetAv<PSET>::AddConstraints(const std::vector<PointsetPowersetAv<PSET>::constraint_type>& cs) {
+    Parma_Polyhedra_Library::Constraint_System ppl_cs;
+    for(typename std::vector<constraint_type>::const_iterator it = cs.begin(); it != cs.end(); it++) {
+      Parma_Polyhedra_Library::Constraint c;
+      if(GetPplConstraint(it->first.first, it->first.second, it->second, c))
+        ppl_cs.insert(c);
+    }
+    if(!ppl_cs.empty())
+      AddConstraints(ppl_cs);
+  }
+
+  // affine_image updates each disjunct in place, instead of havocing k in a copy and meeting with k = e.
+  // The image of an affine space is an affine space, so this is also exact when equalities_only_ is set.
+  template <typename PSET>
+  void PointsetPowersetAv<PSET>::AssignAffine(const DimensionKey& k, const PointsetPowersetAv<PSET>::affexp_type& e) {
+    Parma_Polyhedra_Library::Linear_Expression le(e.second);
+    for(std::map<DimensionKey, mpz_class>::const_iterator it = e.first.begin(); it != e.first.end(); it++) {
+      Parma_Polyhedra_Library::Variable v_it(GetPplDimensionTypeFromDimensionKey(it->first));
+      le = le + (it->second)*Parma_Polyhedra_Library::Linear_Expression(v_it);
+    }
+    Parma_Polyhedra_Library::Variable v_k(GetPplDimensionTypeFromDimensionKey(k));
+    pp_.affine_image(v_k, le);
+  }
+
+  // Translates lhs op rhs to c, returns false if the constraint must be dropped
+  template <typename PSET>
+  bool PointsetPowersetAv<PSET>::GetPplConstraint(const PointsetPowersetAv<PSET>::affexp_type& lhs, const PointsetPowersetAv<PSET>::affexp_type& rhs, PointsetPowersetAv<PSET>::OpType op, Parma_Polyhedra_Library::Constraint& c) const {
     Parma_Polyhedra_Library::Linear_Expression le_exp_lhs(lhs.second);
     for(std::map<DimensionKey, mpz_class>::const_iterator it = lhs.first.begin(); it != lhs.first.end(); it++) {
       Parma_Polyhedra_Library::Variable v_it(GetPplDimensionTypeFromDimensionKey(it->first));
@@ -422,7 +724,6 @@ namespace abstract_domain
       le_exp_rhs = le_exp_rhs + (it->second)*le_v_it;
     }
 
-    Parma_Polyhedra_Library::Constraint c;
     bool is_equality = false;
     switch(op) {
     case EQ:
@@ -437,9 +738,7 @@ namespace abstract_domain
       break;
     }
 
-    if(equalities_only_ && !is_equality)
-      return;
-    AddConstraint(c);
+    return (!equalities_only_ || is_equality);
   }
 
   template <typename PSET>
@@ -452,11 +751,19 @@ namespace abstract_domain
     pp_.add_constraints(cs);
   }
 
-  // Template specializations for octagons
+  // Template specializations for octagons and BD shapes
   template <>
   void PointsetPowersetAv<Parma_Polyhedra_Library::Octagonal_Shape<mpz_class> >::AddConstraints(const Parma_Polyhedra_Library::Constraint_System & cs);
   template <>
   void PointsetPowersetAv<Parma_Polyhedra_Library::Octagonal_Shape<mpz_class> >::AddConstraint(const Parma_Polyhedra_Library::Constraint & c);
+  template <>
+  void PointsetPowersetAv<Parma_Polyhedra_Library::Octagonal_Shape<int64_t> >::AddConstraints(const Parma_Polyhedra_Library::Constraint_System & cs);
+  template <>
+  void PointsetPowersetAv<Parma_Polyhedra_Library::Octagonal_Shape<int64_t> >::AddConstraint(const Parma_Polyhedra_Library::Constraint & c);
+  template <>
+  void PointsetPowersetAv<Parma_Polyhedra_Library::BD_Shape<int64_t> >::AddConstraints(const Parma_Polyhedra_Library::Constraint_System & cs);
+  template <>
+  void PointsetPowersetAv<Parma_Polyhedra_Library::BD_Shape<int64_t> >::AddConstraint(const Parma_Polyhedra_Library::Constraint & c);
 
   template <typename PSET>
   void PointsetPowersetAv<PSET>::Reduce() {
@@ -468,6 +775,24 @@ namespace abstract_domain
     // Default implementation does nothing
   }
 
+  template <typename PSET>
+  void PointsetPowersetAv<PSET>::ReduceDimensions(const ref_ptr<AbstractValue>& that, const Vocabulary& dirty, Vocabulary& changed) {
+    Reduce(that);
+  }
+
+  template <>
+  void PointsetPowersetAv<Parma_Polyhedra_Library::Octagonal_Shape<mpz_class> >::Reduce(const ref_ptr<AbstractValue>& that);
+  template <>
+  void PointsetPowersetAv<Parma_Polyhedra_Library::Octagonal_Shape<mpz_class> >::ReduceDimensions(const ref_ptr<AbstractValue>& that, const Vocabulary& dirty, Vocabulary& changed);
+  template <>
+  void PointsetPowersetAv<Parma_Polyhedra_Library::Octagonal_Shape<int64_t> >::Reduce(const ref_ptr<AbstractValue>& that);
+  template <>
+  void PointsetPowersetAv<Parma_Polyhedra_Library::Octagonal_Shape<int64_t> >::ReduceDimensions(const ref_ptr<AbstractValue>& that, const Vocabulary& dirty, Vocabulary& changed);
+  template <>
+  void PointsetPowersetAv<Parma_Polyhedra_Library::BD_Shape<int64_t> >::Reduce(const ref_ptr<AbstractValue>& that);
+  template <>
+  void PointsetPowersetAv<Parma_Polyhedra_Library::BD_Shape<int64_t> >::ReduceDimensions(const ref_ptr<AbstractValue>& that, const Vocabulary& dirty, Vocabulary& changed);
+
   // =====================
   // Vocabulary operations
   // =====================
@@ -582,6 +907,7 @@ namespace abstract_domain
   // Input/output
   template <typename PSET>
   std::string PointsetPowersetAv<PSET>::ToString() const {
+    MergePending();
     std::stringstream o;
     o << "Equalities_only:" << equalities_only_;
     PrintVocabularyIndexMap(o);
@@ -594,6 +920,81 @@ namespace abstract_domain
     return o.str();
   }
 
+  // Serialized form: equalities_only_, the vocabulary, and then the constraints of each disjunct.
+  // Each constraint is written as its kind (= or >=), the non-zero coefficients as (ppl dim, coeff)
+  // pairs and the inhomogeneous term. The ppl dims are positions in the sorted vocabulary, which
+  // is how GetVocabularyIndexMap lays them out, so they are stable across runs.
+  template <typename PSET>
+  void PointsetPowersetAv<PSET>::Serialize(std::ostream & out) const {
+    MergePending();
+    out << equalities_only_ << " ";
+    SerializeVocabulary(out, this->voc_);
+    out << pp_.size() << " ";
+    for(typename Parma_Polyhedra_Library::Pointset_Powerset<PSET>::const_iterator it = pp_.begin(); it != pp_.end(); it++) {
+      const Parma_Polyhedra_Library::Constraint_System cs = it->pointset().minimized_constraints();
+      unsigned num_constraints = 0;
+      for(Parma_Polyhedra_Library::Constraint_System::const_iterator cs_it = cs.begin(); cs_it != cs.end(); cs_it++)
+        num_constraints++;
+      out << num_constraints << " ";
+
+      for(Parma_Polyhedra_Library::Constraint_System::const_iterator cs_it = cs.begin(); cs_it != cs.end(); cs_it++) {
+        out << (cs_it->is_equality()? "= " : ">= ");
+        std::vector<std::pair<ppl_dimension_type, mpz_class> > coeffs;
+        for(ppl_dimension_type i = cs_it->space_dimension(); i-- > 0; ) {
+          Parma_Polyhedra_Library::Variable v_i(i);
+          const Parma_Polyhedra_Library::GMP_Integer coeff = cs_it->coefficient(v_i);
+          if(coeff != 0)
+            coeffs.push_back(std::make_pair(i, mpz_class(coeff)));
+        }
+        out << coeffs.size() << " ";
+        for(unsigned j = 0; j < coeffs.size(); j++)
+          out << coeffs[j].first << " " << coeffs[j].second << " ";
+        out << mpz_class(cs_it->inhomogeneous_term()) << " ";
+      }
+    }
+  }
+
+  template <typename PSET>
+  ref_ptr<AbstractValue> PointsetPowersetAv<PSET>::Deserialize(std::istream & in) const {
+    bool equalities_only;
+    in >> equalities_only;
+    Vocabulary voc = DeserializeVocabulary(in);
+    ref_ptr<PointsetPowersetAv> ret = new PointsetPowersetAv(voc, false/*is_universe*/, equalities_only);
+
+    unsigned num_disjuncts = 0;
+    in >> num_disjuncts;
+    for(unsigned d = 0; d < num_disjuncts; d++) {
+      unsigned num_constraints = 0;
+      in >> num_constraints;
+      Parma_Polyhedra_Library::Constraint_System cs;
+      for(unsigned c = 0; c < num_constraints; c++) {
+        std::string kind;
+        unsigned num_coeffs = 0;
+        in >> kind >> num_coeffs;
+        Parma_Polyhedra_Library::Linear_Expression le;
+        for(unsigned j = 0; j < num_coeffs; j++) {
+          ppl_dimension_type i;
+          mpz_class coeff;
+          in >> i >> coeff;
+          Parma_Polyhedra_Library::Variable v_i(i);
+          Parma_Polyhedra_Library::Linear_Expression le_v_i(v_i);
+          le = le + coeff*le_v_i;
+        }
+        mpz_class inhomogeneous_term;
+        in >> inhomogeneous_term;
+        le = le + inhomogeneous_term;
+        if(kind == "=")
+          cs.insert(le == 0);
+        else
+          cs.insert(le >= 0);
+      }
+      PSET p(voc.size(), Parma_Polyhedra_Library::UNIVERSE);
+      p.add_constraints(cs);
+      ret->pp_.add_disjunct(p);
+    }
+    return ret.get_ptr();
+  }
+
   template <typename PSET>
   std::ostream& PointsetPowersetAv<PSET>::PrintPSET(std::ostream& o, const PSET& p) const {
     o << "Congruences:";
@@ -844,10 +1245,95 @@ namespace abstract_domain
   }
 
   template <typename PSET>
-  void PointsetPowersetAv<PSET>::MergeHeuristic() {
+  size_t PointsetPowersetAv<PSET>::NumConstraints() const {
+    MergePending();
+    size_t num_constraints = 0;
+    for(typename Parma_Polyhedra_Library::Pointset_Powerset<PSET>::const_iterator it = pp_.begin(); it != pp_.end(); it++) {
+      const Parma_Polyhedra_Library::Constraint_System cs = it->pointset().minimized_constraints();
+      for(Parma_Polyhedra_Library::Constraint_System::const_iterator cs_it = cs.begin(); cs_it != cs.end(); cs_it++)
+        num_constraints++;
+    }
+    return num_constraints;
+  }
+
+  // The hash of a disjunct is the sum of the hashes of its minimized constraints, and the hash of the
+  // powerset is the sum of the hashes of its disjuncts, so that neither depends on their order
+  template <typename PSET>
+  size_t PointsetPowersetAv<PSET>::Hash() const {
+    MergePending();
+    size_t pp_hash = 0;
+    for(typename Parma_Polyhedra_Library::Pointset_Powerset<PSET>::const_iterator it = pp_.begin(); it != pp_.end(); it++) {
+      const Parma_Polyhedra_Library::Constraint_System cs = it->pointset().minimized_constraints();
+      size_t disjunct_hash = 0;
+      for(Parma_Polyhedra_Library::Constraint_System::const_iterator cs_it = cs.begin(); cs_it != cs.end(); cs_it++) {
+        size_t c_hash = HashCombine(cs_it->is_equality(), cs_it->is_strict_inequality());
+        for(Parma_Polyhedra_Library::dimension_type i = 0; i < cs_it->space_dimension(); i++) {
+          const Parma_Polyhedra_Library::GMP_Integer coeff = cs_it->coefficient(Parma_Polyhedra_Library::Variable(i));
+          c_hash = HashCombine(c_hash, (size_t)coeff.get_si());
+        }
+        const Parma_Polyhedra_Library::GMP_Integer b = cs_it->inhomogeneous_term();
+        c_hash = HashCombine(c_hash, (size_t)b.get_si());
+        disjunct_hash += c_hash;
+      }
+      pp_hash += HashCombine(pp_.space_dimension(), disjunct_hash);
+    }
+    return HashCombine(HashVocabulary(this->GetVocabulary()), HashCombine(pp_.size(), pp_hash));
+  }
+
+  // Two powersets are structurally equal if they have the same disjuncts in the same order
+  template <typename PSET>
+  bool PointsetPowersetAv<PSET>::StructurallyEqual(const AbstractValue& that) const {
+    const PointsetPowersetAv* that_p = static_cast<const PointsetPowersetAv*>(&that);
+    MergePending();
+    that_p->MergePending();
+    if(equalities_only_ != that_p->equalities_only_ || this->GetVocabulary() != that_p->GetVocabulary() || pp_.size() != that_p->pp_.size())
+      return false;
+    typename Parma_Polyhedra_Library::Pointset_Powerset<PSET>::const_iterator that_it = that_p->pp_.begin();
+    for(typename Parma_Polyhedra_Library::Pointset_Powerset<PSET>::const_iterator it = pp_.begin(); it != pp_.end(); it++, that_it++) {
+      if(it->pointset() != that_it->pointset())
+        return false;
+    }
+    return true;
+  }
+
+  // Coarsen replaces each disjunct by its octagonal hull (computed with polynomial complexity,
+  // which is an overapproximation) and then merges the disjuncts down to max_disjuncts.
+  // The equalities only domain is never made octagonal as it cannot represent inequalities.
+  template <typename PSET>
+  void PointsetPowersetAv<PSET>::Coarsen(unsigned max_disjuncts, bool use_octagons) {
+    if(use_octagons && !equalities_only_) {
+      Parma_Polyhedra_Library::Pointset_Powerset<PSET> pp_oct(pp_.space_dimension(), Parma_Polyhedra_Library::EMPTY);
+      for(typename Parma_Polyhedra_Library::Pointset_Powerset<PSET>::const_iterator it = pp_.begin(); it != pp_.end(); it++) {
+        Parma_Polyhedra_Library::Octagonal_Shape<mpz_class> oct(it->pointset(), Parma_Polyhedra_Library::POLYNOMIAL_COMPLEXITY);
+        PSET p(pp_.space_dimension(), Parma_Polyhedra_Library::UNIVERSE);
+        // A BD_Shape cannot represent the octagonal sums, it keeps the bounded differences
+        p.refine_with_constraints(oct.constraints());
+        pp_oct.add_disjunct(p);
+      }
+      pp_ = pp_oct;
+    }
+    MergeHeuristic(max_disjuncts);
+  }
+
+  template <typename PSET>
+  void PointsetPowersetAv<PSET>::MergeHeuristic() const {
+    MergeHeuristic(max_disjunctions);
+  }
+
+  template <typename PSET>
+  void PointsetPowersetAv<PSET>::MergePending() const {
+    if(!merge_pending_)
+      return;
+    MergeHeuristic();
+  }
+
+  template <typename PSET>
+  void PointsetPowersetAv<PSET>::MergeHeuristic(unsigned max_disjuncts) const {
     typedef std::pair<std::pair<std::shared_ptr<PSET>, std::shared_ptr<PSET> >, std::pair<unsigned, mpz_class> > T;
 
-    unsigned max_disjunctions_temp = max_disjunctions;
+    merge_pending_ = false;
+
+    unsigned max_disjunctions_temp = max_disjuncts;
     if(equalities_only_)
       max_disjunctions_temp = 1;
 
@@ -876,7 +1362,7 @@ namespace abstract_domain
 
     // If the distance is negative, the abstract domains should be merged
     // even if the number of disjunctions doesn't exceed max_disjunctions
-    while(pp_copy.size() > max_disjunctions) {
+    while(pp_copy.size() > max_disjuncts) {
       // Get the pair of abstract values, with the minimum distance 
       T pair_with_min_dist = *(dist_func.begin());
 
@@ -1,4 +1,6 @@
 #include "src/AbstractDomain/PointsetPowerset/pointset_powerset_av.hpp"
+#include "src/AbstractDomain/common/BitpreciseWrappedAbstractValue.hpp"
+#include "src/AbstractDomain/common/AvSemiring.hpp"
 
 //Avoid mutiple macro redefinition
 #define GTEST_DONT_DEFINE_TEST 1
@@ -10,6 +12,8 @@ using namespace Parma_Polyhedra_Library;
 typedef AbstractValue AV;
 typedef PointsetPowersetAv<C_Polyhedron> PP_CPOLY_AV;
 typedef PointsetPowersetAv<Octagonal_Shape<mpz_class> > PP_OCT_AV;
+typedef PointsetPowersetAv<Octagonal_Shape<int64_t> > PP_OCT64_AV;
+typedef PointsetPowersetAv<BD_Shape<int64_t> > PP_BD64_AV;
 
 class AvTestInfo {
 public:
@@ -400,6 +404,22 @@ TEST_P(AvTest, RemoveVocabulary) {
   EXPECT_EQ(5u, d->NumVars());
 }
 
+TEST_P(AvTest, SerializeRoundTrip) {
+  wali::ref_ptr<AV> a = ma();
+  a->Join(mb());
+
+  std::stringstream ss;
+  a->Serialize(ss);
+  avtestinfo_->av->Bottom()->Serialize(ss);
+
+  wali::ref_ptr<AV> a_rt = avtestinfo_->av->Deserialize(ss);
+  EXPECT_EQ(a->GetVocabulary(), a_rt->GetVocabulary());
+  EXPECT_EQ(*a, *a_rt);
+
+  wali::ref_ptr<AV> bot_rt = avtestinfo_->av->Deserialize(ss);
+  EXPECT_TRUE(bot_rt->IsBottom());
+}
+
 class PointsetPowersetAvTest : public ::testing::Test {
 public:
   PointsetPowersetAvTest() {
@@ -730,6 +750,53 @@ TEST_F(PointsetPowersetAvTest, Join3Intervalkis2) {
   PP_CPOLY_AV::max_disjunctions = 1;
 }
 
+TEST_F(PointsetPowersetAvTest, Coarsen) {
+  Vocabulary v;
+  v.insert(ppavtestinfo_->k0);
+  v.insert(ppavtestinfo_->k1);
+
+  PP_CPOLY_AV::max_disjunctions = 2;
+  PP_CPOLY_AV::linexp_type x_le; x_le.insert(PP_CPOLY_AV::linexp_type::value_type(ppavtestinfo_->k0, mpz_class(1)));
+  PP_CPOLY_AV::linexp_type y_le; y_le.insert(PP_CPOLY_AV::linexp_type::value_type(ppavtestinfo_->k1, mpz_class(1)));
+  PP_CPOLY_AV::linexp_type x_2y_le; 
+  x_2y_le.insert(PP_CPOLY_AV::linexp_type::value_type(ppavtestinfo_->k0, mpz_class(1)));
+  x_2y_le.insert(PP_CPOLY_AV::linexp_type::value_type(ppavtestinfo_->k1, mpz_class(2)));
+
+  wali::ref_ptr<PP_CPOLY_AV> p1 = new PP_CPOLY_AV(v);
+  p1->AddConstraintNorhs(PP_CPOLY_AV::affexp_type(x_le, 0), PP_CPOLY_AV::OpType::GE); // x >= 0
+  p1->AddConstraintNorhs(PP_CPOLY_AV::affexp_type(y_le, 0), PP_CPOLY_AV::OpType::GE); // y >= 0
+  p1->AddConstraintNorhs(PP_CPOLY_AV::affexp_type(x_2y_le, -10), PP_CPOLY_AV::OpType::LE); // x + 2y <= 10
+
+  wali::ref_ptr<PP_CPOLY_AV> p2 = new PP_CPOLY_AV(v);
+  p2->AddConstraintNorhs(PP_CPOLY_AV::affexp_type(x_le, -20), PP_CPOLY_AV::OpType::GE); // x >= 20
+  p2->AddConstraintNorhs(PP_CPOLY_AV::affexp_type(x_le, -30), PP_CPOLY_AV::OpType::LE); // x <= 30
+  p2->AddConstraintNorhs(PP_CPOLY_AV::affexp_type(y_le, 0), PP_CPOLY_AV::OpType::EQ); // y = 0
+
+  wali::ref_ptr<AV> p1_j_p2 = p1->Copy();
+  p1_j_p2->Join(p2);
+  EXPECT_EQ(static_cast<PP_CPOLY_AV*>(p1_j_p2.get_ptr())->num_disjuncts(), 2u);
+  EXPECT_GE(p1_j_p2->NumConstraints(), 6u);
+
+  // Merging the disjuncts
+  wali::ref_ptr<AV> p1_j_p2_merged = p1_j_p2->Copy();
+  p1_j_p2_merged->Coarsen(1, false/*use_octagons*/);
+  p1_j_p2_merged->print(std::cout << "\np1_j_p2_merged:");
+  EXPECT_EQ(static_cast<PP_CPOLY_AV*>(p1_j_p2_merged.get_ptr())->num_disjuncts(), 1u);
+  EXPECT_TRUE(p1_j_p2_merged->Overapproximates(p1_j_p2));
+
+  // Octagonal hull of p1 loses x + 2y <= 10, but keeps x <= 10 and y <= 5
+  wali::ref_ptr<AV> p1_oct = p1->Copy();
+  p1_oct->Coarsen(1, true/*use_octagons*/);
+  p1_oct->print(std::cout << "\np1_oct:");
+  EXPECT_TRUE(p1_oct->Overapproximates(p1));
+  EXPECT_FALSE(p1->Overapproximates(p1_oct));
+
+  wali::ref_ptr<PP_CPOLY_AV> exp_box = new PP_CPOLY_AV(v);
+  exp_box->AddConstraintNorhs(PP_CPOLY_AV::affexp_type(y_le, -5), PP_CPOLY_AV::OpType::LE); // y <= 5
+  EXPECT_TRUE(exp_box->Overapproximates(p1_oct));
+  PP_CPOLY_AV::max_disjunctions = 1;
+}
+
 TEST_F(PointsetPowersetAvTest, CommuteMeet) {
   wali::ref_ptr<AV> aMeetB = ma()->Copy();
   aMeetB->Meet(mb());
@@ -904,6 +971,102 @@ TEST_F(PointsetPowersetAvTest, Join3Intervalkis2Oct) {
   PP_OCT_AV::max_disjunctions = 1;
 }
 
+TEST_F(PointsetPowersetAvTest, LazyJoin3Intervalkis2Oct) {
+  Vocabulary v;
+  v.insert(ppavtestinfo_->k0);
+
+  PP_OCT_AV::max_disjunctions = 2;
+  PP_OCT_AV::lazy_merge_limit = 3;
+  wali::ref_ptr<PP_OCT_AV> i1 = new PP_OCT_AV(v);
+  PP_OCT_AV::linexp_type k_le; k_le.insert(PP_OCT_AV::linexp_type::value_type(ppavtestinfo_->k0, mpz_class(1)));
+  i1->AddConstraintNorhs(PP_OCT_AV::affexp_type(k_le, -3), PP_OCT_AV::OpType::GE); // k >= 3
+  i1->AddConstraintNorhs(PP_OCT_AV::affexp_type(k_le, -5), PP_OCT_AV::OpType::LE); // k <= 5
+
+  wali::ref_ptr<PP_OCT_AV> i2 = new PP_OCT_AV(v);
+  i2->AddConstraintNorhs(PP_OCT_AV::affexp_type(k_le, -6), PP_OCT_AV::OpType::GE); // k >= 6
+  i2->AddConstraintNorhs(PP_OCT_AV::affexp_type(k_le, -9), PP_OCT_AV::OpType::LE); // k <= 9
+
+  wali::ref_ptr<PP_OCT_AV> i3 = new PP_OCT_AV(v);
+  i3->AddConstraintNorhs(PP_OCT_AV::affexp_type(k_le, -12), PP_OCT_AV::OpType::GE); // k >= 12
+  i3->AddConstraintNorhs(PP_OCT_AV::affexp_type(k_le, -15), PP_OCT_AV::OpType::LE); // k <= 15
+
+  wali::ref_ptr<PP_OCT_AV> exp_i1_j_i2_j_i3 = new PP_OCT_AV(v);
+  exp_i1_j_i2_j_i3->AddConstraintNorhs(PP_OCT_AV::affexp_type(k_le, -3), PP_OCT_AV::OpType::GE); // k >= 3
+  exp_i1_j_i2_j_i3->AddConstraintNorhs(PP_OCT_AV::affexp_type(k_le, -9), PP_OCT_AV::OpType::LE); // k <= 9
+  exp_i1_j_i2_j_i3->AddDisjunct(i3->GetDisjunct(0));
+
+  // The three disjuncts are kept until the comparison merges them
+  wali::ref_ptr<AV> i1_j_i2_j_i3_av = i1->Copy();
+  i1_j_i2_j_i3_av->Join(i2);
+  i1_j_i2_j_i3_av->Join(i3);
+  PP_OCT_AV* i1_j_i2_j_i3 = static_cast<PP_OCT_AV*>(i1_j_i2_j_i3_av.get_ptr());
+
+  EXPECT_EQ(*exp_i1_j_i2_j_i3, *i1_j_i2_j_i3);
+  EXPECT_EQ(i1_j_i2_j_i3->num_disjuncts(), 2u);
+
+  // Exceeding the hard limit merges in the join
+  PP_OCT_AV::lazy_merge_limit = 2;
+  wali::ref_ptr<AV> i1_j_i3_j_i2_av = i1->Copy();
+  i1_j_i3_j_i2_av->Join(i3);
+  i1_j_i3_j_i2_av->Join(i2);
+  EXPECT_EQ(*exp_i1_j_i2_j_i3, *i1_j_i3_j_i2_av);
+  PP_OCT_AV::lazy_merge_limit = 0;
+  PP_OCT_AV::max_disjunctions = 1;
+}
+
+TEST_F(PointsetPowersetAvTest, BoxFilterMeetkis2Oct) {
+  Vocabulary v;
+  v.insert(ppavtestinfo_->k0);
+
+  PP_OCT_AV::max_disjunctions = 2;
+  PP_OCT_AV::linexp_type k_le; k_le.insert(PP_OCT_AV::linexp_type::value_type(ppavtestinfo_->k0, mpz_class(1)));
+  wali::ref_ptr<AV> a = new PP_OCT_AV(v);
+  a->AddConstraintNorhs(PP_OCT_AV::affexp_type(k_le, -3), PP_OCT_AV::OpType::GE); // k >= 3
+  a->AddConstraintNorhs(PP_OCT_AV::affexp_type(k_le, -5), PP_OCT_AV::OpType::LE); // k <= 5
+  wali::ref_ptr<AV> a2 = new PP_OCT_AV(v);
+  a2->AddConstraintNorhs(PP_OCT_AV::affexp_type(k_le, -12), PP_OCT_AV::OpType::GE); // k >= 12
+  a2->AddConstraintNorhs(PP_OCT_AV::affexp_type(k_le, -15), PP_OCT_AV::OpType::LE); // k <= 15
+  a->Join(a2);
+
+  wali::ref_ptr<AV> b = new PP_OCT_AV(v);
+  b->AddConstraintNorhs(PP_OCT_AV::affexp_type(k_le, -4), PP_OCT_AV::OpType::GE); // k >= 4
+  b->AddConstraintNorhs(PP_OCT_AV::affexp_type(k_le, -13), PP_OCT_AV::OpType::LE); // k <= 13
+  wali::ref_ptr<AV> b2 = new PP_OCT_AV(v);
+  b2->AddConstraintNorhs(PP_OCT_AV::affexp_type(k_le, -20), PP_OCT_AV::OpType::GE); // k >= 20
+  b2->AddConstraintNorhs(PP_OCT_AV::affexp_type(k_le, -30), PP_OCT_AV::OpType::LE); // k <= 30
+  b->Join(b2);
+
+  wali::ref_ptr<AV> aMeetB = a->Copy();
+  aMeetB->Meet(b);
+
+  // The pairs [3, 5], [20, 30] and [12, 15], [20, 30] are skipped
+  PP_OCT_AV::box_filter = true;
+  wali::ref_ptr<AV> aMeetB_filter = a->Copy();
+  aMeetB_filter->Meet(b);
+
+  EXPECT_EQ(*aMeetB, *aMeetB_filter);
+  EXPECT_EQ(static_cast<PP_OCT_AV*>(aMeetB_filter.get_ptr())->num_disjuncts(), 2u);
+  EXPECT_TRUE(a->Overapproximates(aMeetB_filter));
+  EXPECT_TRUE(b->Overapproximates(aMeetB_filter));
+  EXPECT_FALSE(aMeetB_filter->Overapproximates(a));
+  EXPECT_NE(*a, *b);
+  PP_OCT_AV::box_filter = false;
+  PP_OCT_AV::max_disjunctions = 1;
+}
+
+TEST_F(PointsetPowersetAvTest, SerializeRoundTripkis2Oct) {
+  PP_OCT_AV::max_disjunctions = 2;
+  wali::ref_ptr<AV> a = ma_oct()->Copy();
+  a->Join(mb_oct());
+
+  std::stringstream ss;
+  a->Serialize(ss);
+  wali::ref_ptr<AV> a_rt = ma_oct()->Deserialize(ss);
+  EXPECT_EQ(*a, *a_rt);
+  EXPECT_EQ(static_cast<PP_OCT_AV*>(a.get_ptr())->num_disjuncts(), static_cast<PP_OCT_AV*>(a_rt.get_ptr())->num_disjuncts());
+  PP_OCT_AV::max_disjunctions = 1;
+}
+
 TEST_F(PointsetPowersetAvTest, CommuteMeetOct) {
   wali::ref_ptr<AV> aMeetB = ma_oct()->Copy();
   aMeetB->Meet(mb_oct());
@@ -932,6 +1095,299 @@ TEST_F(PointsetPowersetAvTest, CommuteMeetkis2Oct) {
   PP_OCT_AV::max_disjunctions = 2;
 }
 
+TEST_F(PointsetPowersetAvTest, GetIntervalskis2Oct) {
+  Vocabulary v;
+  v.insert(ppavtestinfo_->k0);
+  v.insert(ppavtestinfo_->k1);
+
+  PP_OCT_AV::max_disjunctions = 2;
+  PP_OCT_AV::linexp_type k0_le; k0_le.insert(PP_OCT_AV::linexp_type::value_type(ppavtestinfo_->k0, mpz_class(1)));
+  PP_OCT_AV::linexp_type k1_le; k1_le.insert(PP_OCT_AV::linexp_type::value_type(ppavtestinfo_->k1, mpz_class(1)));
+  wali::ref_ptr<PP_OCT_AV> i1 = new PP_OCT_AV(v);
+  i1->AddConstraintNorhs(PP_OCT_AV::affexp_type(k0_le, -3), PP_OCT_AV::OpType::GE); // k0 >= 3
+  i1->AddConstraintNorhs(PP_OCT_AV::affexp_type(k0_le, -5), PP_OCT_AV::OpType::LE); // k0 <= 5
+  i1->AddConstraintNorhs(PP_OCT_AV::affexp_type(k1_le, -7), PP_OCT_AV::OpType::EQ); // k1 = 7
+
+  wali::ref_ptr<PP_OCT_AV> i2 = new PP_OCT_AV(v);
+  i2->AddConstraintNorhs(PP_OCT_AV::affexp_type(k0_le, -8), PP_OCT_AV::OpType::GE); // k0 >= 8
+  i2->AddConstraintNorhs(PP_OCT_AV::affexp_type(k1_le, -7), PP_OCT_AV::OpType::EQ); // k1 = 7
+
+  wali::ref_ptr<AV> i1_j_i2 = i1->Copy();
+  i1_j_i2->Join(i2);
+  EXPECT_EQ(static_cast<PP_OCT_AV*>(i1_j_i2.get_ptr())->num_disjuncts(), 2u);
+
+  AV::interval_map_type im;
+  EXPECT_TRUE(i1_j_i2->GetIntervals(im));
+  const AV::DimensionInterval& k0_itv = im[ppavtestinfo_->k0];
+  EXPECT_TRUE(k0_itv.has_lb);
+  EXPECT_EQ(k0_itv.lb, mpz_class(3));
+  EXPECT_FALSE(k0_itv.has_ub);
+  mpz_class c;
+  EXPECT_TRUE(im[ppavtestinfo_->k1].IsConstant(c));
+  EXPECT_EQ(c, mpz_class(7));
+
+  AV::interval_map_type btm_im;
+  EXPECT_FALSE(i1_j_i2->Bottom()->GetIntervals(btm_im));
+  PP_OCT_AV::max_disjunctions = 1;
+}
+
+TEST_F(PointsetPowersetAvTest, PropagateNonOctagonalConstraintOct) {
+  Vocabulary v;
+  v.insert(ppavtestinfo_->k0);
+  v.insert(ppavtestinfo_->k1);
+  v.insert(ppavtestinfo_->k2);
+
+  PP_OCT_AV::propagation_rounds = 2;
+  PP_OCT_AV::linexp_type k0_le; k0_le.insert(PP_OCT_AV::linexp_type::value_type(ppavtestinfo_->k0, mpz_class(1)));
+  PP_OCT_AV::linexp_type k1_le; k1_le.insert(PP_OCT_AV::linexp_type::value_type(ppavtestinfo_->k1, mpz_class(1)));
+  PP_OCT_AV::linexp_type k2_le; k2_le.insert(PP_OCT_AV::linexp_type::value_type(ppavtestinfo_->k2, mpz_class(1)));
+  wali::ref_ptr<PP_OCT_AV> a = new PP_OCT_AV(v);
+  a->AddConstraintNorhs(PP_OCT_AV::affexp_type(k0_le, -1), PP_OCT_AV::OpType::GE); // k0 >= 1
+  a->AddConstraintNorhs(PP_OCT_AV::affexp_type(k1_le, 0), PP_OCT_AV::OpType::GE); // k1 >= 0
+  a->AddConstraintNorhs(PP_OCT_AV::affexp_type(k2_le, -10), PP_OCT_AV::OpType::LE); // k2 <= 10
+
+  // 2*k0 + k1 <= k2
+  PP_OCT_AV::linexp_type lhs_le;
+  lhs_le.insert(PP_OCT_AV::linexp_type::value_type(ppavtestinfo_->k0, mpz_class(2)));
+  lhs_le.insert(PP_OCT_AV::linexp_type::value_type(ppavtestinfo_->k1, mpz_class(1)));
+  a->AddConstraint(PP_OCT_AV::affexp_type(lhs_le, 0), PP_OCT_AV::affexp_type(k2_le, 0), PP_OCT_AV::OpType::LE);
+  a->print(std::cout << "\na:");
+
+  AV::interval_map_type im;
+  EXPECT_TRUE(a->GetIntervals(im));
+  EXPECT_TRUE(im[ppavtestinfo_->k0].has_ub);
+  EXPECT_EQ(im[ppavtestinfo_->k0].ub, mpz_class(5));
+  EXPECT_TRUE(im[ppavtestinfo_->k1].has_ub);
+  EXPECT_EQ(im[ppavtestinfo_->k1].ub, mpz_class(8));
+  EXPECT_TRUE(im[ppavtestinfo_->k2].has_lb);
+  EXPECT_EQ(im[ppavtestinfo_->k2].lb, mpz_class(2));
+
+  // k1 > k2 contradicts the constraint
+  wali::ref_ptr<AV> b = a->Copy();
+  b->AddConstraint(PP_OCT_AV::affexp_type(k1_le, -1), PP_OCT_AV::affexp_type(k2_le, 0), PP_OCT_AV::OpType::GE);
+  EXPECT_TRUE(b->IsBottom());
+  PP_OCT_AV::propagation_rounds = 0;
+}
+
+TEST_F(PointsetPowersetAvTest, Int64CoefficientsOctAndBD) {
+  Vocabulary v;
+  v.insert(ppavtestinfo_->k0);
+  v.insert(ppavtestinfo_->k1);
+
+  PP_OCT64_AV::linexp_type k0_le; k0_le.insert(PP_OCT64_AV::linexp_type::value_type(ppavtestinfo_->k0, mpz_class(1)));
+  PP_OCT64_AV::linexp_type k1_le; k1_le.insert(PP_OCT64_AV::linexp_type::value_type(ppavtestinfo_->k1, mpz_class(1)));
+  PP_OCT64_AV::linexp_type sum_le(k0_le); sum_le.insert(k1_le.begin(), k1_le.end());
+
+  // k0 >= 1, k1 >= 2 and k0 + k1 <= 10
+  wali::ref_ptr<PP_OCT64_AV> oct = new PP_OCT64_AV(v);
+  oct->AddConstraintNorhs(PP_OCT64_AV::affexp_type(k0_le, -1), PP_OCT64_AV::OpType::GE);
+  oct->AddConstraintNorhs(PP_OCT64_AV::affexp_type(k1_le, -2), PP_OCT64_AV::OpType::GE);
+  oct->AddConstraintNorhs(PP_OCT64_AV::affexp_type(sum_le, -10), PP_OCT64_AV::OpType::LE);
+
+  AV::interval_map_type im;
+  EXPECT_TRUE(oct->GetIntervals(im));
+  EXPECT_EQ(im[ppavtestinfo_->k0].ub, mpz_class(8));
+  EXPECT_EQ(im[ppavtestinfo_->k1].ub, mpz_class(9));
+  EXPECT_TRUE(oct->Overapproximates(oct->Bottom()));
+  EXPECT_FALSE(oct->Bottom()->Overapproximates(oct));
+
+  // A BD shape cannot represent k0 + k1 <= 10, it is bound-propagated
+  PP_BD64_AV::propagation_rounds = 1;
+  wali::ref_ptr<PP_BD64_AV> bd = new PP_BD64_AV(v);
+  bd->AddConstraintNorhs(PP_BD64_AV::affexp_type(k0_le, -1), PP_BD64_AV::OpType::GE);
+  bd->AddConstraintNorhs(PP_BD64_AV::affexp_type(k1_le, -2), PP_BD64_AV::OpType::GE);
+  bd->AddConstraintNorhs(PP_BD64_AV::affexp_type(sum_le, -10), PP_BD64_AV::OpType::LE);
+
+  AV::interval_map_type bd_im;
+  EXPECT_TRUE(bd->GetIntervals(bd_im));
+  EXPECT_EQ(bd_im[ppavtestinfo_->k0].ub, mpz_class(8));
+  EXPECT_EQ(bd_im[ppavtestinfo_->k1].ub, mpz_class(9));
+  PP_BD64_AV::propagation_rounds = 0;
+}
+
+// A dimension that the pre-analysis found in the unsigned range is not wrapped, only bounded
+TEST_F(PointsetPowersetAvTest, NoWrapDimensionOct) {
+  DimensionKey k("nw", 0, utils::eight);
+  Vocabulary v;
+  v.insert(k);
+  BitpreciseWrappedAbstractValue::no_wrap_unsigned_voc.insert(k);
+
+  PP_OCT_AV::linexp_type k_le; k_le.insert(PP_OCT_AV::linexp_type::value_type(k, mpz_class(1)));
+  wali::ref_ptr<AV> oct = new PP_OCT_AV(v);
+  oct->AddConstraintNorhs(PP_OCT_AV::affexp_type(k_le, -3), PP_OCT_AV::OpType::GE); // k >= 3
+  oct->AddConstraintNorhs(PP_OCT_AV::affexp_type(k_le, -10), PP_OCT_AV::OpType::LE); // k <= 10
+  wali::ref_ptr<BitpreciseWrappedAbstractValue> wav = new BitpreciseWrappedAbstractValue(oct, BitpreciseWrappedAbstractValue::VocabularySignedness());
+  wav->Wrap(k, false);
+
+  bool is_signed = true;
+  EXPECT_TRUE(wav->IsWrapped(k, is_signed));
+  EXPECT_FALSE(is_signed);
+  AV::interval_map_type im;
+  EXPECT_TRUE(wav->GetIntervals(im));
+  EXPECT_EQ(im[k].lb, mpz_class(3));
+  EXPECT_EQ(im[k].ub, mpz_class(10));
+  BitpreciseWrappedAbstractValue::no_wrap_unsigned_voc.clear();
+}
+
+// The unsigned 200 is held as the signed -56, wrapping it as unsigned cannot only add the unsigned bounds
+TEST_F(PointsetPowersetAvTest, NoWrapDimensionSignChangeOct) {
+  DimensionKey k("nw", 0, utils::eight);
+  Vocabulary v;
+  v.insert(k);
+
+  PP_OCT_AV::linexp_type k_le; k_le.insert(PP_OCT_AV::linexp_type::value_type(k, mpz_class(1)));
+  wali::ref_ptr<AV> oct = new PP_OCT_AV(v);
+  oct->AddConstraintNorhs(PP_OCT_AV::affexp_type(k_le, 56), PP_OCT_AV::OpType::EQ); // k = -56
+  wali::ref_ptr<BitpreciseWrappedAbstractValue> wav = new BitpreciseWrappedAbstractValue(oct, BitpreciseWrappedAbstractValue::VocabularySignedness());
+  wav->Wrap(k, true);
+
+  BitpreciseWrappedAbstractValue::no_wrap_unsigned_voc.insert(k);
+  wav->Wrap(k, false);
+
+  bool is_signed = true;
+  EXPECT_TRUE(wav->IsWrapped(k, is_signed));
+  EXPECT_FALSE(is_signed);
+  EXPECT_FALSE(wav->IsBottom());
+  AV::interval_map_type im;
+  EXPECT_TRUE(wav->GetIntervals(im));
+  EXPECT_TRUE(im[k].has_lb && im[k].lb <= 200);
+  EXPECT_TRUE(im[k].has_ub && im[k].ub >= 200);
+  BitpreciseWrappedAbstractValue::no_wrap_unsigned_voc.clear();
+}
+
+// A dimension inferred to be unsigned starts out bounded as unsigned, as in GetStartingState, so the wrap of
+// an unsigned comparison finds it already wrapped with that sign and leaves the value unchanged
+TEST_F(PointsetPowersetAvTest, InferredUnsignedDimensionWrappedOnceOct) {
+  DimensionKey k("u", 0, utils::eight);
+  Vocabulary v;
+  v.insert(k);
+  BitpreciseWrappedAbstractValue::inferred_signedness.insert(std::make_pair(k, false));
+
+  BitpreciseWrappedAbstractValue::VocabularySignedness vocab_sign;
+  for(Vocabulary::const_iterator it = v.begin(); it != v.end(); it++) {
+    BitpreciseWrappedAbstractValue::VocabularySignedness::const_iterator inf_it = BitpreciseWrappedAbstractValue::inferred_signedness.find(*it);
+    vocab_sign.insert(std::make_pair(*it, inf_it == BitpreciseWrappedAbstractValue::inferred_signedness.end() ? true : inf_it->second));
+  }
+  wali::ref_ptr<AV> oct = new PP_OCT_AV(v);
+  wali::ref_ptr<BitpreciseWrappedAbstractValue> wav = new BitpreciseWrappedAbstractValue(oct, vocab_sign);
+
+  PP_OCT_AV::linexp_type k_le; k_le.insert(PP_OCT_AV::linexp_type::value_type(k, mpz_class(1)));
+  wav->AddConstraint(PP_OCT_AV::affexp_type(k_le, 0), PP_OCT_AV::affexp_type(PP_OCT_AV::linexp_type(), 200), PP_OCT_AV::OpType::EQ); // k = 200
+  wali::ref_ptr<AV> before = wav->Copy();
+  wav->Wrap(k, false);
+
+  bool is_signed = true;
+  EXPECT_TRUE(wav->IsWrapped(k, is_signed));
+  EXPECT_FALSE(is_signed);
+  EXPECT_EQ(*before, *wav);
+  AV::interval_map_type im;
+  EXPECT_TRUE(wav->GetIntervals(im));
+  EXPECT_EQ(im[k].lb, mpz_class(200));
+  EXPECT_EQ(im[k].ub, mpz_class(200));
+  BitpreciseWrappedAbstractValue::inferred_signedness.clear();
+}
+
+// The flush of a symbolically executed BasicBlock assigns u := u + 100 and s := s + 10 at once, then wraps
+// both in one step, u with its inferred unsigned signedness and s as signed by default
+TEST_F(PointsetPowersetAvTest, ParallelAssignmentWrappedOnceOct) {
+  DimensionKey u("u", 1, utils::eight), s("s", 1, utils::eight);
+  Vocabulary v;
+  v.insert(u);
+  v.insert(s);
+  BitpreciseWrappedAbstractValue::inferred_signedness.insert(std::make_pair(DimensionKey("u", 0, utils::eight), false));
+
+  PP_OCT_AV::linexp_type u_le; u_le.insert(PP_OCT_AV::linexp_type::value_type(u, mpz_class(1)));
+  PP_OCT_AV::linexp_type s_le; s_le.insert(PP_OCT_AV::linexp_type::value_type(s, mpz_class(1)));
+  wali::ref_ptr<AV> oct = new PP_OCT_AV(v);
+  oct->AddConstraintNorhs(PP_OCT_AV::affexp_type(u_le, -100), PP_OCT_AV::OpType::EQ); // u = 100
+  oct->AddConstraintNorhs(PP_OCT_AV::affexp_type(s_le, -120), PP_OCT_AV::OpType::EQ); // s = 120
+  wali::ref_ptr<BitpreciseWrappedAbstractValue> wav = new BitpreciseWrappedAbstractValue(oct, BitpreciseWrappedAbstractValue::VocabularySignedness());
+
+  std::vector<AV::assignment_type> as;
+  as.push_back(AV::assignment_type(u, PP_OCT_AV::affexp_type(u_le, 100)));
+  as.push_back(AV::assignment_type(s, PP_OCT_AV::affexp_type(s_le, 10)));
+  wav->AssignAffineParallel(as);
+  wav->WrapWithInferredSignedness(v);
+
+  bool is_signed = true;
+  EXPECT_TRUE(wav->IsWrapped(u, is_signed));
+  EXPECT_FALSE(is_signed);
+  EXPECT_TRUE(wav->IsWrapped(s, is_signed));
+  EXPECT_TRUE(is_signed);
+  AV::interval_map_type im;
+  EXPECT_TRUE(wav->GetIntervals(im));
+  EXPECT_EQ(im[u].lb, mpz_class(200));
+  EXPECT_EQ(im[u].ub, mpz_class(200));
+  EXPECT_EQ(im[s].lb, mpz_class(-126));
+  EXPECT_EQ(im[s].ub, mpz_class(-126));
+
+  // The later unsigned use of u does not wrap it again
+  wali::ref_ptr<AV> before = wav->Copy();
+  wav->Wrap(u, false);
+  EXPECT_EQ(*before, *wav);
+  BitpreciseWrappedAbstractValue::inferred_signedness.clear();
+}
+
+
+// One round at the head of the loop x = 0; while(*) x++; the weight joined with its increment
+// is a widening weight
+sem_elem_t IncrementRoundOct(sem_elem_t w, const DimensionKey& k) {
+  AvSemiring* w_av = static_cast<AvSemiring*>(w.get_ptr());
+  AV::interval_map_type im;
+  w_av->GetAbstractValue()->GetIntervals(im);
+  Vocabulary v;
+  v.insert(k);
+  PP_OCT_AV::linexp_type k_le; k_le.insert(PP_OCT_AV::linexp_type::value_type(k, mpz_class(1)));
+  wali::ref_ptr<AV> inc = new PP_OCT_AV(v);
+  inc->AddConstraintNorhs(PP_OCT_AV::affexp_type(k_le, -(im[k].lb + 1)), PP_OCT_AV::OpType::GE);
+  if(im[k].has_ub)
+    inc->AddConstraintNorhs(PP_OCT_AV::affexp_type(k_le, -(im[k].ub + 1)), PP_OCT_AV::OpType::LE);
+  return w->combine(new AvSemiring(inc, "", "head", WIDENING_WEIGHT));
+}
+
+// Resuming from a checkpoint taken between two rounds reaches the fixpoint of a fresh run in the same rounds,
+// which requires the widening counts to be saved with the weight
+TEST_F(PointsetPowersetAvTest, ResumedWideningMatchesFreshOct) {
+  DimensionKey k("x", 0, utils::thirty_two);
+  Vocabulary v;
+  v.insert(k);
+  PP_OCT_AV::linexp_type k_le; k_le.insert(PP_OCT_AV::linexp_type::value_type(k, mpz_class(1)));
+  wali::ref_ptr<AV> init = new PP_OCT_AV(v);
+  init->AddConstraintNorhs(PP_OCT_AV::affexp_type(k_le, 0), PP_OCT_AV::OpType::EQ); // x = 0
+  sem_elem_t init_w = new AvSemiring(init, "", "head");
+  AvSemiring::widening_delay_ = 3;
+
+  AvSemiring::widening_counts_.clear();
+  sem_elem_t fresh_w = init_w;
+  unsigned fresh_rounds = 0;
+  for(bool changed = true; changed; fresh_rounds++) {
+    sem_elem_t next_w = IncrementRoundOct(fresh_w, k);
+    changed = !next_w->equal(fresh_w);
+    fresh_w = next_w;
+  }
+
+  AvSemiring::widening_counts_.clear();
+  sem_elem_t resumed_w = init_w;
+  unsigned resumed_rounds = 0;
+  for(; resumed_rounds < 2; resumed_rounds++)
+    resumed_w = IncrementRoundOct(resumed_w, k);
+  std::stringstream ss;
+  static_cast<AvSemiring*>(resumed_w.get_ptr())->Serialize(ss);
+  AvSemiring::SerializeWideningCounts(ss);
+  AvSemiring::widening_counts_.clear();
+  resumed_w = static_cast<AvSemiring*>(init_w.get_ptr())->Deserialize(ss).get_ptr();
+  AvSemiring::DeserializeWideningCounts(ss);
+  for(bool changed = true; changed; resumed_rounds++) {
+    sem_elem_t next_w = IncrementRoundOct(resumed_w, k);
+    changed = !next_w->equal(resumed_w);
+    resumed_w = next_w;
+  }
+
+  EXPECT_TRUE(resumed_w->equal(fresh_w));
+  EXPECT_EQ(fresh_rounds, resumed_rounds);
+  AvSemiring::widening_delay_ = 0;
+  AvSemiring::widening_counts_.clear();
+}
 
 static std::shared_ptr<AvTestInfo> ppavtestinfo;
 INSTANTIATE_TEST_CASE_P(Pp, AvTest, ::testing::Values(ppavtestinfo));
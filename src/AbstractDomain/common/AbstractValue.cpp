@@ -82,6 +82,26 @@ namespace abstract_domain {
     assert(false);
     return Copy();
   }
+
+  // Default implementation of serialization throws an assertion
+  void AbstractValue::Serialize(std::ostream & out) const {
+    std::cout << "The base class AbstractValue does not define Serialize.";
+    assert(false);
+  }
+
+  wali::ref_ptr<AbstractValue> AbstractValue::Deserialize(std::istream & in) const {
+    std::cout << "The base class AbstractValue does not define Deserialize.";
+    assert(false);
+    return Copy();
+  }
+
+  size_t AbstractValue::Hash() const {
+    return HashVocabulary(GetVocabulary());
+  }
+
+  bool AbstractValue::StructurallyEqual(const AbstractValue& that) const {
+    return false;
+  }
 }
 
 std::ostream & operator <<(std::ostream & out, const abstract_domain::AbstractValue& a) {
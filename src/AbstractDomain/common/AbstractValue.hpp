@@ -18,6 +18,26 @@ public:
   typedef std::map<DimensionKey, mpz_class> linexp_type;
   typedef std::pair<linexp_type, mpz_class> affexp_type;
   enum OpType {EQ, GE, LE};
+  typedef std::pair<std::pair<affexp_type, affexp_type>, OpType> constraint_type; // lhs op rhs
+  typedef std::pair<DimensionKey, affexp_type> assignment_type; // k := e
+
+  // Integral bounds lb <= k <= ub of a dimension k, a bound is infinite when its has_ flag is not set
+  struct DimensionInterval {
+    bool has_lb;
+    mpz_class lb;
+    bool has_ub;
+    mpz_class ub;
+
+    DimensionInterval() : has_lb(false), has_ub(false) {}
+
+    bool IsConstant(mpz_class& val) const {
+      if(!has_lb || !has_ub || lb != ub)
+        return false;
+      val = lb;
+      return true;
+    }
+  };
+  typedef std::map<DimensionKey, DimensionInterval> interval_map_type;
 
   // constructors
   AbstractValue  ();
@@ -73,6 +93,13 @@ public:
   virtual void Reduce() = 0;
   virtual void Reduce(const ref_ptr<AbstractValue>& that) = 0;
 
+  // Reduce this with the facts of that which may have changed since the last reduction, i.e. the ones
+  // connected to a dimension of dirty, and add to changed the dimensions whose facts got stronger in this.
+  // The default implementation reduces with all the facts of that, and reports no change.
+  virtual void ReduceDimensions(const ref_ptr<AbstractValue>& that, const Vocabulary& dirty, Vocabulary& changed) {
+    Reduce(that);
+  }
+
   // project: project onto Vocabulary v. 
   virtual void Project         (const Vocabulary & v) = 0;
 
@@ -102,6 +129,33 @@ public:
 
   std::ostream & print(std::ostream & out) const;
 
+  // Serialize writes this value to out in a form that Deserialize can read back.
+  // Deserialize is called on a prototype value of the same domain and returns a new value.
+  // These are used to persist fixpoints across runs. Default implementation raises assertion.
+  virtual void Serialize(std::ostream & out) const;
+  virtual ref_ptr<AbstractValue> Deserialize(std::istream & in) const;
+
+  // Hash returns a hash of the structure of this value. Two values that are equal and have the same
+  // vocabulary must have the same hash. Used to hash-cons values. Default implementation only hashes
+  // the vocabulary.
+  virtual size_t Hash() const;
+
+  // StructurallyEqual returns true if that has the same vocabulary and the same representation as this
+  // value, so that each operation gives the same result on both. Unlike operator==, it does not hold for
+  // powersets of the same points made of different disjuncts. Used to hash-cons values, structurally equal
+  // values must have the same Hash. Default implementation returns false.
+  virtual bool StructurallyEqual(const AbstractValue& that) const;
+
+  // Used to keep the analysis within its resource budgets.
+  // NumConstraints returns the number of constraints used to represent this value.
+  // Coarsen overapproximates this value with at most max_disjuncts disjuncts, keeping only
+  // octagonal constraints if use_octagons is set. Default implementations do nothing.
+  virtual size_t NumConstraints() const {
+    return 0;
+  }
+  virtual void Coarsen(unsigned max_disjuncts, bool use_octagons) {
+  }
+
   /************** Interface used by Wrapped Domain LLVM reinterpretation layer ****************************/
   // Default implementation doesn't do anything
   // If your class intends to use BitpreciseWrappedAbstractValue to get correct
@@ -114,6 +168,54 @@ public:
   // This function AddConstraint is used also by llvm_reinterpretation layer
   virtual void AddConstraint(affexp_type lhs, affexp_type rhs, OpType op) = 0;
 
+  // Add all the constraints in cs. The default implementation adds them one at a time, it should be
+  // overloaded when each addition is costly (such as the closure of an octagon)
+  virtual void AddConstraints(const std::vector<constraint_type>& cs) {
+    for(std::vector<constraint_type>::const_iterator it = cs.begin(); it != cs.end(); it++) {
+      AddConstraint(it->first.first, it->first.second, it->second);
+    }
+  }
+
+  // Assign k := e in place, e may refer to k. The default implementation goes through a temporary
+  // dimension, it should be overloaded when the domain can update its constraints directly.
+  virtual void AssignAffine(const DimensionKey& k, const affexp_type& e) {
+    DimensionKey temp(k.name + "__assign", k.ver, k.bitsize);
+    AddDimension(temp);
+    linexp_type temp_le; temp_le.insert(linexp_type::value_type(temp, mpz_class(1)));
+    AddConstraint(affexp_type(temp_le, mpz_class(0)), e, EQ);
+    RemoveDimension(k);
+    AddDimension(k);
+    AddEquality(k, temp);
+    RemoveDimension(temp);
+  }
+
+  // Assign all the k := e of as at once, every e refers to the values before the assignments. The default
+  // implementation goes through a temporary dimension for each k, and adds their constraints in two batches.
+  virtual void AssignAffineParallel(const std::vector<assignment_type>& as) {
+    if(as.size() == 1) {
+      AssignAffine(as.front().first, as.front().second);
+      return;
+    }
+    std::vector<constraint_type> temp_cs, cs;
+    for(std::vector<assignment_type>::const_iterator it = as.begin(); it != as.end(); it++) {
+      DimensionKey temp(it->first.name + "__assign", it->first.ver, it->first.bitsize);
+      AddDimension(temp);
+      linexp_type temp_le; temp_le.insert(linexp_type::value_type(temp, mpz_class(1)));
+      temp_cs.push_back(constraint_type(std::make_pair(affexp_type(temp_le, mpz_class(0)), it->second), EQ));
+      linexp_type k_le; k_le.insert(linexp_type::value_type(it->first, mpz_class(1)));
+      cs.push_back(constraint_type(std::make_pair(affexp_type(k_le, mpz_class(0)), affexp_type(temp_le, mpz_class(0))), EQ));
+    }
+    AddConstraints(temp_cs);
+    for(std::vector<assignment_type>::const_iterator it = as.begin(); it != as.end(); it++) {
+      RemoveDimension(it->first);
+      AddDimension(it->first);
+    }
+    AddConstraints(cs);
+    for(std::vector<assignment_type>::const_iterator it = as.begin(); it != as.end(); it++) {
+      RemoveDimension(DimensionKey(it->first.name + "__assign", it->first.ver, it->first.bitsize));
+    }
+  }
+
   // This is equivalent to (lhs op 0)
   void AddConstraintNorhs(affexp_type lhs, OpType op) {
     affexp_type zero_affexp(linexp_type(), mpz_class(0));
@@ -127,6 +229,33 @@ public:
     return false;
   }
 
+  // Get the bounds of each dimension of the vocabulary in im, returns false if this is bottom.
+  // The default implementation projects on each dimension and only finds the constant ones, it should
+  // be overloaded when the domain can get all the bounds at once.
+  virtual bool GetIntervals(interval_map_type& im) const {
+    if(IsBottom())
+      return false;
+    for(Vocabulary::const_iterator it = voc_.begin(); it != voc_.end(); it++) {
+      ref_ptr<AbstractValue> av_k = Copy();
+      Vocabulary voc_k; voc_k.insert(*it);
+      av_k->Project(voc_k);
+      DimensionInterval itv;
+      mpz_class c;
+      if(av_k->IsConstant(c)) {
+        itv.has_lb = itv.has_ub = true;
+        itv.lb = itv.ub = c;
+      }
+      im.insert(interval_map_type::value_type(*it, itv));
+    }
+    return true;
+  }
+
+  // Get the affine equalities that hold in this value in eqs, returns false if the domain does not keep them.
+  // It is used to reduce a value with the equalities of another component of a reduced product.
+  virtual bool GetEqualities(std::vector<constraint_type>& eqs) const {
+    return false;
+  }
+
   // Default implementation returns all the vocabulary
   // This is an overapproximation.
   // TODO: Change it to use quadratic number of havoc calls to determine
@@ -5,6 +5,14 @@
 
 using namespace abstract_domain;
 AvSemiringStats AvSemiring::av_semiring_stats_;
+void (*AvSemiring::combine_hook_)() = NULL;
+size_t AvSemiring::max_constraints_ = 0;
+bool AvSemiring::coarsen_all_ = false;
+std::map<std::string, unsigned> AvSemiring::disjunct_limits_;
+unsigned AvSemiring::default_disjunct_limit_ = 0;
+unsigned (*AvSemiring::max_disjuncts_hook_)(unsigned) = NULL;
+unsigned AvSemiring::widening_delay_ = 0;
+std::map<std::string, unsigned> AvSemiring::widening_counts_;
 
 AvSemiring::AvSemiring(ref_ptr<AbstractValue> av, std::string from, std::string to, WideningType t, bool is_one)
   : av_(av), from_ (from), to_(to), t_ (t), is_one_(is_one)  { 
@@ -23,6 +31,9 @@ AvSemiring::~AvSemiring() {
 //        Widening Weight | Regular (call widen) | Regular (call widen)
 sem_elem_t AvSemiring::combine(SemElem * op2_sem) {
   utils::Timer timer("\nCombineTimer", std::cout, false);
+  if(combine_hook_ != NULL)
+    combine_hook_();
+
   if(op2_sem == this)
     return this;
 
@@ -68,11 +79,27 @@ sem_elem_t AvSemiring::combine(SemElem * op2_sem) {
     op2_cp->SetToSyntacticOne();
   }
 
+  // Only the widening points may hold more disjuncts than the domain allows
+  bool at_widening_point = ((t_ == WIDENING_WEIGHT) || (op2->t_ == WIDENING_WEIGHT));
+  unsigned prev_max_disjuncts = 0;
+  bool raise_max_disjuncts = (at_widening_point && max_disjuncts_hook_ != NULL && default_disjunct_limit_ != 0);
+  if(raise_max_disjuncts)
+    prev_max_disjuncts = max_disjuncts_hook_(GetDisjunctLimit(result->to_));
+
   result->av_->Join(op2_cp->av_);
   av_semiring_stats_.num_join_calls_++;
   av_semiring_stats_.time_join_+=timer.elapsed();
+  EnforceDisjunctLimit(result->av_, result->to_);
+  EnforceBudget(result->av_);
+
+  bool widen = at_widening_point;
+  if(widen && widening_delay_ != 0) {
+    unsigned& widening_count = widening_counts_[result->to_];
+    widening_count++;
+    widen = (widening_count > widening_delay_);
+  }
 
-  if((t_ == WIDENING_WEIGHT) || (op2->t_ == WIDENING_WEIGHT)) {
+  if(widen) {
     // If either is widening weight then combine is not enough
     // Widen needs to be called as well
     DEBUG_PRINTING(DBG_PRINT_OPERATIONS, std::cout << "\nPerforming Widen.";);
@@ -81,6 +108,9 @@ sem_elem_t AvSemiring::combine(SemElem * op2_sem) {
     av_semiring_stats_.time_widen_+=timer.elapsed();
   }
 
+  if(raise_max_disjuncts)
+    max_disjuncts_hook_(prev_max_disjuncts);
+
   DEBUG_PRINTING(DBG_PRINT_OPERATIONS, result->print(std::cout << "\nresult:") << std::endl;);
   return result.get_ptr();
 }
@@ -158,6 +188,8 @@ sem_elem_t AvSemiring::extend(SemElem * op2_se) {
     result_av = _3_voc_this_av;
   }
 
+  EnforceBudget(result_av);
+
   assert((t_ != WIDENING_RULE) && (op2->t_ != WIDENING_WEIGHT));
   WideningType ret_t = WIDENING_WEIGHT;
   if(t_ == REGULAR_WEIGHT && op2->t_ == REGULAR_WEIGHT)
@@ -171,6 +203,38 @@ sem_elem_t AvSemiring::extend(SemElem * op2_se) {
   return result;
 }
 
+// Coarsening is applied before widening in combine, so that widening still sees the
+// previous weight and the iteration sequence stabilizes.
+void AvSemiring::EnforceBudget(ref_ptr<AbstractValue>& av) {
+  if(!coarsen_all_ && (max_constraints_ == 0 || av->NumConstraints() <= max_constraints_))
+    return;
+
+  utils::Timer timer("\nCoarsenTimer", std::cout, false);
+  av_semiring_stats_.num_coarsen_calls_++;
+  if(coarsen_all_) {
+    av->Coarsen(1, true/*use_octagons*/);
+  } else {
+    av->Coarsen(1, false/*use_octagons*/);
+    if(av->NumConstraints() > max_constraints_)
+      av->Coarsen(1, true/*use_octagons*/);
+  }
+  av_semiring_stats_.time_coarsen_+=timer.elapsed();
+}
+
+unsigned AvSemiring::GetDisjunctLimit(const std::string& to) {
+  std::map<std::string, unsigned>::const_iterator it = disjunct_limits_.find(to);
+  if(it != disjunct_limits_.end())
+    return it->second;
+  return default_disjunct_limit_;
+}
+
+void AvSemiring::EnforceDisjunctLimit(ref_ptr<AbstractValue>& av, const std::string& to) {
+  if(default_disjunct_limit_ == 0)
+    return;
+
+  av->Coarsen(GetDisjunctLimit(to), false/*use_octagons*/);
+}
+
 // Default implementation just returns one
 sem_elem_t AvSemiring::quasi_one() const {
   return one();
@@ -209,6 +273,14 @@ bool AvSemiring::isEqual(SemElem* op2) const {
   if(!is_one_ && op2_av->is_one_)
     return false;
 
+  // Rule weights share their abstract values when they are equal
+  if(av_.get_ptr() == op2_av->av_.get_ptr()) {
+    DEBUG_PRINTING(DBG_PRINT_DETAILS, 
+                   std::cout << "\nAbstract values are same, returning true.";
+                   std::cout << "\nequality result:1\n";);
+    return true;
+  }
+
   bool result = (av_->Equal(op2_av->av_));
   DEBUG_PRINTING(DBG_PRINT_OPERATIONS, std::cout << "\nequality result:" << result << "\n";);
 
@@ -255,6 +327,41 @@ std::ostream & AvSemiring::print(std::ostream &out) const {
   return out;
 }
 
+void AvSemiring::Serialize(std::ostream &out) const {
+  SerializeString(out, from_);
+  SerializeString(out, to_);
+  out << (unsigned)t_ << " " << is_one_ << " ";
+  av_->Serialize(out);
+}
+
+ref_ptr<AvSemiring> AvSemiring::Deserialize(std::istream &in) const {
+  std::string from = DeserializeString(in);
+  std::string to = DeserializeString(in);
+  unsigned t;
+  bool is_one;
+  in >> t >> is_one;
+  ref_ptr<AbstractValue> av = av_->Deserialize(in);
+  return new AvSemiring(av, from, to, (WideningType)t, is_one);
+}
+
+void AvSemiring::SerializeWideningCounts(std::ostream &out) {
+  out << widening_counts_.size() << "\n";
+  for(std::map<std::string, unsigned>::const_iterator it = widening_counts_.begin(); it != widening_counts_.end(); it++) {
+    SerializeString(out, it->first);
+    out << it->second << "\n";
+  }
+}
+
+void AvSemiring::DeserializeWideningCounts(std::istream &in) {
+  widening_counts_.clear();
+  size_t num_counts = 0;
+  in >> num_counts;
+  for(size_t i = 0; i < num_counts; i++) {
+    std::string to = DeserializeString(in);
+    in >> widening_counts_[to];
+  }
+}
+
 void AvSemiring::setFrom(std::string from) {
   from_ = from;
 }
@@ -267,6 +374,10 @@ void AvSemiring::setWideningType(WideningType t) {
   t_ = t;
 }
 
+WideningType AvSemiring::getWideningType() const {
+  return t_;
+}
+
 //Ensure that this function is called only once
 sem_elem_t AvSemiring::one() const {
   // Set is_one_ to true
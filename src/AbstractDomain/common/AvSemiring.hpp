@@ -31,6 +31,7 @@ public:
     WIDEN,
     EXTEND,
     IS_EQUAL,
+    COARSEN,
     NONE
   };
 
@@ -46,11 +47,13 @@ public:
     num_widen_calls_ = 0;
     num_extend_calls_ = 0;
     num_equal_calls_ = 0;
+    num_coarsen_calls_ = 0;
 
     time_join_ = 0;
     time_widen_ = 0;
     time_extend_ = 0;
     time_equal_ = 0;
+    time_coarsen_ = 0;
   }
 
   // Used to print in stats file readable by SCons scripts in tools/tests, which uses it for reporting
@@ -63,6 +66,8 @@ public:
     out << std::dec << "time_extend_=" << time_extend_ << std::endl;
     out << std::dec << "Num_equal_calls_=" << num_equal_calls_ << std::endl;
     out << std::dec << "time_equal_=" << time_equal_ << std::endl;
+    out << std::dec << "Num_coarsen_calls_=" << num_coarsen_calls_ << std::endl;
+    out << std::dec << "time_coarsen_=" << time_coarsen_ << std::endl;
     return out;
   }
 
@@ -71,11 +76,13 @@ public:
   unsigned num_widen_calls_;
   unsigned num_extend_calls_;
   unsigned num_equal_calls_;
+  unsigned num_coarsen_calls_;
 
   double time_join_;
   double time_widen_;
   double time_extend_;
   double time_equal_;
+  double time_coarsen_;
 };
 
 // TODO: Have Value as an Abstract class proving normal
@@ -87,6 +94,36 @@ public:
   // Statistics in AvQfbvSemiring for debugging purposes
   static AvSemiringStats av_semiring_stats_;
 
+  // Hook called on each combine, if set. Clients use it to check global budgets during
+  // long running solvers such as post*. The hook must not call combine itself.
+  static void (*combine_hook_)();
+
+  // Budget on the weights computed by combine and extend (ie. during post*).
+  // A weight with more than max_constraints_ constraints (0 means no limit) is coarsened to a single
+  // disjunct, and then to octagonal constraints if that is not enough. Once coarsen_all_ is set 
+  // (eg. when a global budget is exceeded), every weight is coarsened to octagonal constraints.
+  static size_t max_constraints_;
+  static bool coarsen_all_;
+
+  // Adaptive disjunct limits. The result of a combine is merged down to the limit of the program point
+  // it flows to (ie. its to_ key), or to default_disjunct_limit_ if the point has no limit of its own.
+  // A default of 0 disables the adaptive limits. The limits cannot exceed the max_disjunctions of the domain,
+  // except at the widening points: if max_disjuncts_hook_ is set, a combine that widens raises the
+  // max_disjunctions of the domain to the limit of its point for the join and the widen, by calling
+  // max_disjuncts_hook_ with the limit, and restores it afterwards. The hook returns the previous value.
+  static std::map<std::string, unsigned> disjunct_limits_;
+  static unsigned default_disjunct_limit_;
+  static unsigned (*max_disjuncts_hook_)(unsigned);
+
+  // Delayed widening. The first widening_delay_ combines that would widen at a program point (ie. the to_
+  // key of the result) only join, widening_counts_ counts them. A delay of 0 widens right away.
+  // The counts are part of the state of a solver, SerializeWideningCounts saves them with a checkpoint
+  // and DeserializeWideningCounts restores them when resuming from it.
+  static unsigned widening_delay_;
+  static std::map<std::string, unsigned> widening_counts_;
+  static void SerializeWideningCounts(std::ostream &out);
+  static void DeserializeWideningCounts(std::istream &in);
+
   AvSemiring(ref_ptr<AbstractValue> av, std::string from = "", std::string to = "", WideningType = REGULAR_WEIGHT, bool is_one = false);
   AvSemiring(const AvSemiring& a);
   virtual ~AvSemiring();
@@ -112,11 +149,24 @@ public:
   virtual void prettyPrint(FILE *fp, unsigned nTabs = 0);
   std::ostream & print(std::ostream &out) const;
 
+  // Used to persist weights across runs. Deserialize is called on a prototype weight
+  // whose abstract value is of the same domain as the serialized one.
+  void Serialize(std::ostream &out) const;
+  ref_ptr<AvSemiring> Deserialize(std::istream &in) const;
+
   void setFrom(std::string from);
   void setTo(std::string to);
   void setWideningType(WideningType t);
+  WideningType getWideningType() const;
 
 protected:
+  // Coarsen av in place if it exceeds the budget
+  static void EnforceBudget(ref_ptr<AbstractValue>& av);
+
+  // Merge av down to the disjunct limit of the program point to
+  static unsigned GetDisjunctLimit(const std::string& to);
+  static void EnforceDisjunctLimit(ref_ptr<AbstractValue>& av, const std::string& to);
+
   // Data Members
   ref_ptr<AbstractValue> av_;
   std::string from_, to_;
@@ -4,6 +4,21 @@ namespace abstract_domain {
 
   bool BitpreciseWrappedAbstractValue::lazy_wrapping = true;
   bool BitpreciseWrappedAbstractValue::disable_wrapping = false;
+  Vocabulary BitpreciseWrappedAbstractValue::no_wrap_signed_voc;
+  Vocabulary BitpreciseWrappedAbstractValue::no_wrap_unsigned_voc;
+  BitpreciseWrappedAbstractValue::VocabularySignedness BitpreciseWrappedAbstractValue::inferred_signedness;
+  std::map<std::pair<utils::Bitsize, bool>, std::pair<mpz_class, mpz_class> > BitpreciseWrappedAbstractValue::bounds_;
+
+  const std::pair<mpz_class, mpz_class>& BitpreciseWrappedAbstractValue::GetBounds(utils::Bitsize b, bool is_signed) {
+    std::pair<utils::Bitsize, bool> b_sign = std::make_pair(b, is_signed);
+    std::map<std::pair<utils::Bitsize, bool>, std::pair<mpz_class, mpz_class> >::const_iterator it = bounds_.find(b_sign);
+    if(it == bounds_.end()) {
+      mpz_class min_mpz = utils::convert_to_mpz(utils::GetMinInt(b, is_signed), is_signed);
+      mpz_class max_mpz = utils::convert_to_mpz(utils::GetMaxInt(b, is_signed), is_signed);
+      it = bounds_.insert(std::make_pair(b_sign, std::make_pair(min_mpz, max_mpz))).first;
+    }
+    return it->second;
+  }
 
   std::pair<std::pair<BitpreciseWrappedAbstractValue::affexp_type, 
                       BitpreciseWrappedAbstractValue::affexp_type>, 
@@ -14,7 +29,7 @@ namespace abstract_domain {
     utils::Bitsize b = k.bitsize;
 
     linexp_type k_le; k_le.insert(linexp_type::value_type(k, one_mpz)); // Creates expr 1.k
-    mpz_class min_mpz = utils::convert_to_mpz(utils::GetMinInt(b, is_signed), is_signed);
+    const mpz_class& min_mpz = GetBounds(b, is_signed).first;
 
     // 1.k >= min_mpz
     return std::make_pair(std::make_pair(affexp_type(k_le, zero_mpz), affexp_type(linexp_type(), min_mpz)), GE); 
@@ -28,7 +43,7 @@ namespace abstract_domain {
     utils::Bitsize b = k.GetBitsize();
 
     linexp_type k_le; k_le.insert(linexp_type::value_type(k, one_mpz)); // Creates expr 1.k
-    mpz_class max_mpz = utils::convert_to_mpz(GetMaxInt(b, is_signed), is_signed);
+    const mpz_class& max_mpz = GetBounds(b, is_signed).second;
 
     // 1.k <= max_mpz
     return std::make_pair(std::make_pair(affexp_type(k_le, zero_mpz), affexp_type(linexp_type(), max_mpz)), LE);
@@ -44,21 +59,49 @@ namespace abstract_domain {
     }
     AddVocabulary(voc);
 
+    // The constraints are added in one batch, so that the abstract value is updated only once
+    std::vector<constraint_type> constrs;
     for(VocabularySignedness::const_iterator it = vs.begin(); it != vs.end(); it++) {
       DimensionKey k = it->first;
       bool is_signed = it->second;
       if(!disable_wrapping) {
-        
-        std::pair<std::pair<affexp_type, affexp_type>, OpType> min_constr = GetMinBoundingConstraint(k, is_signed); 
-        std::pair<std::pair<affexp_type, affexp_type>, OpType> max_constr = GetMaxBoundingConstraint(k, is_signed); 
-
-        AddConstraint(min_constr.first.first, min_constr.first.second, min_constr.second);
-        AddConstraint(max_constr.first.first, max_constr.first.second, max_constr.second);
+        constrs.push_back(GetMinBoundingConstraint(k, is_signed));
+        constrs.push_back(GetMaxBoundingConstraint(k, is_signed));
       }
-      wrapped_voc_[k] = is_signed;
+    }
+    if(!constrs.empty())
+      AddConstraints(constrs);
+
+    for(VocabularySignedness::const_iterator it = vs.begin(); it != vs.end(); it++) {
+      wrapped_voc_[it->first] = it->second;
     }
   }
 
+  void BitpreciseWrappedAbstractValue::Serialize(std::ostream & out) const {
+    out << wrapped_voc_.size() << " ";
+    for(VocabularySignedness::const_iterator it = wrapped_voc_.begin(); it != wrapped_voc_.end(); it++) {
+      SerializeDimensionKey(out, it->first);
+      out << it->second << " ";
+    }
+    av_->Serialize(out);
+  }
+
+  ref_ptr<AbstractValue> BitpreciseWrappedAbstractValue::Deserialize(std::istream & in) const {
+    size_t size = 0;
+    in >> size;
+    VocabularySignedness wrapped_voc;
+    for(size_t i = 0; i < size; i++) {
+      DimensionKey k = DeserializeDimensionKey(in);
+      bool is_signed;
+      in >> is_signed;
+      wrapped_voc.insert(VocabularySignedness::value_type(k, is_signed));
+    }
+    // The bounding constraints for wrapped_voc are already part of the serialized av
+    AbsValRefPtr av = av_->Deserialize(in);
+    ref_ptr<BitpreciseWrappedAbstractValue> ret = new BitpreciseWrappedAbstractValue(av, wrapped_voc, false/*dummy param to avoid copy*/);
+    return ret.get_ptr();
+  }
+
   void BitpreciseWrappedAbstractValue::UpdateVocabularySignedness(Vocabulary voc) {
     ref_ptr<AbstractValue> av_cp = av_->Copy();
     for(Vocabulary::const_iterator it = voc.begin(), end = voc.end(); it != end; it++) {
@@ -68,11 +111,23 @@ namespace abstract_domain {
         // First check if this vocabulary is bounded by signed boundary variables
         bool is_signed = true;
         bool is_signed_orig = is_signed;
+        DimensionInterval itv;
+        bool has_itv = GetInterval(k, itv);
         do {
+          // The bounding constraints can only be implied when the interval of k is in range, so the copy
+          // and the comparison are skipped for the dimensions out of range. The intervals of a domain that
+          // are not tight only lose this precision.
+          const std::pair<mpz_class, mpz_class>& bounds = GetBounds(k.GetBitsize(), is_signed);
+          if(has_itv && (!itv.has_lb || !itv.has_ub || itv.lb < bounds.first || itv.ub > bounds.second)) {
+            is_signed = !is_signed;
+            continue;
+          }
           std::pair<std::pair<affexp_type, affexp_type>, OpType> min_cnstr = GetMinBoundingConstraint(k, is_signed); 
           std::pair<std::pair<affexp_type, affexp_type>, OpType> max_cnstr = GetMaxBoundingConstraint(k, is_signed); 
-          av_cp->AddConstraint(min_cnstr.first.first, min_cnstr.first.second, min_cnstr.second);
-          av_cp->AddConstraint(max_cnstr.first.first, max_cnstr.first.second, max_cnstr.second);
+          std::vector<constraint_type> bounding_cs;
+          bounding_cs.push_back(min_cnstr);
+          bounding_cs.push_back(max_cnstr);
+          av_cp->AddConstraints(bounding_cs);
 
           if(*av_cp == *av_) {
             wrapped_voc_.insert(std::make_pair(k, is_signed));
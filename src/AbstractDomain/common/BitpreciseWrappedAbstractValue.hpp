@@ -1,6 +1,7 @@
 #ifndef src_AbstractDomain_common_BitpreciseWrappedAbstractValue_hpp
 #define src_AbstractDomain_common_BitpreciseWrappedAbstractValue_hpp
 
+#include <sstream>
 #include "AbstractValue.hpp"
 #include "utils/timer/timer.hpp"
 #include "utils/debug/DebugOptions.hpp"
@@ -41,9 +42,20 @@ public:
   // becomes nop
   static bool disable_wrapping;
 
+  // Dimensions, by their pre-vocabulary key, whose values are known to stay in the signed (resp. unsigned)
+  // range of their bitsize, as computed by IntervalPreAnalysis. Wrapping these dimensions with the
+  // same signedness only adds the bounding constraints.
+  static Vocabulary no_wrap_signed_voc;
+  static Vocabulary no_wrap_unsigned_voc;
+
+  // Signedness of the dimensions, by their pre-vocabulary key, inferred from the uses of the program values
+  // by SignednessInference. It is used when either signedness is correct, to pick the one the dimensions
+  // will be wrapped with anyway.
+  static VocabularySignedness inferred_signedness;
+
   // Constructor
   BitpreciseWrappedAbstractValue (const AbsValRefPtr &a, const VocabularySignedness &voc_to_wrap) 
-    : BaseClass(a->GetVocabulary()) {
+    : BaseClass(a->GetVocabulary()), intervals_valid_(false) {
     av_ = a->Copy();
     VocabularySignedness correct_voc_to_wrap = voc_to_wrap;
     // TODO: Enable choice to perform eager wrapping
@@ -51,7 +63,8 @@ public:
   }
 
   BitpreciseWrappedAbstractValue (const BitpreciseWrappedAbstractValue &wav) 
-    : BaseClass(wav.GetVocabulary()), av_(wav.av_->Copy()), wrapped_voc_(wav.wrapped_voc_) {
+    : BaseClass(wav.GetVocabulary()), av_(wav.av_->Copy()), wrapped_voc_(wav.wrapped_voc_),
+      intervals_valid_(wav.intervals_valid_), intervals_bottom_(wav.intervals_bottom_), intervals_(wav.intervals_) {
   }
 
   virtual AbsValRefPtr Copy() const {
@@ -77,7 +90,41 @@ public:
     return true;
   }
 
+  // Get the bounds of k in itv, returns false if this is bottom.
+  // The bounds of all the dimensions are computed by a single call to GetIntervals, and cached until
+  // this value is changed.
+  bool GetInterval(const DimensionKey& k, DimensionInterval& itv) const {
+    ComputeIntervals();
+    if(intervals_bottom_)
+      return false;
+    interval_map_type::const_iterator it = intervals_.find(k);
+    assert(it != intervals_.end());
+    itv = it->second;
+    return true;
+  }
+
+  virtual bool GetIntervals(interval_map_type& im) const {
+    ComputeIntervals();
+    if(intervals_bottom_)
+      return false;
+    im = intervals_;
+    return true;
+  }
+
 private:
+  void ComputeIntervals() const {
+    if(intervals_valid_)
+      return;
+    intervals_.clear();
+    intervals_bottom_ = !av_->GetIntervals(intervals_);
+    intervals_valid_ = true;
+  }
+
+  // Has to be called by every operation that changes av_
+  void InvalidateIntervals() {
+    intervals_valid_ = false;
+  }
+
   void MarkWrapped(DimensionKey k, bool signedness) {
     wrapped_voc_.insert(VocabularySignedness::value_type(k, signedness));
   }
@@ -126,6 +173,32 @@ public:
     return ss.str();
   }
 
+  virtual void Serialize(std::ostream & out) const;
+  virtual AbsValRefPtr Deserialize(std::istream & in) const;
+
+  virtual size_t Hash() const {
+    size_t h = av_->Hash();
+    for(VocabularySignedness::const_iterator it = wrapped_voc_.begin(); it != wrapped_voc_.end(); it++) {
+      h = HashCombine(h, HashCombine(HashDimensionKey(it->first), it->second));
+    }
+    return h;
+  }
+
+  virtual bool StructurallyEqual(const BaseClass& that) const {
+    const BitpreciseWrappedAbstractValue *that_wav = downcast(that);
+    return wrapped_voc_ == that_wav->wrapped_voc_ && av_->StructurallyEqual(*that_wav->av_);
+  }
+
+  virtual size_t NumConstraints() const {
+    return av_->NumConstraints();
+  }
+
+  // Coarsening only loses relations, the bounds of wrapped dimensions are kept
+  virtual void Coarsen(unsigned max_disjuncts, bool use_octagons) {
+    InvalidateIntervals();
+    av_->Coarsen(max_disjuncts, use_octagons);
+  }
+
   virtual bool operator== (const BaseClass& that) const {
     const BitpreciseWrappedAbstractValue *that_wav = downcast(that);
     if(wrapped_voc() == that_wav->wrapped_voc()) {
@@ -171,6 +244,7 @@ public:
   }
 
   virtual void Join(const AbsValRefPtr & other) {
+    InvalidateIntervals();
     const BitpreciseWrappedAbstractValue *wav = downcast(other);
 
     av_->Join(wav->av());
@@ -179,6 +253,7 @@ public:
   }
 
   virtual void JoinSingleton(const AbsValRefPtr & other) {
+    InvalidateIntervals();
     const BitpreciseWrappedAbstractValue *wav = downcast(other);
     av_->JoinSingleton(wav->av());
     wrapped_voc_ = IntersectVocabularySignedness(wrapped_voc_, wav->wrapped_voc_);
@@ -186,6 +261,7 @@ public:
   }
 
   virtual void Widen(const AbsValRefPtr & other) {
+    InvalidateIntervals();
     const BitpreciseWrappedAbstractValue *wav = downcast(other);
     av_->Widen(wav->av());
     wrapped_voc_ = IntersectVocabularySignedness(wrapped_voc_, wav->wrapped_voc_);
@@ -198,6 +274,7 @@ public:
   }
 
   virtual void Meet(const AbsValRefPtr &that) {
+    InvalidateIntervals();
     const BitpreciseWrappedAbstractValue *that_wav = downcast(that);
 
     // If the wrapped vocabulary are equal, then no need to make a copies
@@ -295,6 +372,7 @@ public:
 
   // Add equality constraint
   virtual void AddEquality(const DimensionKey& v1, const DimensionKey& v2) {
+    InvalidateIntervals();
     av_->AddEquality(v1, v2);
     VocabularySignedness::const_iterator it = wrapped_voc_.find(v1);
     if(it != wrapped_voc_.end()) {
@@ -309,6 +387,7 @@ public:
 
   //In - place reduction
   virtual void Reduce() {
+    InvalidateIntervals();
     av_->Reduce();
   }
 
@@ -320,6 +399,7 @@ public:
 
   // project: project onto Vocabulary v.
   virtual void Project(const Vocabulary &v) {
+    InvalidateIntervals();
     av_->Project(v);
     Vocabulary rem_v;
     SubtractVocabularies(this->voc_, v, rem_v);
@@ -338,11 +418,13 @@ public:
   // In - place Vocabulary manipulation operations
   // on AbstractValue
   virtual void AddVocabulary(const Vocabulary& v) {
+    InvalidateIntervals();
     av_->AddVocabulary(v);
     this->voc_ = av_->GetVocabulary();
   }
 
   virtual void ReplaceVersions(const std::map<Version, Version>& vm) {
+    InvalidateIntervals();
     VocabularySignedness new_wrapped_voc;
     for(VocabularySignedness::const_iterator voc_it = wrapped_voc_.begin(); voc_it != wrapped_voc_.end(); voc_it++) {
       DimensionKey new_k = replaceVersions(voc_it->first, vm);
@@ -366,11 +448,13 @@ public:
   }
 
   virtual void Wrap(const VocabularySignedness& v_cons) {
+    InvalidateIntervals();
     DEBUG_PRINTING(DBG_PRINT_MORE_DETAILS,
                    print(std::cout << "\nIn wrap:\nthis:");
                    printVocabularySignedness(std::cout << "\nv_cons:", v_cons););
    
     VocabularySignedness v = v_cons;
+    Vocabulary sign_changed_voc;
     for(VocabularySignedness::iterator vit = v.begin(); vit != v.end(); ) {
       VocabularySignedness::iterator wv_it = wrapped_voc_.find(vit->first);
       if(wv_it == wrapped_voc_.end()) {
@@ -382,21 +466,48 @@ public:
         } else {
           // Sign is different so adjust the sign for wv_it accordingly
           wv_it->second = vit->second;
+          sign_changed_voc.insert(vit->first);
           vit++;
         }
       }
     }
-    if(!disable_wrapping)
+    // The value of a dimension wrapped with the other sign is held in the range of that sign, it has to be
+    // wrapped even if the pre-analysis found it to stay in the range of the new sign
+    VocabularySignedness v_no_wrap;
+    for(VocabularySignedness::iterator vit = v.begin(); vit != v.end(); ) {
+      if(sign_changed_voc.find(vit->first) == sign_changed_voc.end() && IsNoWrap(vit->first, vit->second)) {
+        v_no_wrap.insert(*vit);
+        v.erase(vit++);
+      } else {
+        vit++;
+      }
+    }
+    if(!disable_wrapping) {
       av_->Wrap(v);
+      AddBoundingConstraints(v_no_wrap);
+    }
 
     DEBUG_PRINTING(DBG_PRINT_MORE_DETAILS, print(std::cout << "\nReturning from wrap:\nthis:"););
   }
 
+  // Wrap each dimension of v in one batch, with its inferred signedness (see inferred_signedness) or
+  // signed if it has none. The later uses wrapping with the same signedness then leave the value unchanged.
+  void WrapWithInferredSignedness(const Vocabulary& v) {
+    VocabularySignedness vs;
+    for(Vocabulary::const_iterator it = v.begin(); it != v.end(); it++) {
+      bool is_signed = true;
+      GetInferredSignedness(*it, is_signed);
+      vs.insert(std::make_pair(*it, is_signed));
+    }
+    Wrap(vs);
+  }
+
   virtual bool IsConstant(mpz_class& val) const {
     return av_->IsConstant(val);
   }
 
   virtual void AddConstraint(affexp_type lhs, affexp_type rhs, OpType op) {
+    InvalidateIntervals();
     av_->AddConstraint(lhs, rhs, op);
 
     Vocabulary cnstr_voc;
@@ -409,6 +520,58 @@ public:
     UpdateVocabularySignedness(cnstr_voc);
   }
 
+  virtual void AddConstraints(const std::vector<constraint_type>& cs) {
+    InvalidateIntervals();
+    av_->AddConstraints(cs);
+
+    Vocabulary cnstr_voc;
+    for(std::vector<constraint_type>::const_iterator cit = cs.begin(); cit != cs.end(); cit++) {
+      for(linexp_type::const_iterator it = cit->first.first.first.begin(), end = cit->first.first.first.end(); it != end; it++) {
+        cnstr_voc.insert(it->first);
+      }
+      for(linexp_type::const_iterator it = cit->first.second.first.begin(), end = cit->first.second.first.end(); it != end; it++) {
+        cnstr_voc.insert(it->first);
+      }
+    }
+    UpdateVocabularySignedness(cnstr_voc);
+  }
+
+  // k is no longer known to be in range after the assignment, unless it is a copy of a dimension of the same
+  // bitsize that is in range
+  virtual void AssignAffine(const DimensionKey& k, const affexp_type& e) {
+    InvalidateIntervals();
+    bool is_copy_wrapped = false, copy_is_signed = false;
+    if(e.first.size() == 1 && e.second == 0 && e.first.begin()->second == 1) {
+      const DimensionKey& src = e.first.begin()->first;
+      is_copy_wrapped = (src.GetBitsize() == k.GetBitsize()) && IsWrapped(src, copy_is_signed);
+    }
+    av_->AssignAffine(k, e);
+    wrapped_voc_.erase(k);
+    if(is_copy_wrapped)
+      MarkWrapped(k, copy_is_signed);
+  }
+
+  // The wrapped copies are found before the assignments, as they refer to the values before the assignments
+  virtual void AssignAffineParallel(const std::vector<assignment_type>& as) {
+    InvalidateIntervals();
+    VocabularySignedness copies_wrapped;
+    for(std::vector<assignment_type>::const_iterator it = as.begin(); it != as.end(); it++) {
+      const affexp_type& e = it->second;
+      bool copy_is_signed;
+      if(e.first.size() == 1 && e.second == 0 && e.first.begin()->second == 1
+         && e.first.begin()->first.GetBitsize() == it->first.GetBitsize()
+         && IsWrapped(e.first.begin()->first, copy_is_signed))
+        copies_wrapped.insert(VocabularySignedness::value_type(it->first, copy_is_signed));
+    }
+    av_->AssignAffineParallel(as);
+    for(std::vector<assignment_type>::const_iterator it = as.begin(); it != as.end(); it++) {
+      wrapped_voc_.erase(it->first);
+    }
+    for(VocabularySignedness::const_iterator it = copies_wrapped.begin(); it != copies_wrapped.end(); it++) {
+      MarkWrapped(it->first, it->second);
+    }
+  }
+
   virtual Vocabulary GetDependentVocabulary(DimensionKey& k) const {
     return av_->GetDependentVocabulary(k);
   }
@@ -426,10 +589,15 @@ private:
   AbsValRefPtr av_;
   VocabularySignedness wrapped_voc_; // Keeps track of the vocabulary that are wrapped
 
+  // Cache of the bounds of the dimensions of av_, valid until av_ is changed
+  mutable bool intervals_valid_;
+  mutable bool intervals_bottom_;
+  mutable interval_map_type intervals_;
+
   // Private constructor that avoids copy and wrap operation on as. 
   // It should be used carefully, so that voc_to_wrap and a match in description
   BitpreciseWrappedAbstractValue (AbsValRefPtr &a, const VocabularySignedness& voc_to_wrap, bool dummy) 
-    : BaseClass(a->GetVocabulary()), av_(a), wrapped_voc_(voc_to_wrap) {
+    : BaseClass(a->GetVocabulary()), av_(a), wrapped_voc_(voc_to_wrap), intervals_valid_(false) {
   }
 
   BitpreciseWrappedAbstractValue *downcast( AbsValRefPtr &val) const {
@@ -452,14 +620,39 @@ private:
   // is_signed determines the sign of the operation
   virtual void AddBoundingConstraints(const VocabularySignedness& v);
 
+  // Returns true if the signedness of k is in inferred_signedness, and sets is_signed to it
+  static bool GetInferredSignedness(const DimensionKey& k, bool& is_signed) {
+    if(inferred_signedness.empty())
+      return false;
+    DimensionKey k0 = (k.ver == UNVERSIONED_VERSION) ? k : DimensionKey(k.name, 0, k.bitsize);
+    VocabularySignedness::const_iterator it = inferred_signedness.find(k0);
+    if(it == inferred_signedness.end())
+      return false;
+    is_signed = it->second;
+    return true;
+  }
+
+  // Returns true if k is in no_wrap_signed_voc (resp. no_wrap_unsigned_voc) irrespective of its version
+  static bool IsNoWrap(const DimensionKey& k, bool is_signed) {
+    const Vocabulary& no_wrap_voc = is_signed ? no_wrap_signed_voc : no_wrap_unsigned_voc;
+    if(no_wrap_voc.empty() || k.ver == UNVERSIONED_VERSION)
+      return false;
+    return (no_wrap_voc.find(DimensionKey(k.name, 0, k.bitsize)) != no_wrap_voc.end());
+  }
+
   // Perform vanilla meet of the two values without worrying about bounding constraints
   // Warning: Blind use of these function might be unsound.
   virtual void VanillaMeet(const AbsValRefPtr &that) {
+    InvalidateIntervals();
     const BitpreciseWrappedAbstractValue *that_wav = downcast(that);
     av_->Meet(that_wav->av_);
     wrapped_voc_ = UnionVocabularySignedness(wrapped_voc(), that_wav->wrapped_voc());
   }
 
+  // The min and max values of each bitsize and signedness, computed once
+  static std::map<std::pair<utils::Bitsize, bool>, std::pair<mpz_class, mpz_class> > bounds_;
+  static const std::pair<mpz_class, mpz_class>& GetBounds(utils::Bitsize b, bool is_signed);
+
   std::pair<std::pair<affexp_type, affexp_type>, OpType> 
   GetMinBoundingConstraint(const DimensionKey& k, bool is_signed);
 
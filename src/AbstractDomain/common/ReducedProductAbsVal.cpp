@@ -0,0 +1,8 @@
+#include "src/AbstractDomain/common/ReducedProductAbsVal.hpp"
+
+namespace abstract_domain {
+
+  // By default, each reduction exchanges all the facts of both the components
+  unsigned ReducedProductAbsVal::reduction_rounds = 0;
+
+}
@@ -5,6 +5,7 @@
 
 #include <cassert>
 #include <map>
+#include <sstream>
 #include "src/AbstractDomain/common/dimension.hpp"
 
 // TODO: Have Value as an Abstract class proving normal
@@ -17,11 +18,16 @@ class ReducedProductAbsVal : public AbstractValue
 
 public:
 
+  // Parameter to control the number of rounds of the incremental reduction. With 0, each reduction
+  // exchanges all the facts of both the components.
+  static unsigned reduction_rounds;
+
   ReducedProductAbsVal (Vocabulary v) 
-  : BaseClass(v)  {  }
+  : BaseClass(v), all_dirty_(true)  {  }
 
   // Constructor
   ReducedProductAbsVal (const AbsValRefPtr &a1, const AbsValRefPtr &a2)
+  : all_dirty_(true)
   {
     first_  = a1->Copy();
     second_ = a2->Copy();
@@ -35,7 +41,10 @@ public:
 
   virtual AbsValRefPtr Copy() const 
   {
-    return new ReducedProductAbsVal(first_->Copy(), second_->Copy());
+    ReducedProductAbsVal* ret = new ReducedProductAbsVal(first_->Copy(), second_->Copy());
+    ret->all_dirty_ = all_dirty_;
+    ret->dirty_voc_ = dirty_voc_;
+    return ret;
   }
 
   AbsValRefPtr first() const
@@ -55,14 +64,19 @@ public:
 
   // Other ways to create AbstractValue elements
   // ====================================
+  // Top and bottom have nothing to reduce
   virtual AbsValRefPtr Top() const 
   {
-    return new ReducedProductAbsVal(first_->Top(), second_->Top());
+    ReducedProductAbsVal* ret = new ReducedProductAbsVal(first_->Top(), second_->Top());
+    ret->all_dirty_ = false;
+    return ret;
   }
 
   virtual AbsValRefPtr Bottom () const
   {
-    return new ReducedProductAbsVal(first_->Bottom(), second_->Bottom());
+    ReducedProductAbsVal* ret = new ReducedProductAbsVal(first_->Bottom(), second_->Bottom());
+    ret->all_dirty_ = false;
+    return ret;
   }
 
   virtual bool operator== (const BaseClass& other) const
@@ -88,6 +102,42 @@ public:
     return NULL;
   }
 
+  virtual void Serialize(std::ostream & out) const
+  {
+    first_->Serialize(out);
+    second_->Serialize(out);
+  }
+
+  virtual AbsValRefPtr Deserialize(std::istream & in) const
+  {
+    AbsValRefPtr first = first_->Deserialize(in);
+    AbsValRefPtr second = second_->Deserialize(in);
+    return new ReducedProductAbsVal(first, second);
+  }
+
+  virtual size_t Hash() const
+  {
+    return HashCombine(first_->Hash(), second_->Hash());
+  }
+
+  virtual bool StructurallyEqual(const BaseClass& other) const
+  {
+    const ReducedProductAbsVal *red_prd = downcast(other);
+    return first_->StructurallyEqual(*red_prd->first_) && second_->StructurallyEqual(*red_prd->second_);
+  }
+
+  virtual size_t NumConstraints() const
+  {
+    return first_->NumConstraints() + second_->NumConstraints();
+  }
+
+  virtual void Coarsen(unsigned max_disjuncts, bool use_octagons)
+  {
+    MarkAllDirty();
+    first_->Coarsen(max_disjuncts, use_octagons);
+    second_->Coarsen(max_disjuncts, use_octagons);
+  }
+
   // Abstract Domain operations
   virtual bool IsBottom() const
   {
@@ -103,6 +153,7 @@ public:
   virtual void Join(const AbsValRefPtr & other)
   {
     const ReducedProductAbsVal *red_prd = downcast(other);
+    MarkAllDirty();
     first_->Join(red_prd->first_);
     second_->Join(red_prd->second_);
   }
@@ -110,6 +161,7 @@ public:
   virtual void JoinSingleton(const AbsValRefPtr & other)
   {
     const ReducedProductAbsVal *red_prd = downcast(other);
+    MarkAllDirty();
     first_->JoinSingleton(red_prd->first_);
     second_->JoinSingleton(red_prd->second_);
   }
@@ -117,8 +169,10 @@ public:
   virtual void Meet(const AbsValRefPtr &other)
   {
     const ReducedProductAbsVal *red_prd = downcast(other);
+    MarkAllDirty();
     first_->Meet(red_prd->first_);
     second_->Meet(red_prd->second_);
+    // The callers reduce explicitly after a meet
     //Reduce();
   }
 
@@ -135,12 +189,18 @@ public:
   {
     first_->AddEquality(v1, v2);
     second_->AddEquality(v1, v2);
-    //Reduce();
+    MarkDirty(v1);
+    MarkDirty(v2);
+    // The incremental reduction only exchanges the facts connected to v1 and v2
+    if(reduction_rounds != 0)
+      Reduce();
   }
 
   // project: project onto Vocabulary v.
+  // The projection of the facts of one component can be stronger than what the other one keeps
   virtual void Project(const Vocabulary &v) 
   {
+    MarkAllDirty();
     first_ ->Project(v);
     second_->Project(v);
     UnionVocabularies (first_->GetVocabulary(), second_->GetVocabulary(), 
@@ -157,10 +217,27 @@ public:
   }
 
   //In - place reduction
+  // With reduction_rounds, only the facts connected to the dimensions changed since the last reduction
+  // are exchanged. The dimensions that change in a round are reduced in the next one, and the ones left
+  // after the last round stay dirty for the next reduction.
   virtual void Reduce()
   {
-    first_  ->Reduce(second_);
-    second_ ->Reduce(first_ );
+    if(reduction_rounds == 0) {
+      first_  ->Reduce(second_);
+      second_ ->Reduce(first_ );
+      return;
+    }
+
+    Vocabulary worklist = all_dirty_ ? BaseClass::voc_ : dirty_voc_;
+    for(unsigned round = 0; round < reduction_rounds && !worklist.empty(); round++) {
+      Vocabulary first_changed, second_changed;
+      first_ ->ReduceDimensions(second_, worklist, first_changed);
+      second_->ReduceDimensions(first_ , worklist, second_changed);
+      worklist.clear();
+      UnionVocabularies(first_changed, second_changed, worklist);
+    }
+    all_dirty_ = false;
+    dirty_voc_ = worklist;
   }
 
   // reduce this with constraints from that
@@ -168,6 +245,7 @@ public:
   {
     // Is that a ReducedProduct abstract value?
     const ReducedProductAbsVal * that_red_prd = static_cast<const ReducedProductAbsVal *>(that.get_ptr());
+    MarkAllDirty();
     if (that_red_prd != NULL) {
       // Call Reduce on each component of "that"
       this->Reduce (that_red_prd->first_);
@@ -198,6 +276,7 @@ public:
   {
     first_ ->ReplaceVersions(vm);
     second_->ReplaceVersions(vm);
+    dirty_voc_ = replaceVersions(dirty_voc_, vm);
     UnionVocabularies (first_->GetVocabulary(), second_->GetVocabulary(), 
 		                 BaseClass::voc_);
   }
@@ -214,6 +293,9 @@ public:
   // abstract domains, then this Wrap must be overloaded
   // Bool determines if the the key needs to be wrapped as signed or unsigned
   virtual void Wrap(const std::map<DimensionKey, bool>& vs) {
+    for(std::map<DimensionKey, bool>::const_iterator it = vs.begin(); it != vs.end(); it++) {
+      MarkDirty(it->first);
+    }
     first_->Wrap(vs);
     second_->Wrap(vs);
     // Reduce(); ??
@@ -224,6 +306,35 @@ public:
   virtual void AddConstraint(affexp_type lhs, affexp_type rhs, OpType op) {
     first_->AddConstraint(lhs, rhs, op);
     second_->AddConstraint(lhs, rhs, op);
+    MarkDirty(lhs);
+    MarkDirty(rhs);
+    Reduce();
+  }
+
+  // Batch version of AddConstraint, the constraints are reduced once
+  virtual void AddConstraints(const std::vector<constraint_type>& cs) {
+    first_->AddConstraints(cs);
+    second_->AddConstraints(cs);
+    for(std::vector<constraint_type>::const_iterator it = cs.begin(); it != cs.end(); it++) {
+      MarkDirty(it->first.first);
+      MarkDirty(it->first.second);
+    }
+    Reduce();
+  }
+
+  virtual void AssignAffine(const DimensionKey& k, const affexp_type& e) {
+    first_->AssignAffine(k, e);
+    second_->AssignAffine(k, e);
+    MarkDirty(k);
+    Reduce();
+  }
+
+  virtual void AssignAffineParallel(const std::vector<assignment_type>& as) {
+    first_->AssignAffineParallel(as);
+    second_->AssignAffineParallel(as);
+    for(std::vector<assignment_type>::const_iterator it = as.begin(); it != as.end(); it++) {
+      MarkDirty(it->first);
+    }
     Reduce();
   }
 
@@ -235,6 +346,31 @@ public:
     return second_->IsConstant(val);
   }
 
+  // The bounds of a dimension in the product are the intersection of its bounds in both the values
+  virtual bool GetIntervals(interval_map_type& im) const {
+    interval_map_type second_im;
+    if(!first_->GetIntervals(im) || !second_->GetIntervals(second_im))
+      return false;
+    for(interval_map_type::iterator it = im.begin(); it != im.end(); it++) {
+      interval_map_type::const_iterator sit = second_im.find(it->first);
+      if(sit == second_im.end())
+        continue;
+      DimensionInterval& itv = it->second;
+      const DimensionInterval& sitv = sit->second;
+      if(sitv.has_lb && (!itv.has_lb || sitv.lb > itv.lb)) {
+        itv.has_lb = true;
+        itv.lb = sitv.lb;
+      }
+      if(sitv.has_ub && (!itv.has_ub || sitv.ub < itv.ub)) {
+        itv.has_ub = true;
+        itv.ub = sitv.ub;
+      }
+      if(itv.has_lb && itv.has_ub && itv.lb > itv.ub)
+        return false;
+    }
+    return true;
+  }
+
   virtual Vocabulary GetDependentVocabulary(DimensionKey& k) const {
     Vocabulary first_voc = first_->GetDependentVocabulary(k);
     Vocabulary second_voc = second_->GetDependentVocabulary(k);
@@ -245,8 +381,31 @@ public:
 
 
 private:
+  // Record that the facts on k, or on the dimensions of e, may have changed since the last reduction
+  void MarkDirty(const DimensionKey& k)
+  {
+    if(!all_dirty_)
+      dirty_voc_.insert(k);
+  }
+
+  void MarkDirty(const affexp_type& e)
+  {
+    for(linexp_type::const_iterator it = e.first.begin(); it != e.first.end(); it++) {
+      MarkDirty(it->first);
+    }
+  }
+
+  void MarkAllDirty()
+  {
+    all_dirty_ = true;
+    dirty_voc_.clear();
+  }
+
   // members
   AbsValRefPtr first_, second_;
+  // The dimensions whose facts may have changed since the last reduction, all of them with all_dirty_
+  bool all_dirty_;
+  Vocabulary dirty_voc_;
 
   const ReducedProductAbsVal *downcast( const AbsValRefPtr &val) const
   {
@@ -3,6 +3,7 @@
 #include <set>
 #include <algorithm>
 #include <sstream>
+#include <functional>
 
 const abstract_domain::Version abstract_domain::UNVERSIONED_VERSION = (Version)-1;
 const abstract_domain::DimensionKey 
@@ -155,6 +156,67 @@ namespace abstract_domain {
     }
     return out;
   }
+
+  void SerializeString(std::ostream & out, const std::string& s) {
+    out << s.size() << " " << s << " ";
+  }
+
+  std::string DeserializeString(std::istream & in) {
+    size_t len = 0;
+    in >> len;
+    in.get(); // Skip the separator
+    std::string s(len, ' ');
+    in.read(&s[0], len);
+    return s;
+  }
+
+  void SerializeDimensionKey(std::ostream & out, const DimensionKey& k) {
+    SerializeString(out, k.name);
+    out << std::dec << k.ver << " " << (unsigned)k.bitsize << " ";
+  }
+
+  DimensionKey DeserializeDimensionKey(std::istream & in) {
+    std::string name = DeserializeString(in);
+    Version ver;
+    unsigned bitsize;
+    in >> ver >> bitsize;
+    return DimensionKey(name, ver, (utils::Bitsize)bitsize);
+  }
+
+  void SerializeVocabulary(std::ostream & out, const Vocabulary& v) {
+    out << v.size() << " ";
+    for(Vocabulary::const_iterator it = v.begin(); it != v.end(); it++) {
+      SerializeDimensionKey(out, *it);
+    }
+  }
+
+  size_t HashCombine(size_t seed, size_t value) {
+    return seed ^ (value + 0x9e3779b9 + (seed << 6) + (seed >> 2));
+  }
+
+  size_t HashDimensionKey(const DimensionKey& k) {
+    size_t h = std::hash<std::string>()(k.name);
+    h = HashCombine(h, (size_t)k.ver);
+    return HashCombine(h, (size_t)k.bitsize);
+  }
+
+  size_t HashVocabulary(const Vocabulary& v) {
+    size_t h = v.size();
+    for(Vocabulary::const_iterator it = v.begin(); it != v.end(); it++) {
+      h = HashCombine(h, HashDimensionKey(*it));
+    }
+    return h;
+  }
+
+  Vocabulary DeserializeVocabulary(std::istream & in) {
+    size_t size = 0;
+    in >> size;
+    Vocabulary v;
+    for(size_t i = 0; i < size; i++) {
+      v.insert(DeserializeDimensionKey(in));
+    }
+    return v;
+  }
 }
 
 std::ostream & operator<<(std::ostream & out, const abstract_domain::DimensionKey& k) {
@@ -59,6 +59,21 @@ namespace abstract_domain {
   std::ostream & print(std::ostream & out, const DimensionKey& k);
   std::ostream & print(std::ostream & out, const Vocabulary& v, std::string delimiter = "|");
 
+  // Serialization helpers used to persist abstract values across runs.
+  // Strings are written with a length prefix so that arbitrary llvm names round-trip.
+  void SerializeString(std::ostream & out, const std::string& s);
+  std::string DeserializeString(std::istream & in);
+  void SerializeDimensionKey(std::ostream & out, const DimensionKey& k);
+  DimensionKey DeserializeDimensionKey(std::istream & in);
+  void SerializeVocabulary(std::ostream & out, const Vocabulary& v);
+  Vocabulary DeserializeVocabulary(std::istream & in);
+
+  // Hashing helpers used to bucket abstract values by their structure, see AbstractValue::Hash.
+  // The hashes are only meaningful within a run.
+  size_t HashCombine(size_t seed, size_t value);
+  size_t HashDimensionKey(const DimensionKey& k);
+  size_t HashVocabulary(const Vocabulary& v);
+
   // Dummy key placeholder
   extern const DimensionKey DUMMY_KEY;
 }
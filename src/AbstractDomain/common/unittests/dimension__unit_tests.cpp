@@ -1,5 +1,6 @@
 #include "src/AbstractDomain/common/dimension.hpp"
 #include "gtest/gtest.h"
+#include <sstream>
 
 using namespace abstract_domain;
 
@@ -48,6 +49,20 @@ TEST(DimensionTest, getVocabularySubset) {
   EXPECT_TRUE(dummyKey2 == *(v_1.begin()));
 }
 
+TEST(DimensionTest, SerializeVocabulary) {
+  DimensionKey dummyKey2(std::string("dummy key 2"), UNVERSIONED_VERSION, utils::eight);
+  Vocabulary v;
+  v.insert(dummyKey);
+  v.insert(dummyKey2);
+
+  std::stringstream ss;
+  SerializeVocabulary(ss, v);
+  SerializeString(ss, "");
+  Vocabulary v_rt = DeserializeVocabulary(ss);
+  EXPECT_EQ(v, v_rt);
+  EXPECT_EQ(std::string(""), DeserializeString(ss));
+}
+
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -4,25 +4,41 @@
 #include <iomanip>
 #include <getopt.h>
 #include <algorithm>
+#include <iterator>
 #include <memory>
+#include <cstdio>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <poll.h>
+#include <errno.h>
+#include <signal.h>
+#include <stdint.h>
 
 #include "analysis.hpp"
 #include "llvm/IR/Function.h"
 #include "llvm/IR/Module.h"
+#include "llvm/IR/Instructions.h"
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/Support/SourceMgr.h"
 #include "llvm/IRReader/IRReader.h"
+#include "llvm/Transforms/Utils/Cloning.h"
 
 #include "src/AbstractDomain/common/ReducedProductAbsVal.hpp"
 #include "src/AbstractDomain/common/BitpreciseWrappedAbstractValue.hpp"
 #include "src/AbstractDomain/PointsetPowerset/pointset_powerset_av.hpp"
+#include "src/AbstractDomain/AffineEquality/affine_equality_av.hpp"
 #include "src/reinterp/wrapped_domain/WrappedDomainWPDSCreator.hpp"
+#include "src/reinterp/wrapped_domain/LlvmVocabularyUtils.hpp"
+#include "src/reinterp/wrapped_domain/RuleCollector.hpp"
 
 #include "utils/timer/timer.hpp"
 #include "wali/wfa/State.hpp"
+#include "wali/Worklist.hpp"
+#include "wali/DefaultWorklist.hpp"
 #include "wali/wpds/RuleFunctor.hpp"
 #include "wali/wpds/ewpds/EWPDS.hpp"
 #include "wali/wpds/ewpds/ERule.hpp"
+#include "wali/wpds/fwpds/FWPDS.hpp"
 #include "wali/witness/Witness.hpp"
 #include "wali/witness/WitnessCombine.hpp"
 #include "wali/witness/WitnessExtend.hpp"
@@ -35,6 +51,8 @@
 using namespace abstract_domain;
 typedef PointsetPowersetAv<Parma_Polyhedra_Library::Octagonal_Shape<mpz_class> > PP_OCT_AV;
 typedef PointsetPowersetAv<Parma_Polyhedra_Library::C_Polyhedron> PP_CPOLY_AV;
+typedef PointsetPowersetAv<Parma_Polyhedra_Library::Octagonal_Shape<int64_t> > PP_OCT64_AV;
+typedef PointsetPowersetAv<Parma_Polyhedra_Library::BD_Shape<int64_t> > PP_BD64_AV;
 
 using namespace llvm;
 
@@ -74,6 +92,24 @@ sem_elem_t GetPathSummary(wali::wfa::WFA* fa_prog, const wali::Key& program, con
   return V_b;
 }
 
+// Return the keys in unreachable_keys whose path summary in fa_prog is zero, ie. the keys proved unreachable
+std::set<wali::Key> GetProvedUnreachableKeys(wali::wfa::WFA* fa_prog, const wali::Key& program, const std::set<wali::Key>& unreachable_keys, const std::string& kind) {
+  std::set<wali::Key> proved_unreachable_keys;
+  for(std::set<wali::Key>::const_iterator it = unreachable_keys.begin(); it != unreachable_keys.end(); it++) {
+    wali::Key unreachable_key = *it;
+    sem_elem_t path_sum = GetPathSummary(fa_prog, program, unreachable_key);
+    assert(path_sum != NULL);
+    if(debug_print_level >= DBG_PRINT_OVERVIEW) { 
+      path_sum->print(std::cout << "\nWeight for the unreachable key " << wali::key2str(unreachable_key) << " is:\n");
+    }
+    if(path_sum->equal(path_sum->zero())) {
+      std::cout << "\nThe unreachable key " << wali::key2str(unreachable_key) << kind << " is proved to be unreachable by the wrapped domain analysis.";
+      proved_unreachable_keys.insert(unreachable_key);
+    }
+  }
+  return proved_unreachable_keys;
+}
+
 /*!
  * @class RuleCopierWithWitness
  *
@@ -471,8 +507,874 @@ namespace wali {
   }
 }
 
+// The options which determine the weights of the WPDS and the post* automaton. A saved fixpoint
+// can only be reused by a run with the same configuration.
+std::string GetFixpointConfig() {
+  std::stringstream ss;
+  ss << "oct:" << cmdlineparam_use_oct << " red_prod:" << cmdlineparam_use_red_prod
+     << " fwpds:" << cmdlineparam_use_fwpds << " max_disjunctions:" << cmdlineparam_max_disjunctions
+     << " disable_wrapping:" << cmdlineparam_disable_wrapping << " use_extrapolation:" << cmdlineparam_use_extrapolation
+     << " array_bounds_check:" << cmdlineparam_array_bounds_check << " allow_phis:" << cmdlineparam_allow_phis
+     << " adaptive_disjunctions:" << (cmdlineparam_adaptive_disjunctions || cmdlineparam_escalate_disjunctions != 0)
+     << " slice:" << cmdlineparam_slice
+     << " newton:" << cmdlineparam_newton << " widening_delay:" << cmdlineparam_widening_delay
+     << " compress_chains:" << cmdlineparam_compress_chains
+     << " interval_preanalysis:" << cmdlineparam_interval_preanalysis
+     << " infer_signedness:" << cmdlineparam_infer_signedness
+     << " symbolic_bb:" << cmdlineparam_symbolic_bb << " propagation_rounds:" << cmdlineparam_propagation_rounds
+     << " affine_equalities:" << cmdlineparam_affine_equalities << " reduction_rounds:" << cmdlineparam_reduction_rounds
+     << " box_filter:" << cmdlineparam_box_filter << " lazy_merge_limit:" << cmdlineparam_lazy_merge_limit
+     << " int64_coefficients:" << cmdlineparam_int64_coefficients << " bd_shapes:" << cmdlineparam_use_bd_shapes;
+  return ss.str();
+}
+
+// Periodic checkpointing of post*
+//
+// WALi's post* cannot be interrupted, so the checkpoints are only taken at quiescent points, once every
+// cmdlineparam_checkpoint_interval seconds: between the rounds of NewtonPoststar, and between two transitions
+// taken off the worklist of a chaotic post* (see CheckpointingWorklist). A final checkpoint is written once
+// post* completes. The checkpoint is written to a temporary file which is then renamed to the checkpoint file,
+// so a run that gets preempted never leaves behind a truncated checkpoint.
+// Checkpoint file layout:
+//   phase ("newton" between Newton rounds, "poststar_partial" during a chaotic post*, "poststar_done" once
+//   post* completed)
+//   the number of Newton rounds done
+//   the widening counts of AvSemiring
+//   the automaton as written by WrappedDomainWPDSCreator::SaveFixpoint. Between Newton rounds, it holds the
+//   summaries nu, see BuildNewtonSummaryAutomaton.
+static llvm_abstract_transformer::WrappedDomainWPDSCreator* checkpoint_cr = NULL;
+static long last_checkpoint_time = 0;
+
+void WriteCheckpoint(const std::string& phase, unsigned num_rounds, const wali::wfa::WFA& fa) {
+  assert(checkpoint_cr != NULL);
+  utils::Timer checkpoint_timer("checkpoint", std::cout, false);
+  std::string tmp_filename = cmdlineparam_checkpoint_file + ".tmp";
+  std::ofstream out(tmp_filename);
+  if(!out.good()) {
+    std::cout << "\nCould not open checkpoint file " << tmp_filename << " for writing.";
+    return;
+  }
+  SerializeString(out, phase);
+  out << "\n" << num_rounds << "\n";
+  AvSemiring::SerializeWideningCounts(out);
+  checkpoint_cr->SaveFixpoint(out, fa, GetFixpointConfig());
+  out.close();
+  if(std::rename(tmp_filename.c_str(), cmdlineparam_checkpoint_file.c_str()) != 0) {
+    std::cout << "\nCould not rename " << tmp_filename << " to " << cmdlineparam_checkpoint_file;
+    return;
+  }
+  std::cout << "\nWrote " << phase << " checkpoint to " << cmdlineparam_checkpoint_file 
+            << " in " << checkpoint_timer.elapsed() << "s" << std::flush;
+  // Do not count the time spent writing the checkpoint towards the next interval
+  last_checkpoint_time = utils::myclock();
+}
+
+bool IsCheckpointDue() {
+  if(checkpoint_cr == NULL)
+    return false;
+  return utils::myclock() - last_checkpoint_time >= (long)cmdlineparam_checkpoint_interval * 1000000;
+}
+
+void StartCheckpointing(llvm_abstract_transformer::WrappedDomainWPDSCreator* cr) {
+  if(cmdlineparam_checkpoint_file.size() == 0)
+    return;
+  checkpoint_cr = cr;
+  last_checkpoint_time = utils::myclock();
+}
+
+void StopCheckpointing() {
+  checkpoint_cr = NULL;
+}
+
+// The worklist of a chaotic post*. Between two transitions taken off the worklist, post* is not in the middle
+// of updating fa_, so a partial checkpoint of fa_ can be written then. The clock is only read once every
+// checkpoint_check_period transitions.
+class CheckpointingWorklist : public wali::Worklist<wali::wfa::ITrans> {
+public:
+  CheckpointingWorklist(const wali::wfa::WFA& fa) : fa_(fa), wl_(new wali::DefaultWorklist<wali::wfa::ITrans>()), num_gets_(0) {}
+
+  virtual bool put(wali::wfa::ITrans* t) {
+    return wl_->put(t);
+  }
+
+  virtual wali::wfa::ITrans* get() {
+    if(++num_gets_ % checkpoint_check_period == 0 && IsCheckpointDue())
+      WriteCheckpoint("poststar_partial", 0, fa_);
+    return wl_->get();
+  }
+
+  virtual bool empty() const {
+    return wl_->empty();
+  }
+
+  virtual void clear() {
+    wl_->clear();
+  }
+
+private:
+  static const unsigned checkpoint_check_period = 1000;
+  const wali::wfa::WFA& fa_;
+  ref_ptr<wali::Worklist<wali::wfa::ITrans> > wl_;
+  unsigned long num_gets_;
+};
+
+// Global budgets during post*
+//
+// While the global time or memory budget is exceeded, every weight computed by post* is coarsened. The
+// budgets are only sampled once every budget_check_period combines. The memory budget is on the current
+// resident memory, so the weights are no longer coarsened once enough memory is freed.
+static llvm_abstract_transformer::WrappedDomainWPDSCreator* budget_cr = NULL;
+static const unsigned budget_check_period = 1000;
+static unsigned num_combines_since_budget_check = 0;
+static bool poststar_degraded = false;
+
+void BudgetHook() {
+  if(budget_cr == NULL)
+    return;
+  if(cmdlineparam_time_budget == 0 && cmdlineparam_memory_budget == 0)
+    return;
+  if(++num_combines_since_budget_check < budget_check_period)
+    return;
+  num_combines_since_budget_check = 0;
+  bool exceeded = budget_cr->GlobalBudgetExceeded();
+  if(exceeded && !AvSemiring::coarsen_all_) {
+    std::cout << "\nGlobal budget exceeded during post*, coarsening all weights to octagonal constraints." << std::flush;
+    poststar_degraded = true;
+  } else if(!exceeded && AvSemiring::coarsen_all_) {
+    std::cout << "\nBack within the global budget during post*, no longer coarsening all weights." << std::flush;
+  }
+  AvSemiring::coarsen_all_ = exceeded;
+}
+
+// Collect the summaries held by the automaton of BuildNewtonSummaryAutomaton
+class NewtonSummaryCollector : public wali::wfa::ConstTransFunctor {
+public:
+  std::map<wali::Key, sem_elem_t>& nu_;
+  NewtonSummaryCollector(std::map<wali::Key, sem_elem_t>& nu) : nu_(nu) {}
+  virtual void operator()(const wali::wfa::ITrans* t) {
+    nu_[t->stack()] = t->weight();
+  }
+};
+
+// Copy the transitions of the root frames of a partial post*: the ones that go to the accepting state of
+// BuildAutomaton. Their weights are joins of the weights of paths of the program, so seeding post* with them
+// is sound. The transitions from the states that post* generates for the calls are not copied, as they stand
+// for the merge functions of the calls, which the automaton does not save.
+class RootTransCopier : public wali::wfa::ConstTransFunctor {
+public:
+  wali::wfa::WFA& fa_;
+  unsigned num_copied_;
+  RootTransCopier(wali::wfa::WFA& fa) : fa_(fa), num_copied_(0) {}
+  virtual void operator()(const wali::wfa::ITrans* t) {
+    if(t->to() != wali::getKey("accepting_state") || t->stack() == wali::WALI_EPSILON)
+      return;
+    fa_.addTrans(t->from(), t->stack(), t->to(), t->weight());
+    num_copied_++;
+  }
+};
+
+// Resume from the checkpoint in cmdlineparam_resume_file. A poststar_done checkpoint seeds fa with its
+// transitions, a poststar_partial checkpoint with the transitions of its root frames (see RootTransCopier), and
+// a newton checkpoint sets the summaries nu and the number of rounds to resume NewtonPoststar from.
+// Returns the number of transitions added to fa.
+unsigned ResumeFromCheckpoint(llvm_abstract_transformer::WrappedDomainWPDSCreator& cr, wali::wfa::WFA* fa, 
+                              std::map<wali::Key, sem_elem_t>& nu, unsigned& num_rounds) {
+  std::ifstream in(cmdlineparam_resume_file);
+  if(!in.good()) {
+    std::cout << "\nCould not open checkpoint file " << cmdlineparam_resume_file << ", analyzing from scratch.";
+    return 0;
+  }
+  std::string phase = DeserializeString(in);
+  unsigned saved_num_rounds = 0;
+  in >> saved_num_rounds;
+  if(phase == "newton" && !cmdlineparam_newton) {
+    std::cout << "\nThe checkpoint in " << cmdlineparam_resume_file << " was taken between Newton rounds, analyzing from scratch.";
+    return 0;
+  }
+  if(phase == "poststar_partial" && cmdlineparam_newton) {
+    std::cout << "\nThe checkpoint in " << cmdlineparam_resume_file << " was taken during a chaotic post*, analyzing from scratch.";
+    return 0;
+  }
+  std::cout << "\nResuming from the " << phase << " checkpoint in " << cmdlineparam_resume_file;
+  AvSemiring::DeserializeWideningCounts(in);
+  if(phase == "poststar_done")
+    return cr.SeedAutomatonFromFixpoint(in, fa, GetFixpointConfig(), true/*keep_all*/);
+  if(phase == "poststar_partial") {
+    wali::wfa::WFA fa_partial;
+    if(cr.SeedAutomatonFromFixpoint(in, &fa_partial, GetFixpointConfig(), true/*keep_all*/) == 0) {
+      AvSemiring::widening_counts_.clear();
+      return 0;
+    }
+    RootTransCopier rtc(*fa);
+    fa_partial.for_each(rtc);
+    return rtc.num_copied_;
+  }
+
+  wali::wfa::WFA fa_nu;
+  if(cr.SeedAutomatonFromFixpoint(in, &fa_nu, GetFixpointConfig(), true/*keep_all*/) == 0) {
+    AvSemiring::widening_counts_.clear();
+    return 0;
+  }
+  NewtonSummaryCollector nsc(nu);
+  fa_nu.for_each(nsc);
+  num_rounds = saved_num_rounds;
+  return 0;
+}
+
+// Adaptive disjunct limits
+//
+// Allow up to max_disjuncts disjuncts at the program points in keys, and a single disjunct at the points
+// without a limit of their own.
+void SetDisjunctLimits(const std::set<wali::Key>& keys, unsigned max_disjuncts) {
+  AvSemiring::default_disjunct_limit_ = 1;
+  for(std::set<wali::Key>::const_iterator it = keys.begin(); it != keys.end(); it++) {
+    AvSemiring::disjunct_limits_[wali::key2str(*it)] = max_disjuncts;
+  }
+}
+
+// The limit of a program point cannot exceed the max_disjunctions of the domain. The escalated limits are
+// only allowed at the widening points, where AvSemiring raises max_disjunctions through this function
+// for the duration of a combine. Returns the previous max_disjunctions.
+unsigned SetDomainMaxDisjunctions(unsigned max_disjuncts) {
+  unsigned prev_max_disjuncts;
+  if(cmdlineparam_use_oct) {
+    prev_max_disjuncts = PP_OCT_AV::max_disjunctions;
+    PP_OCT_AV::max_disjunctions = max_disjuncts;
+    PP_OCT64_AV::max_disjunctions = max_disjuncts;
+    PP_BD64_AV::max_disjunctions = max_disjuncts;
+  } else {
+    prev_max_disjuncts = PP_CPOLY_AV::max_disjunctions;
+    PP_CPOLY_AV::max_disjunctions = max_disjuncts;
+  }
+  return prev_max_disjuncts;
+}
+
+// Machine coefficients
+//
+// The bounds of the dimensions wider than 32 bits, such as the ones that Wrap adds, do not fit in the int64_t
+// coefficients of the octagons (which store twice the bounds) and would be rounded up to +infinity.
+bool IsWideInteger(Type* t) {
+  return t->isIntegerTy() && t->getIntegerBitWidth() > 32;
+}
+
+// Is I only used as an index of GetElementPtr instructions, such as the sext to i64 of an array index?
+bool IsOnlyGepIndex(Instruction& I) {
+  if(I.user_empty())
+    return false;
+  for(Value::user_iterator uit = I.user_begin(); uit != I.user_end(); uit++) {
+    GetElementPtrInst* gep = dyn_cast<GetElementPtrInst>(*uit);
+    if(!gep || gep->getPointerOperand() == &I)
+      return false;
+  }
+  return true;
+}
+
+// Only the types of the values the analysis tracks are looked at: the globals, the arguments, the allocas and
+// the instructions. The operands are either such values or constants, and the GetElementPtr indices are skipped.
+bool HasWideIntegers(Module& M) {
+  for(Module::global_iterator git = M.global_begin(); git != M.global_end(); git++) {
+    if(IsWideInteger(git->getType()->getElementType()))
+      return true;
+  }
+  for(Module::iterator fit = M.begin(); fit != M.end(); fit++) {
+    for(Function::arg_iterator ait = fit->arg_begin(); ait != fit->arg_end(); ait++) {
+      if(IsWideInteger(ait->getType()))
+        return true;
+    }
+    for(Function::iterator bbit = fit->begin(); bbit != fit->end(); bbit++) {
+      for(BasicBlock::iterator iit = bbit->begin(); iit != bbit->end(); iit++) {
+        if(AllocaInst* ai = dyn_cast<AllocaInst>(iit)) {
+          if(IsWideInteger(ai->getAllocatedType()))
+            return true;
+          continue;
+        }
+        if(IsWideInteger(iit->getType()) && !IsOnlyGepIndex(*iit))
+          return true;
+      }
+    }
+  }
+  return false;
+}
+
+template <typename PP_AV>
+void SetOctagonParameters() {
+  PP_AV::max_disjunctions = cmdlineparam_max_disjunctions;
+  PP_AV::use_extrapolation = cmdlineparam_use_extrapolation;
+  PP_AV::propagation_rounds = cmdlineparam_propagation_rounds;
+  PP_AV::box_filter = cmdlineparam_box_filter;
+  PP_AV::lazy_merge_limit = cmdlineparam_lazy_merge_limit;
+}
+
+// Creates the octagons over voc, with the coefficients selected by --int64_coefficients and --bd_shapes. The
+// mpz_class coefficients are kept when M has integers wider than 32 bits.
+ref_ptr<AbstractValue> CreateOctagonAv(Module& M, const Vocabulary& voc) {
+  if(cmdlineparam_int64_coefficients || cmdlineparam_use_bd_shapes) {
+    if(!HasWideIntegers(M)) {
+      if(cmdlineparam_use_bd_shapes) {
+        std::cout << " (BD shapes with int64_t coefficients)";
+        SetOctagonParameters<PP_BD64_AV>();
+        return new PP_BD64_AV(voc);
+      }
+      std::cout << " (int64_t coefficients)";
+      SetOctagonParameters<PP_OCT64_AV>();
+      return new PP_OCT64_AV(voc);
+    }
+    std::cout << " (mpz_class coefficients, the module has integers wider than 32 bits)";
+  }
+  SetOctagonParameters<PP_OCT_AV>();
+  return new PP_OCT_AV(voc);
+}
+
+// Bottom-up summaries
+//
+// The SCCs of the call graph are summarized bottom-up by a coordinator (the main process) and
+// cmdlineparam_summary_workers worker processes, forked once the WPDS is built and connected to the
+// coordinator by a pair of pipes. WALi and PPL are not thread-safe, hence the processes.
+// An SCC is handed out to an idle worker once all the SCCs it calls are done. The task carries the serialized
+// summaries of the SCCs it transitively calls. The worker seeds the post* of the SCC (see BuildSummaryAutomaton)
+// with them, so the callees are not analyzed again, and sends back the transitions of the SCC (see SaveSummary).
+// A worker frees all its weights after each task, and retires once its resident memory grew by more than
+// cmdlineparam_worker_memory_budget since it was forked, to be replaced by a fresh one. The coordinator writes
+// each summary to a file of a temporary directory as soon as it arrives, and reads it back to build the tasks
+// of the callers and to seed the post* of the whole program with all of them, so that the merge functions apply
+// them at the call sites.
+// An SCC whose worker died is left to its callers, which only costs time.
+
+// Messages are length-prefixed strings. An empty task tells a worker to exit.
+bool WriteMessage(int fd, const std::string& msg) {
+  uint64_t size = msg.size();
+  std::string data(reinterpret_cast<const char*>(&size), sizeof(size));
+  data += msg;
+  size_t written = 0;
+  while(written < data.size()) {
+    ssize_t n = write(fd, data.data() + written, data.size() - written);
+    if(n < 0 && errno == EINTR)
+      continue;
+    if(n <= 0)
+      return false;
+    written += n;
+  }
+  return true;
+}
+
+bool ReadBytes(int fd, char* buf, size_t size) {
+  size_t num_read = 0;
+  while(num_read < size) {
+    ssize_t n = read(fd, buf + num_read, size - num_read);
+    if(n < 0 && errno == EINTR)
+      continue;
+    if(n <= 0)
+      return false;
+    num_read += n;
+  }
+  return true;
+}
+
+bool ReadMessage(int fd, std::string& msg) {
+  uint64_t size;
+  if(!ReadBytes(fd, reinterpret_cast<char*>(&size), sizeof(size)))
+    return false;
+  msg.resize(size);
+  return size == 0 || ReadBytes(fd, &msg[0], size);
+}
+
+struct SummaryWorker {
+  pid_t pid;
+  int task_fd;   // Coordinator to worker
+  int result_fd; // Worker to coordinator
+  int scc;       // SCC being summarized, -1 if idle
+};
+
+void RunSummaryWorker(llvm_abstract_transformer::WrappedDomainWPDSCreator& cr, wali::wpds::WPDS* pds, 
+                      const std::vector<llvm_abstract_transformer::CallGraphSCC>& sccs, int task_fd, int result_fd) {
+  long start_memory = utils::getResidentMemory();
+  std::string task;
+  while(ReadMessage(task_fd, task) && task.size() != 0) {
+    utils::Timer scc_timer("scc_summary", std::cout, false);
+    std::istringstream task_in(task);
+    unsigned scc = 0, num_seeds = 0;
+    task_in >> scc >> num_seeds;
+    wali::wfa::WFA* fa_scc = cr.BuildSummaryAutomaton(sccs[scc].funcs);
+    for(unsigned i = 0; i < num_seeds; i++) {
+      std::istringstream seed_in(DeserializeString(task_in));
+      cr.SeedAutomatonFromFixpoint(seed_in, fa_scc, GetFixpointConfig(), true/*keep_all*/);
+    }
+
+#ifdef USE_AKASH_FWPDS
+    pds->poststar(*fa_scc, *fa_scc);
+    wali::wfa::WFA* fa_scc_ps = fa_scc;
+#else
+    wali::wfa::WFA* fa_scc_ps = new wali::wfa::WFA();
+    pds->poststar(*fa_scc, *fa_scc_ps);
+    delete fa_scc;
+#endif
+
+    // Retire if the memory of this worker grew by more than the worker memory budget
+    bool retire = (cmdlineparam_worker_memory_budget != 0 && 
+                   utils::getResidentMemory() - start_memory > (long)cmdlineparam_worker_memory_budget);
+
+    std::ostringstream result_out;
+    result_out << (retire ? 1 : 0) << "\n";
+    cr.SaveSummary(result_out, *fa_scc_ps, GetFixpointConfig(), sccs[scc].funcs);
+    delete fa_scc_ps;
+    std::cout << "\nWorker " << getpid() << " summarized SCC " << scc << " (" << sccs[scc].funcs.size() 
+              << " functions) in " << scc_timer.elapsed() << "s" << std::flush;
+    if(!WriteMessage(result_fd, result_out.str()) || retire)
+      break;
+  }
+  std::cout << std::flush;
+}
+
+// The worker does not keep the pipes of the other workers open, so that each of them sees the coordinator exit
+bool StartSummaryWorker(llvm_abstract_transformer::WrappedDomainWPDSCreator& cr, wali::wpds::WPDS* pds, 
+                        const std::vector<llvm_abstract_transformer::CallGraphSCC>& sccs, 
+                        const std::vector<SummaryWorker>& other_workers, SummaryWorker& worker) {
+  int task_pipe[2], result_pipe[2];
+  if(pipe(task_pipe) != 0)
+    return false;
+  if(pipe(result_pipe) != 0) {
+    close(task_pipe[0]);
+    close(task_pipe[1]);
+    return false;
+  }
+  std::cout << std::flush;
+  pid_t pid = fork();
+  if(pid == 0) {
+    close(task_pipe[1]);
+    close(result_pipe[0]);
+    for(std::vector<SummaryWorker>::const_iterator w_it = other_workers.begin(); w_it != other_workers.end(); w_it++) {
+      close(w_it->task_fd);
+      close(w_it->result_fd);
+    }
+    RunSummaryWorker(cr, pds, sccs, task_pipe[0], result_pipe[1]);
+    _exit(0);
+  }
+  close(task_pipe[0]);
+  close(result_pipe[1]);
+  if(pid < 0) {
+    close(task_pipe[1]);
+    close(result_pipe[0]);
+    return false;
+  }
+  worker.pid = pid;
+  worker.task_fd = task_pipe[1];
+  worker.result_fd = result_pipe[0];
+  worker.scc = -1;
+  return true;
+}
+
+void StopSummaryWorker(SummaryWorker& worker) {
+  close(worker.task_fd);
+  close(worker.result_fd);
+  waitpid(worker.pid, NULL, 0);
+}
+
+// Collect in callees the SCCs transitively called from scc
+void CollectTransitiveCallees(const std::vector<llvm_abstract_transformer::CallGraphSCC>& sccs, unsigned scc, std::set<unsigned>& callees) {
+  std::vector<unsigned> worklist(sccs[scc].callees.begin(), sccs[scc].callees.end());
+  while(worklist.size() != 0) {
+    unsigned callee = worklist.back();
+    worklist.pop_back();
+    if(!callees.insert(callee).second)
+      continue;
+    worklist.insert(worklist.end(), sccs[callee].callees.begin(), sccs[callee].callees.end());
+  }
+}
+
+// The summaries received by the coordinator are kept in the files <dir>/scc_<scc>
+std::string GetSummaryFilename(const std::string& dir, unsigned scc) {
+  std::stringstream ss;
+  ss << dir << "/scc_" << scc;
+  return ss.str();
+}
+
+std::string ReadSummary(const std::string& dir, unsigned scc) {
+  std::ifstream summary_in(GetSummaryFilename(dir, scc).c_str(), std::ios::binary);
+  std::stringstream ss;
+  ss << summary_in.rdbuf();
+  return ss.str();
+}
+
+// Compute the summaries of all the SCCs and seed fa_prog with them. Returns the number of seeded transitions.
+unsigned ComputeBottomUpSummaries(llvm_abstract_transformer::WrappedDomainWPDSCreator& cr, wali::wpds::WPDS* pds, 
+                                  wali::wfa::WFA* fa_prog, unsigned& num_summarized) {
+  enum SCCStatus {PENDING, RUNNING, DONE, FAILED};
+  std::vector<llvm_abstract_transformer::CallGraphSCC> sccs = cr.GetCallGraphSCCs();
+  std::vector<SCCStatus> status(sccs.size(), PENDING);
+
+  num_summarized = 0;
+  char summary_dir_template[] = "/tmp/scc_summaries_XXXXXX";
+  if(mkdtemp(summary_dir_template) == NULL) {
+    std::cout << "\nCould not create a directory for the summaries, the summaries are left to post*.";
+    return 0;
+  }
+  std::string summary_dir(summary_dir_template);
+
+  // A dead worker is detected when reading its result, not by being killed when writing its task
+  void (*old_sigpipe_handler)(int) = signal(SIGPIPE, SIG_IGN);
+
+  unsigned num_workers = cmdlineparam_summary_workers;
+  if(num_workers == 0) {
+    long num_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    num_workers = (num_cpus > 0) ? (unsigned)num_cpus : 1;
+  }
+  std::cout << "\nComputing the summaries of " << sccs.size() << " call graph SCCs with " << num_workers << " workers.";
+
+  std::vector<SummaryWorker> workers;
+  for(unsigned i = 0; i < num_workers; i++) {
+    SummaryWorker worker;
+    if(!StartSummaryWorker(cr, pds, sccs, workers, worker))
+      break;
+    workers.push_back(worker);
+  }
+  if(workers.size() == 0)
+    std::cout << "\nCould not start any worker, the summaries are left to post*.";
+
+  unsigned num_finished = 0;
+  while(workers.size() != 0 && num_finished != sccs.size()) {
+    // Hand out the SCCs whose callees are finished to the idle workers
+    for(unsigned scc = 0; scc < sccs.size(); scc++) {
+      if(status[scc] != PENDING)
+        continue;
+      bool is_ready = true;
+      for(std::set<unsigned>::const_iterator it = sccs[scc].callees.begin(); it != sccs[scc].callees.end() && is_ready; it++) {
+        is_ready = (status[*it] == DONE || status[*it] == FAILED);
+      }
+      if(!is_ready)
+        continue;
+      std::vector<SummaryWorker>::iterator w_it = workers.begin();
+      while(w_it != workers.end() && w_it->scc != -1)
+        w_it++;
+      if(w_it == workers.end())
+        break;
+
+      std::set<unsigned> callees, seeds;
+      CollectTransitiveCallees(sccs, scc, callees);
+      for(std::set<unsigned>::const_iterator it = callees.begin(); it != callees.end(); it++) {
+        if(status[*it] == DONE)
+          seeds.insert(*it);
+      }
+      std::ostringstream task_out;
+      task_out << scc << " " << seeds.size() << "\n";
+      for(std::set<unsigned>::const_iterator it = seeds.begin(); it != seeds.end(); it++) {
+        SerializeString(task_out, ReadSummary(summary_dir, *it));
+      }
+      w_it->scc = scc;
+      status[scc] = RUNNING;
+      WriteMessage(w_it->task_fd, task_out.str());
+    }
+
+    // Wait for a result
+    std::vector<struct pollfd> pfds;
+    for(std::vector<SummaryWorker>::const_iterator w_it = workers.begin(); w_it != workers.end(); w_it++) {
+      struct pollfd pfd;
+      pfd.fd = w_it->result_fd;
+      pfd.events = POLLIN;
+      pfd.revents = 0;
+      pfds.push_back(pfd);
+    }
+    if(poll(&pfds[0], pfds.size(), -1) < 0) {
+      if(errno == EINTR)
+        continue;
+      break;
+    }
+
+    for(size_t i = workers.size(); i-- > 0; ) {
+      if(pfds[i].revents == 0)
+        continue;
+      SummaryWorker& worker = workers[i];
+      std::string result;
+      bool retired = true;
+      if(worker.scc != -1 && ReadMessage(worker.result_fd, result)) {
+        std::istringstream result_in(result);
+        unsigned retire = 0;
+        result_in >> retire;
+        result_in.get();
+        std::ofstream summary_out(GetSummaryFilename(summary_dir, worker.scc).c_str(), std::ios::binary);
+        summary_out.write(result.data() + (size_t)result_in.tellg(), result.size() - (size_t)result_in.tellg());
+        summary_out.close();
+        status[worker.scc] = summary_out ? DONE : FAILED;
+        retired = (retire != 0);
+      } else if(worker.scc != -1) {
+        std::cout << "\nThe worker summarizing SCC " << worker.scc << " died, its callers will analyze it again.";
+        status[worker.scc] = FAILED;
+      }
+      if(worker.scc != -1)
+        num_finished++;
+      worker.scc = -1;
+
+      if(retired) {
+        StopSummaryWorker(worker);
+        workers.erase(workers.begin() + i);
+        SummaryWorker new_worker;
+        if(StartSummaryWorker(cr, pds, sccs, workers, new_worker))
+          workers.push_back(new_worker);
+      }
+    }
+  }
+
+  for(std::vector<SummaryWorker>::iterator w_it = workers.begin(); w_it != workers.end(); w_it++) {
+    WriteMessage(w_it->task_fd, "");
+    StopSummaryWorker(*w_it);
+  }
+
+  signal(SIGPIPE, old_sigpipe_handler);
+
+  unsigned num_seeded = 0;
+  for(unsigned scc = 0; scc < sccs.size(); scc++) {
+    if(status[scc] != DONE)
+      continue;
+    num_summarized++;
+    std::ifstream summary_in(GetSummaryFilename(summary_dir, scc).c_str(), std::ios::binary);
+    num_seeded += cr.SeedAutomatonFromFixpoint(summary_in, fa_prog, GetFixpointConfig(), true/*keep_all*/);
+    summary_in.close();
+    std::remove(GetSummaryFilename(summary_dir, scc).c_str());
+  }
+  rmdir(summary_dir.c_str());
+  return num_seeded;
+}
+
+// Newtonian program analysis
+//
+// An alternative to solving the program WPDS with a single chaotic post*. The procedure summaries nu (the
+// weights from the entry of a procedure to its returns) are computed in Newton rounds. A round solves the
+// linearization of the interprocedural equations at nu: a path of a procedure descends into at most one of
+// its calls, and takes the other calls through their summaries in nu, which the merge functions of the calls
+// apply. This linear system is a WPDS with two copies of each stack symbol: the original one, which has not
+// descended yet, and a copy which is reached by returning from the descent. The solution of a round is widened
+// into nu (after the first round), and the rounds stop once nu is stable. Loops are still only widened at their
+// heads, by the widening rules of the back edges. The assertions are then queried on a WPDS without pushes, in
+// which a call goes both to its return point through the summary of its callee, and to the entry of its callee.
+wali::Key GetNewtonCopyKey(wali::Key k) {
+  return wali::getKey(wali::key2str(k) + "__newton_returned");
+}
+
+wali::Key GetNewtonAcceptingKey(wali::Key entry) {
+  return wali::getKey("newton_accepting_" + wali::key2str(entry));
+}
+
+wali::wpds::WPDS* CreateEmptyPds(const wali::wpds::WPDS* pds) {
+  if(dynamic_cast<const wali::wpds::fwpds::FWPDS*>(pds) != NULL)
+    return new wali::wpds::fwpds::FWPDS();
+  return new wali::wpds::ewpds::EWPDS();
+}
+
+void AddRule(wali::wpds::WPDS* pds, wali::Key p, wali::Key from_stack, wali::Key to_stack1, wali::Key to_stack2, sem_elem_t w, wali::merge_fn_t mf) {
+  wali::wpds::ewpds::EWPDS* ewpds = dynamic_cast<wali::wpds::ewpds::EWPDS*>(pds);
+  if(ewpds) {
+    ewpds->add_rule(p, from_stack, p, to_stack1, to_stack2, w, mf);
+  } else {
+    wali::wpds::fwpds::FWPDS* fwpds = dynamic_cast<wali::wpds::fwpds::FWPDS*>(pds);
+    fwpds->add_rule(p, from_stack, p, to_stack1, to_stack2, w, mf);
+  }
+}
+
+// The weight of a call taken through the summary of its callee, or NULL if the callee has no summary yet
+sem_elem_t GetSummaryCallWeight(const wali::wpds::ewpds::ERule* erule, const std::map<wali::Key, sem_elem_t>& nu) {
+  std::map<wali::Key, sem_elem_t>::const_iterator nu_it = nu.find(erule->to_stack1());
+  if(nu_it == nu.end() || nu_it->second->equal(nu_it->second->zero()))
+    return NULL;
+  return erule->merge_fn()->apply_f(erule->weight(), nu_it->second);
+}
+
+wali::wpds::WPDS* BuildNewtonLinearization(const wali::wpds::WPDS* pds, const std::vector<wali::wpds::rule_t>& rules, 
+                                           const std::map<wali::Key, sem_elem_t>& nu) {
+  wali::wpds::WPDS* lin_pds = CreateEmptyPds(pds);
+  for(std::vector<wali::wpds::rule_t>::const_iterator it = rules.begin(); it != rules.end(); it++) {
+    const wali::wpds::ewpds::ERule* erule = dynamic_cast<const wali::wpds::ewpds::ERule*>(it->get_ptr());
+    assert(erule != NULL);
+    wali::Key p = erule->from_state();
+    wali::Key from_stack = erule->from_stack(), to_stack1 = erule->to_stack1(), to_stack2 = erule->to_stack2();
+    if(to_stack2 == wali::WALI_EPSILON) {
+      // Intraprocedural and return rules belong to both copies
+      AddRule(lin_pds, p, from_stack, to_stack1, wali::WALI_EPSILON, erule->weight(), NULL);
+      wali::Key to_stack1_cp = (to_stack1 == wali::WALI_EPSILON) ? wali::WALI_EPSILON : GetNewtonCopyKey(to_stack1);
+      AddRule(lin_pds, p, GetNewtonCopyKey(from_stack), to_stack1_cp, wali::WALI_EPSILON, erule->weight(), NULL);
+      continue;
+    }
+
+    // Descend into the call from the original copy, and return to the copy
+    AddRule(lin_pds, p, from_stack, to_stack1, GetNewtonCopyKey(to_stack2), erule->weight(), erule->merge_fn());
+
+    // Take the call through the summary of the callee in both copies
+    sem_elem_t summary_w = GetSummaryCallWeight(erule, nu);
+    if(summary_w.is_valid()) {
+      AddRule(lin_pds, p, from_stack, to_stack2, wali::WALI_EPSILON, summary_w, NULL);
+      AddRule(lin_pds, p, GetNewtonCopyKey(from_stack), GetNewtonCopyKey(to_stack2), wali::WALI_EPSILON, summary_w, NULL);
+    }
+  }
+  return lin_pds;
+}
+
+// Solve a round: the summary of a procedure is the weight of the return from its entry to its accepting state
+std::map<wali::Key, sem_elem_t> SolveNewtonRound(wali::wpds::WPDS* lin_pds, const std::set<wali::Key>& entries, 
+                                                 wali::Key program, sem_elem_t prototype) {
+  wali::wfa::WFA* fa_round = new wali::wfa::WFA(wali::wfa::WFA::INORDER, NULL);
+  fa_round->addState(program, prototype->zero());
+  fa_round->setInitialState(program);
+  for(std::set<wali::Key>::const_iterator it = entries.begin(); it != entries.end(); it++) {
+    wali::Key accepting = GetNewtonAcceptingKey(*it);
+    fa_round->addState(accepting, prototype->zero());
+    fa_round->addFinalState(accepting);
+    fa_round->addTrans(program, *it, accepting, prototype->one());
+  }
+
+#ifdef USE_AKASH_FWPDS
+  lin_pds->poststar(*fa_round, *fa_round);
+  wali::wfa::WFA* fa_round_ps = fa_round;
+#else
+  wali::wfa::WFA* fa_round_ps = new wali::wfa::WFA();
+  lin_pds->poststar(*fa_round, *fa_round_ps);
+  delete fa_round;
+#endif
+
+  std::map<wali::Key, sem_elem_t> round_nu;
+  for(std::set<wali::Key>::const_iterator it = entries.begin(); it != entries.end(); it++) {
+    wali::wfa::Trans t;
+    if(fa_round_ps->find(program, wali::WALI_EPSILON, GetNewtonAcceptingKey(*it), t))
+      round_nu[*it] = t.weight();
+  }
+  delete fa_round_ps;
+  return round_nu;
+}
+
+// Build the WPDS for the queries. The calls to the entry of a callee in the same SCC of the call graph
+// close a cycle without a back edge, so they are widening rules.
+wali::wpds::WPDS* BuildNewtonQueryPds(llvm_abstract_transformer::WrappedDomainWPDSCreator& cr, const wali::wpds::WPDS* pds, 
+                                      const std::vector<wali::wpds::rule_t>& rules, const std::map<wali::Key, sem_elem_t>& nu) {
+  std::map<std::string, unsigned> func_to_scc;
+  std::vector<llvm_abstract_transformer::CallGraphSCC> sccs = cr.GetCallGraphSCCs();
+  for(unsigned scc = 0; scc < sccs.size(); scc++) {
+    for(std::vector<llvm::Function*>::const_iterator it = sccs[scc].funcs.begin(); it != sccs[scc].funcs.end(); it++) {
+      func_to_scc[llvm_abstract_transformer::getName(*it)] = scc;
+    }
+  }
+
+  wali::wpds::WPDS* query_pds = CreateEmptyPds(pds);
+  for(std::vector<wali::wpds::rule_t>::const_iterator it = rules.begin(); it != rules.end(); it++) {
+    const wali::wpds::ewpds::ERule* erule = dynamic_cast<const wali::wpds::ewpds::ERule*>(it->get_ptr());
+    assert(erule != NULL);
+    wali::Key p = erule->from_state();
+    if(erule->to_stack1() == wali::WALI_EPSILON)
+      continue;
+    if(erule->to_stack2() == wali::WALI_EPSILON) {
+      AddRule(query_pds, p, erule->from_stack(), erule->to_stack1(), wali::WALI_EPSILON, erule->weight(), NULL);
+      continue;
+    }
+
+    sem_elem_t summary_w = GetSummaryCallWeight(erule, nu);
+    if(summary_w.is_valid())
+      AddRule(query_pds, p, erule->from_stack(), erule->to_stack2(), wali::WALI_EPSILON, summary_w, NULL);
+
+    ref_ptr<AvSemiring> entry_w = new AvSemiring(*dynamic_cast<AvSemiring*>(erule->weight().get_ptr()));
+    std::map<std::string, unsigned>::const_iterator caller_it = func_to_scc.find(cr.GetFunctionName(erule->from_stack()));
+    std::map<std::string, unsigned>::const_iterator callee_it = func_to_scc.find(cr.GetFunctionName(erule->to_stack1()));
+    if(caller_it == func_to_scc.end() || callee_it == func_to_scc.end() || caller_it->second == callee_it->second)
+      entry_w->setWideningType(WIDENING_RULE);
+    AddRule(query_pds, p, erule->from_stack(), erule->to_stack1(), wali::WALI_EPSILON, entry_w.get_ptr(), NULL);
+  }
+  return query_pds;
+}
+
+// The automaton that holds the summaries nu in a checkpoint: the weight of the transition
+// (program, entry, accepting state of entry) is the summary of entry
+wali::wfa::WFA* BuildNewtonSummaryAutomaton(const std::map<wali::Key, sem_elem_t>& nu, wali::Key program, sem_elem_t prototype) {
+  wali::wfa::WFA* fa_nu = new wali::wfa::WFA();
+  fa_nu->addState(program, prototype->zero());
+  fa_nu->setInitialState(program);
+  for(std::map<wali::Key, sem_elem_t>::const_iterator it = nu.begin(); it != nu.end(); it++) {
+    wali::Key accepting = GetNewtonAcceptingKey(it->first);
+    fa_nu->addState(accepting, prototype->zero());
+    fa_nu->addFinalState(accepting);
+    fa_nu->addTrans(program, it->first, accepting, it->second);
+  }
+  return fa_nu;
+}
+
+// Saturate fa_out from fa_prog (which can be the same automaton) with Newton rounds. The rounds start from
+// the summaries nu after num_rounds rounds, which are empty and 0 unless resuming from a checkpoint.
+// Returns the number of rounds.
+unsigned NewtonPoststar(llvm_abstract_transformer::WrappedDomainWPDSCreator& cr, wali::wpds::WPDS* pds, 
+                        wali::wfa::WFA& fa_prog, wali::wfa::WFA& fa_out, 
+                        std::map<wali::Key, sem_elem_t> nu, unsigned num_rounds) {
+  wali::wpds::RuleCollector rc;
+  pds->for_each(rc);
+  if(rc.rules_.size() == 0) {
+    pds->poststar(fa_prog, fa_out);
+    return 0;
+  }
+  sem_elem_t prototype = rc.rules_[0]->weight();
+
+  // The procedures with a summary are the callees
+  std::set<wali::Key> entries;
+  for(std::vector<wali::wpds::rule_t>::const_iterator it = rc.rules_.begin(); it != rc.rules_.end(); it++) {
+    if((*it)->to_stack2() != wali::WALI_EPSILON)
+      entries.insert((*it)->to_stack1());
+  }
+
+  bool changed = (entries.size() != 0);
+  while(changed) {
+    num_rounds++;
+    utils::Timer round_timer("newton_round", std::cout, false);
+    wali::wpds::WPDS* lin_pds = BuildNewtonLinearization(pds, rc.rules_, nu);
+    std::map<wali::Key, sem_elem_t> round_nu = SolveNewtonRound(lin_pds, entries, cr.GetProgramKey(), prototype);
+    delete lin_pds;
+
+    changed = false;
+    for(std::map<wali::Key, sem_elem_t>::const_iterator it = round_nu.begin(); it != round_nu.end(); it++) {
+      std::map<wali::Key, sem_elem_t>::iterator nu_it = nu.find(it->first);
+      if(nu_it == nu.end()) {
+        nu[it->first] = it->second;
+        changed = true;
+        continue;
+      }
+      ref_ptr<AvSemiring> round_w = new AvSemiring(*dynamic_cast<AvSemiring*>(it->second.get_ptr()));
+      if(num_rounds > 1)
+        round_w->setWideningType(WIDENING_WEIGHT);
+      sem_elem_t new_w = nu_it->second->combine(round_w.get_ptr());
+      if(!new_w->equal(nu_it->second)) {
+        nu_it->second = new_w;
+        changed = true;
+      }
+    }
+    std::cout << "\nNewton round " << num_rounds << " took " << round_timer.elapsed() << "s" << std::flush;
+
+    // The summaries are consistent between rounds
+    if(changed && IsCheckpointDue()) {
+      wali::wfa::WFA* fa_nu = BuildNewtonSummaryAutomaton(nu, cr.GetProgramKey(), prototype);
+      WriteCheckpoint("newton", num_rounds, *fa_nu);
+      delete fa_nu;
+    }
+  }
+
+  wali::wpds::WPDS* query_pds = BuildNewtonQueryPds(cr, pds, rc.rules_, nu);
+  query_pds->poststar(fa_prog, fa_out);
+  delete query_pds;
+  return num_rounds;
+}
+
+// The outcome of abstractInterp, used to chain the tiers of a tiered analysis
+struct AnalysisResult {
+  std::set<wali::Key> proved_keys;     // Proved assertions, including array bounds checks
+  std::set<std::string> unproved_funcs; // Functions containing an unproved assertion
+};
+
+// Remove from keys the ones already proved by prev_tier, and return those
+std::set<wali::Key> RemoveProvedKeys(std::set<wali::Key>& keys, const AnalysisResult* prev_tier) {
+  std::set<wali::Key> proved_keys;
+  if(prev_tier == NULL)
+    return proved_keys;
+  for(std::set<wali::Key>::const_iterator it = prev_tier->proved_keys.begin(); it != prev_tier->proved_keys.end(); it++) {
+    if(keys.erase(*it) != 0)
+      proved_keys.insert(*it);
+  }
+  return proved_keys;
+}
+
 // Perform abstract interpretation on a module
-void abstractInterp(std::unique_ptr<Module>& M, unsigned max_disjunctions, std::string filename) {
+// If prev_tier is given, only the assertions it did not prove are queried, and the functions which are not
+// on a call chain leading to them are analyzed with octagonal precision.
+AnalysisResult abstractInterp(std::unique_ptr<Module>& M, unsigned max_disjunctions, std::string filename, const AnalysisResult* prev_tier = NULL) {
   std::ofstream result_file(filename + std::string(".result"));
 
   std::stringstream ss_timer;
@@ -484,17 +1386,27 @@ void abstractInterp(std::unique_ptr<Module>& M, unsigned max_disjunctions, std::
   dum_voc.insert(DimensionKey(std::string("tmp"), 0, utils::thirty_two));
 
   BitpreciseWrappedAbstractValue::disable_wrapping = cmdlineparam_disable_wrapping;
+  AvSemiring::max_constraints_ = cmdlineparam_constraint_budget;
+  AvSemiring::widening_delay_ = cmdlineparam_widening_delay;
+  AvSemiring::widening_counts_.clear();
+  PP_CPOLY_AV::box_filter = cmdlineparam_box_filter;
+  PP_CPOLY_AV::lazy_merge_limit = cmdlineparam_lazy_merge_limit;
   // Use pointset powerset of octagon or polyhedra domain to perform analysis
   std::cout << "\nUsing the base domain of ";
   ref_ptr<AbstractValue> av; 
   if(cmdlineparam_use_red_prod) {
     if(cmdlineparam_use_oct) {
       std::cout << "ReducedProduct<octagons, Equalities>";
-      PP_OCT_AV::max_disjunctions = cmdlineparam_max_disjunctions;
-      PP_OCT_AV::use_extrapolation = cmdlineparam_use_extrapolation;
-      PP_CPOLY_AV::max_disjunctions = 1; // equality domain is not allowed to use disjunctions
-      PP_CPOLY_AV::use_extrapolation = cmdlineparam_use_extrapolation;
-      av = new ReducedProductAbsVal(new PP_OCT_AV(dum_voc), new PP_CPOLY_AV(dum_voc, true, true/*equalities_only*/));
+      ref_ptr<AbstractValue> oct_av = CreateOctagonAv(*M, dum_voc);
+      ReducedProductAbsVal::reduction_rounds = cmdlineparam_reduction_rounds;
+      if(cmdlineparam_affine_equalities) {
+        std::cout << " with affine equalities";
+        av = new ReducedProductAbsVal(oct_av, new AffineEqualityAv(dum_voc));
+      } else {
+        PP_CPOLY_AV::max_disjunctions = 1; // equality domain is not allowed to use disjunctions
+        PP_CPOLY_AV::use_extrapolation = cmdlineparam_use_extrapolation;
+        av = new ReducedProductAbsVal(oct_av, new PP_CPOLY_AV(dum_voc, true, true/*equalities_only*/));
+      }
     } else {
       std::cout << "ReducedProduct not needed for polyhedra. Using polyhedra.";
       PP_CPOLY_AV::max_disjunctions = cmdlineparam_max_disjunctions;
@@ -504,9 +1416,7 @@ void abstractInterp(std::unique_ptr<Module>& M, unsigned max_disjunctions, std::
   } else {
     if(cmdlineparam_use_oct) {
       std::cout << "octagons";
-      PP_OCT_AV::max_disjunctions = cmdlineparam_max_disjunctions;
-      PP_OCT_AV::use_extrapolation = cmdlineparam_use_extrapolation;
-      av = new PP_OCT_AV(dum_voc);
+      av = CreateOctagonAv(*M, dum_voc);
     } else {
       std::cout << "polyhedra";
       PP_CPOLY_AV::max_disjunctions = cmdlineparam_max_disjunctions;
@@ -518,10 +1428,21 @@ void abstractInterp(std::unique_ptr<Module>& M, unsigned max_disjunctions, std::
 
   utils::Timer wpds_construct_timer("wpds_construction", std::cout, false);
   llvm_abstract_transformer::WrappedDomainWPDSCreator cr(std::move(M), av, filename, cmdlineparam_array_bounds_check);
+  if(prev_tier != NULL) {
+    cr.DegradeOutsideCallChains(prev_tier->unproved_funcs, llvm_abstract_transformer::OCTAGONAL_CONSTRAINTS);
+  }
   wali::wpds::WPDS* pds = cr.createWPDS(cmdlineparam_use_fwpds);
   double wpds_construction_time = wpds_construct_timer.elapsed();
   std::cout << "\nWPDS construction time:" << wpds_construction_time;
 
+  // The rules are built with max_disjunctions, the adaptive limits only apply to post*
+  if(cmdlineparam_adaptive_disjunctions || cmdlineparam_escalate_disjunctions != 0) {
+    SetDisjunctLimits(cr.GetDisjunctRelevantKeys(), cmdlineparam_max_disjunctions);
+  }
+  AvSemiring::max_disjuncts_hook_ = NULL;
+  if(cmdlineparam_escalate_disjunctions > cmdlineparam_max_disjunctions)
+    AvSemiring::max_disjuncts_hook_ = SetDomainMaxDisjunctions;
+
   // Print PDS and its stats for debugging reasons
   std::cout << "\nWPDS Statistics:" << std::endl;
   pds->printStatistics(std::cout);
@@ -535,6 +1456,27 @@ void abstractInterp(std::unique_ptr<Module>& M, unsigned max_disjunctions, std::
 
   wali::wfa::WFA* fa_prog = cr.BuildAutomaton(false/*is_backward*/, &std::cout);
 
+  // Seed the query automaton with the surviving transitions of the previous fixpoint
+  unsigned num_seeded_trans = 0;
+  if(cmdlineparam_incremental_fixpoint_file.size() != 0) {
+    num_seeded_trans = cr.SeedAutomatonFromFixpoint(fa_prog, GetFixpointConfig(), cmdlineparam_incremental_fixpoint_file);
+  }
+  // A checkpoint of the same program supersedes the fixpoint of a previous version
+  std::map<wali::Key, sem_elem_t> resumed_nu;
+  unsigned resumed_num_rounds = 0;
+  if(cmdlineparam_resume_file.size() != 0) {
+    num_seeded_trans += ResumeFromCheckpoint(cr, fa_prog, resumed_nu, resumed_num_rounds);
+  }
+
+  // Seed the query automaton with the bottom-up summaries of the call graph SCCs
+  // The work is done by the workers, so the wall clock time is reported
+  long summary_start_time = utils::myclock();
+  unsigned num_summarized_sccs = 0;
+  if(cmdlineparam_bottom_up) {
+    num_seeded_trans += ComputeBottomUpSummaries(cr, pds, fa_prog, num_summarized_sccs);
+  }
+  double summary_time = (utils::myclock() - summary_start_time) / 1000000.0;
+
   if(debug_print_level >= DBG_PRINT_OVERVIEW) {
     std::cout << "\nThe query Automaton is:" << std::endl;
     fa_prog->print(std::cout);
@@ -606,6 +1548,11 @@ void abstractInterp(std::unique_ptr<Module>& M, unsigned max_disjunctions, std::
     cmdlineparam_allow_phis_str = "true";
   input_stats_map.push_back(std::make_pair("Allow phis", cmdlineparam_allow_phis_str));
 
+  if(cmdlineparam_incremental_fixpoint_file.size() != 0 || cmdlineparam_resume_file.size() != 0 || cmdlineparam_bottom_up) {
+    ss.str(std::string()); ss << num_seeded_trans;
+    input_stats_map.push_back(std::make_pair("Num Reused Transitions", ss.str()));
+  }
+
   // Get vocabulary size information
   std::pair<size_t, size_t> min_max_voc_size = cr.GetMinMaxVocSize();
   ss.str(std::string()); ss << min_max_voc_size.first;
@@ -613,6 +1560,16 @@ void abstractInterp(std::unique_ptr<Module>& M, unsigned max_disjunctions, std::
   ss.str(std::string()); ss << min_max_voc_size.second;
   input_stats_map.push_back(std::make_pair("Max voc size", ss.str()));
 
+  if(cmdlineparam_compress_chains) {
+    ss.str(std::string()); ss << cr.GetNumCompressedKeys();
+    result_map.push_back(std::make_pair("Num Compressed Keys", ss.str()));
+  }
+
+  if(cmdlineparam_interval_preanalysis) {
+    ss.str(std::string()); ss << cr.GetNumNoWrapDims();
+    result_map.push_back(std::make_pair("Num No-Wrap Dims", ss.str()));
+  }
+
   // Assertion information
   std::set<wali::Key> unreachable_keys = cr.GetUnreachableKeys();
   ss.str(std::string()); ss << unreachable_keys.size();
@@ -635,11 +1592,34 @@ void abstractInterp(std::unique_ptr<Module>& M, unsigned max_disjunctions, std::
  
   /********************************Poststar*******************************/
   utils::Timer poststar_timer("poststar", std::cout, false);
+  budget_cr = &cr;
+  AvSemiring::combine_hook_ = &BudgetHook;
+  unsigned num_newton_rounds = 0;
+  StartCheckpointing(&cr);
 #ifdef USE_AKASH_FWPDS
-  pds->poststar(*fa_prog, *fa_prog);
+  if(cmdlineparam_checkpoint_file.size() != 0 && !cmdlineparam_newton)
+    pds->setWorklist(new CheckpointingWorklist(*fa_prog));
+  if(cmdlineparam_newton)
+    num_newton_rounds = NewtonPoststar(cr, pds, *fa_prog, *fa_prog, resumed_nu, resumed_num_rounds);
+  else
+    pds->poststar(*fa_prog, *fa_prog);
 #else
-  fa_prog = new wali::wfa::WFA(pds->poststar(*fa_prog));
+  wali::wfa::WFA* fa_poststar = new wali::wfa::WFA();
+  if(cmdlineparam_checkpoint_file.size() != 0 && !cmdlineparam_newton)
+    pds->setWorklist(new CheckpointingWorklist(*fa_poststar));
+  if(cmdlineparam_newton)
+    num_newton_rounds = NewtonPoststar(cr, pds, *fa_prog, *fa_poststar, resumed_nu, resumed_num_rounds);
+  else
+    pds->poststar(*fa_prog, *fa_poststar);
+  delete fa_prog;
+  fa_prog = fa_poststar;
 #endif
+  if(cmdlineparam_checkpoint_file.size() != 0) {
+    WriteCheckpoint("poststar_done", num_newton_rounds, *fa_prog);
+  }
+  StopCheckpointing();
+  AvSemiring::combine_hook_ = NULL;
+  budget_cr = NULL;
 
   double poststar_time = poststar_timer.elapsed();
 
@@ -651,6 +1631,10 @@ void abstractInterp(std::unique_ptr<Module>& M, unsigned max_disjunctions, std::
   fa_prog->for_each(tf_ps);
   std::cout  << std::dec << "\nThe number of transitions in the WFA after poststar is " << tf_ps.getNumTrans() << std::endl;
 
+  if(cmdlineparam_incremental_fixpoint_file.size() != 0) {
+    cr.SaveFixpoint(*fa_prog, GetFixpointConfig(), cmdlineparam_incremental_fixpoint_file);
+  }
+
   if(debug_print_level >= DBG_PRINT_OVERVIEW) {
     std::cout << "\nThe poststar Automaton is:" << std::endl;
     fa_prog->print(std::cout);
@@ -680,7 +1664,9 @@ void abstractInterp(std::unique_ptr<Module>& M, unsigned max_disjunctions, std::
 
   /**************************Perform Downward Iteration Sequence********************/
   utils::Timer dis_timer("Downward Iteration Sequence", std::cout, false);
-  if(cmdlineparam_perform_narrowing) {
+  if(cmdlineparam_perform_narrowing && cmdlineparam_newton) {
+    std::cout << "\nSkipping the downward iteration sequence, as it replays the chaotic post* of the program WPDS.";
+  } else if(cmdlineparam_perform_narrowing) {
     // TODO: Move the downward iteration sequence to a separate function
     // Copy wfa to a new wfa where the new wfa has witness weights
     wali::wfa::TransCopierWithWitness tcww(*fa_prog);
@@ -737,41 +1723,77 @@ void abstractInterp(std::unique_ptr<Module>& M, unsigned max_disjunctions, std::
   /***********************************Query***********************************/
   // Get the total number of proved assertions in the program in proved_unreachable_keys
   utils::Timer query_timer("Query", std::cout, false);
-  std::set<wali::Key> proved_unreachable_keys;
-  for(std::set<wali::Key>::const_iterator it = unreachable_keys.begin(); it != unreachable_keys.end(); it++) {
-    wali::Key unreachable_key = *it;
-    sem_elem_t path_sum = GetPathSummary(fa_prog, cr.GetProgramKey(), unreachable_key);
-    assert(path_sum != NULL);
-    if(debug_print_level >= DBG_PRINT_OVERVIEW) { 
-      path_sum->print(std::cout << "\nWeight for the unreachable key " << wali::key2str(unreachable_key) << " is:\n");
-    }
-    if(path_sum->equal(path_sum->zero())) {
-      std::cout << "\nThe unreachable key " << wali::key2str(unreachable_key) << " is proved to be unreachable by the wrapped domain analysis.";
-      proved_unreachable_keys.insert(unreachable_key);
-    }
-  }
+  std::set<wali::Key> keys_to_query = unreachable_keys;
+  std::set<wali::Key> prev_proved_keys = RemoveProvedKeys(keys_to_query, prev_tier);
+  std::set<wali::Key> proved_unreachable_keys = GetProvedUnreachableKeys(fa_prog, cr.GetProgramKey(), keys_to_query, "");
+  proved_unreachable_keys.insert(prev_proved_keys.begin(), prev_proved_keys.end());
 
   std::set<wali::Key> proved_unreachable_array_bounds_check_keys;
   if(cmdlineparam_array_bounds_check) {
-    for(std::set<wali::Key>::const_iterator it = unreachable_array_bounds_check_keys.begin(); it != unreachable_array_bounds_check_keys.end(); it++) {
-      wali::Key unreachable_key = *it;
-      sem_elem_t path_sum = GetPathSummary(fa_prog, cr.GetProgramKey(), unreachable_key);
-      assert(path_sum != NULL);
-      if(debug_print_level >= DBG_PRINT_OVERVIEW) { 
-        path_sum->print(std::cout << "\nWeight for the unreachable key " << wali::key2str(unreachable_key) << " is:\n");
-      }
-      if(path_sum->equal(path_sum->zero())) {
-        std::cout << "\nThe unreachable key " << wali::key2str(unreachable_key) << " for array bound checking is proved to be unreachable by the wrapped domain analysis.";
-        proved_unreachable_array_bounds_check_keys.insert(unreachable_key);
-      }
-    }
+    keys_to_query = unreachable_array_bounds_check_keys;
+    prev_proved_keys = RemoveProvedKeys(keys_to_query, prev_tier);
+    proved_unreachable_array_bounds_check_keys = GetProvedUnreachableKeys(fa_prog, cr.GetProgramKey(), keys_to_query, " for array bound checking");
+    proved_unreachable_array_bounds_check_keys.insert(prev_proved_keys.begin(), prev_proved_keys.end());
   }
 
   double query_time = query_timer.elapsed();
+
+  /*****************************Escalate disjunct limits****************************/
+  // While some assertions remain unproved, double the disjunct limit at the points relevant to them
+  // and rerun post* on a fresh automaton to query them again
+  utils::Timer escalation_timer("Escalation", std::cout, false);
+  unsigned num_escalations = 0;
+  if(cmdlineparam_escalate_disjunctions != 0) {
+    std::set<wali::Key> unproved_keys;
+    std::set_difference(unreachable_keys.begin(), unreachable_keys.end(), proved_unreachable_keys.begin(), proved_unreachable_keys.end(), 
+                        std::inserter(unproved_keys, unproved_keys.begin()));
+    unsigned limit = std::max(cmdlineparam_max_disjunctions, 1u);
+    while(unproved_keys.size() != 0 && limit < cmdlineparam_escalate_disjunctions) {
+      limit = std::min(2 * limit, cmdlineparam_escalate_disjunctions);
+      num_escalations++;
+      std::cout << "\nEscalating the disjunct limit to " << limit << " for " << unproved_keys.size() << " unproved assertions.";
+      // Each round starts from the limits and the widening delays of the first post*
+      AvSemiring::widening_counts_.clear();
+      AvSemiring::disjunct_limits_.clear();
+      SetDisjunctLimits(cr.GetDisjunctRelevantKeys(), cmdlineparam_max_disjunctions);
+      SetDisjunctLimits(cr.GetDisjunctRelevantKeys(unproved_keys), limit);
+
+      wali::wfa::WFA* fa_esc = cr.BuildAutomaton(false/*is_backward*/, &std::cout);
+      wali::wfa::WFA fa_esc_ps;
+      pds->poststar(*fa_esc, fa_esc_ps);
+      fa_esc_ps.path_summary();
+      delete fa_esc;
+
+      std::set<wali::Key> esc_proved_keys = GetProvedUnreachableKeys(&fa_esc_ps, cr.GetProgramKey(), unproved_keys, "");
+      for(std::set<wali::Key>::const_iterator it = esc_proved_keys.begin(); it != esc_proved_keys.end(); it++) {
+        proved_unreachable_keys.insert(*it);
+        unproved_keys.erase(*it);
+      }
+    }
+  }
+  double escalation_time = escalation_timer.elapsed();
   std::cout << "\nquery_time:" << query_time << std::endl;
   std::cout << "\n\nTotal number of assertions:" << unreachable_keys.size();
   std::cout << "\nTotal number of proved assertions:" << proved_unreachable_keys.size() << "\n";
 
+  if(cr.GetDegradedFunctions().size() != 0) {
+    std::map<std::string, llvm_abstract_transformer::DegradationLevel> degraded_funcs = cr.GetDegradedFunctions();
+    std::cout << "\nFunctions analyzed with degraded precision due to budgets:";
+    for(std::map<std::string, llvm_abstract_transformer::DegradationLevel>::const_iterator it = degraded_funcs.begin(); it != degraded_funcs.end(); it++) {
+      std::cout << "\n  " << it->first << ": " << llvm_abstract_transformer::DegradationLevelName(it->second);
+    }
+    std::cout << "\n";
+  }
+
+  if(cr.GetCallChainDegradedFunctions().size() != 0) {
+    std::map<std::string, llvm_abstract_transformer::DegradationLevel> call_chain_degraded_funcs = cr.GetCallChainDegradedFunctions();
+    std::cout << "\nFunctions analyzed with degraded precision off the call chains of the unproved assertions:";
+    for(std::map<std::string, llvm_abstract_transformer::DegradationLevel>::const_iterator it = call_chain_degraded_funcs.begin(); it != call_chain_degraded_funcs.end(); it++) {
+      std::cout << "\n  " << it->first << ": " << llvm_abstract_transformer::DegradationLevelName(it->second);
+    }
+    std::cout << "\n";
+  }
+
   if(cmdlineparam_array_bounds_check) {
     std::cout << "\n\nTotal number of array_bounds_check assertions:" << unreachable_array_bounds_check_keys.size();
     std::cout << "\nTotal number of proved array_bounds_check assertions:" << proved_unreachable_array_bounds_check_keys.size() << "\n";
@@ -788,6 +1810,18 @@ void abstractInterp(std::unique_ptr<Module>& M, unsigned max_disjunctions, std::
   ss.str(std::string()); ss << wpds_construction_time;
   result_map.push_back(std::make_pair("WPDS build time", ss.str()));
 
+  if(cmdlineparam_bottom_up) {
+    ss.str(std::string()); ss << summary_time;
+    result_map.push_back(std::make_pair("summary time", ss.str()));
+    ss.str(std::string()); ss << num_summarized_sccs;
+    result_map.push_back(std::make_pair("Num Summarized SCCs", ss.str()));
+  }
+
+  if(cmdlineparam_newton) {
+    ss.str(std::string()); ss << num_newton_rounds;
+    result_map.push_back(std::make_pair("Num Newton Rounds", ss.str()));
+  }
+
   ss.str(std::string()); ss << poststar_time;
   result_map.push_back(std::make_pair("post* time", ss.str()));
 
@@ -800,6 +1834,51 @@ void abstractInterp(std::unique_ptr<Module>& M, unsigned max_disjunctions, std::
   ss.str(std::string()); ss << query_time;
   result_map.push_back(std::make_pair("query time", ss.str()));
 
+  if(cmdlineparam_escalate_disjunctions != 0) {
+    ss.str(std::string()); ss << escalation_time;
+    result_map.push_back(std::make_pair("escalation time", ss.str()));
+    ss.str(std::string()); ss << num_escalations;
+    result_map.push_back(std::make_pair("Num Escalations", ss.str()));
+  }
+
+  // Budget information
+  std::map<std::string, llvm_abstract_transformer::DegradationLevel> degraded_funcs = cr.GetDegradedFunctions();
+  ss.str(std::string()); ss << degraded_funcs.size();
+  result_map.push_back(std::make_pair("Num Degraded Funcs", ss.str()));
+  ss.str(std::string());
+  for(std::map<std::string, llvm_abstract_transformer::DegradationLevel>::const_iterator it = degraded_funcs.begin(); it != degraded_funcs.end(); it++) {
+    if(it != degraded_funcs.begin())
+      ss << " ";
+    ss << it->first << ":" << llvm_abstract_transformer::DegradationLevelName(it->second);
+  }
+  result_map.push_back(std::make_pair("Degraded Funcs", ss.str()));
+  result_map.push_back(std::make_pair("Degraded post*", poststar_degraded ? "true" : "false"));
+
+  // Tiered analysis information
+  if(prev_tier != NULL) {
+    std::map<std::string, llvm_abstract_transformer::DegradationLevel> call_chain_degraded_funcs = cr.GetCallChainDegradedFunctions();
+    ss.str(std::string()); ss << call_chain_degraded_funcs.size();
+    result_map.push_back(std::make_pair("Num Call Chain Degraded Funcs", ss.str()));
+    ss.str(std::string());
+    for(std::map<std::string, llvm_abstract_transformer::DegradationLevel>::const_iterator it = call_chain_degraded_funcs.begin(); it != call_chain_degraded_funcs.end(); it++) {
+      if(it != call_chain_degraded_funcs.begin())
+        ss << " ";
+      ss << it->first << ":" << llvm_abstract_transformer::DegradationLevelName(it->second);
+    }
+    result_map.push_back(std::make_pair("Call Chain Degraded Funcs", ss.str()));
+  }
+
+  // Slicing information
+  if(cmdlineparam_slice) {
+    llvm_abstract_transformer::SliceStats slice_stats = cr.GetSliceStats();
+    ss.str(std::string()); ss << slice_stats.num_funcs;
+    result_map.push_back(std::make_pair("Num Sliced Funcs", ss.str()));
+    ss.str(std::string()); ss << slice_stats.num_bbs;
+    result_map.push_back(std::make_pair("Num Sliced BBs", ss.str()));
+    ss.str(std::string()); ss << slice_stats.num_dims;
+    result_map.push_back(std::make_pair("Num Sliced Dims", ss.str()));
+  }
+
   // Assertion information
   ss.str(std::string()); ss << proved_unreachable_keys.size();
   result_map.push_back(std::make_pair("Num Proved Assertions", ss.str()));
@@ -818,8 +1897,95 @@ void abstractInterp(std::unique_ptr<Module>& M, unsigned max_disjunctions, std::
   result_file << "}";
   result_file.close();
 
+  AnalysisResult result;
+  result.proved_keys = proved_unreachable_keys;
+  result.proved_keys.insert(proved_unreachable_array_bounds_check_keys.begin(), proved_unreachable_array_bounds_check_keys.end());
+  std::set<wali::Key> all_keys = unreachable_keys;
+  all_keys.insert(unreachable_array_bounds_check_keys.begin(), unreachable_array_bounds_check_keys.end());
+  for(std::set<wali::Key>::const_iterator it = all_keys.begin(); it != all_keys.end(); it++) {
+    if(result.proved_keys.find(*it) == result.proved_keys.end())
+      result.unproved_funcs.insert(cr.GetFunctionName(*it));
+  }
+
   delete pds;
   delete fa_prog;
+  return result;
+}
+
+// The options of the first tier of a tiered analysis
+//
+// Constructing a Tier1Options saves the command line options the first tier overrides and sets the cheap
+// configuration, without any file shared with the second tier. Destroying it restores the options and
+// clears the post* state of the first tier.
+class Tier1Options {
+public:
+  Tier1Options() :
+    use_oct_(cmdlineparam_use_oct),
+    use_red_prod_(cmdlineparam_use_red_prod),
+    max_disjunctions_(cmdlineparam_max_disjunctions),
+    escalate_disjunctions_(cmdlineparam_escalate_disjunctions),
+    adaptive_disjunctions_(cmdlineparam_adaptive_disjunctions),
+    incremental_fixpoint_file_(cmdlineparam_incremental_fixpoint_file),
+    checkpoint_file_(cmdlineparam_checkpoint_file),
+    resume_file_(cmdlineparam_resume_file) {
+    cmdlineparam_use_oct = true;
+    cmdlineparam_use_red_prod = false;
+    cmdlineparam_max_disjunctions = 1;
+    cmdlineparam_escalate_disjunctions = 0;
+    cmdlineparam_adaptive_disjunctions = false;
+    cmdlineparam_incremental_fixpoint_file = cmdlineparam_checkpoint_file = cmdlineparam_resume_file = "";
+  }
+
+  ~Tier1Options() {
+    cmdlineparam_use_oct = use_oct_;
+    cmdlineparam_use_red_prod = use_red_prod_;
+    cmdlineparam_max_disjunctions = max_disjunctions_;
+    cmdlineparam_escalate_disjunctions = escalate_disjunctions_;
+    cmdlineparam_adaptive_disjunctions = adaptive_disjunctions_;
+    cmdlineparam_incremental_fixpoint_file = incremental_fixpoint_file_;
+    cmdlineparam_checkpoint_file = checkpoint_file_;
+    cmdlineparam_resume_file = resume_file_;
+    AvSemiring::coarsen_all_ = false;
+    poststar_degraded = false;
+    AvSemiring::disjunct_limits_.clear();
+    AvSemiring::default_disjunct_limit_ = 0;
+  }
+
+private:
+  Tier1Options(const Tier1Options&);
+  Tier1Options& operator=(const Tier1Options&);
+
+  bool use_oct_, use_red_prod_;
+  unsigned max_disjunctions_, escalate_disjunctions_;
+  bool adaptive_disjunctions_;
+  std::string incremental_fixpoint_file_, checkpoint_file_, resume_file_;
+};
+
+// Tiered analysis
+//
+// The first tier analyzes a copy of the module with octagons and a single disjunct. If it leaves some
+// assertions unproved, the second tier analyzes the module with the domain given on the command line, only
+// queries the unproved assertions, and analyzes the functions off the call chains leading to them with
+// octagonal precision. The first tier writes its results to <filename>_tier1.result.
+void tieredAbstractInterp(std::unique_ptr<Module>& M, std::string filename) {
+  AnalysisResult cheap_result;
+  {
+    std::unique_ptr<Module> M_cheap(CloneModule(M.get()));
+    Tier1Options tier1_options;
+    std::cout << "\nTier 1: Analyzing with octagons and a single disjunct.";
+    cheap_result = abstractInterp(M_cheap, 1, filename + "_tier1");
+  }
+
+  std::cout << "\nTier 1 proved " << cheap_result.proved_keys.size() << " assertions, " 
+            << cheap_result.unproved_funcs.size() << " functions contain unproved assertions.";
+  if(cheap_result.unproved_funcs.size() == 0) {
+    std::cout << "\nAll assertions are proved by tier 1, skipping tier 2.";
+    std::rename((filename + "_tier1.result").c_str(), (filename + ".result").c_str());
+    return;
+  }
+
+  std::cout << "\nTier 2: Analyzing the unproved assertions with the given domain.";
+  abstractInterp(M, cmdlineparam_max_disjunctions, filename, &cheap_result);
 }
 
 int main(int argc, char* argv[]) 
@@ -844,10 +2010,39 @@ int main(int argc, char* argv[])
       {"perform_narrowing", no_argument, NULL, 'n'},
       {"array_bounds_check", no_argument, NULL, 'a'},
       {"allow_phis", no_argument, NULL, 'p'},
+      {"incremental", required_argument, NULL, 'i'},
+      {"checkpoint", required_argument, NULL, 'c'},
+      {"checkpoint_interval", required_argument, NULL, 'I'},
+      {"resume", required_argument, NULL, 'R'},
+      {"function_time_budget", required_argument, NULL, 'F'},
+      {"function_memory_budget", required_argument, NULL, 'H'},
+      {"constraint_budget", required_argument, NULL, 'C'},
+      {"time_budget", required_argument, NULL, 'T'},
+      {"memory_budget", required_argument, NULL, 'M'},
+      {"adaptive_disjunctions", no_argument, NULL, 'A'},
+      {"escalate_disjunctions", required_argument, NULL, 'E'},
+      {"tiered", no_argument, NULL, 't'},
+      {"slice", no_argument, NULL, 'S'},
+      {"bottom_up", no_argument, NULL, 'B'},
+      {"summary_workers", required_argument, NULL, 'W'},
+      {"worker_memory_budget", required_argument, NULL, 'U'},
+      {"newton", no_argument, NULL, 'N'},
+      {"widening_delay", required_argument, NULL, 'D'},
+      {"compress_chains", no_argument, NULL, 'K'},
+      {"interval_preanalysis", no_argument, NULL, 'P'},
+      {"infer_signedness", no_argument, NULL, 'G'},
+      {"symbolic_bb", no_argument, NULL, 'Y'},
+      {"propagation_rounds", required_argument, NULL, 'O'},
+      {"affine_equalities", no_argument, NULL, 'Q'},
+      {"reduction_rounds", required_argument, NULL, 'L'},
+      {"box_filter", no_argument, NULL, 'X'},
+      {"lazy_merge_limit", required_argument, NULL, 'J'},
+      {"int64_coefficients", no_argument, NULL, 'V'},
+      {"bd_shapes", no_argument, NULL, 'Z'},
       {"help", no_argument, NULL, 'h'},
       {0, 0, 0, 0}
     };
-  while ((c = getopt_long (argc, argv, "d:orwf:m:uenaph", long_options, &option_index)) != -1) {
+  while ((c = getopt_long (argc, argv, "d:orwf:m:uenapi:c:I:R:F:H:C:T:M:AE:tSBW:U:ND:KPGYO:QL:XJ:VZh", long_options, &option_index)) != -1) {
     switch (c) {
     case 'd':
       debug_print_level = std::stoul(optarg);
@@ -885,6 +2080,93 @@ int main(int argc, char* argv[])
     case 'p':
       cmdlineparam_allow_phis = true;
       break;
+    case 'i':
+      cmdlineparam_incremental_fixpoint_file = std::string(optarg);
+      break;
+    case 'c':
+      cmdlineparam_checkpoint_file = std::string(optarg);
+      break;
+    case 'I':
+      cmdlineparam_checkpoint_interval = std::stoul(optarg);
+      break;
+    case 'R':
+      cmdlineparam_resume_file = std::string(optarg);
+      break;
+    case 'F':
+      cmdlineparam_function_time_budget = std::stoul(optarg);
+      break;
+    case 'H':
+      cmdlineparam_function_memory_budget = std::stoul(optarg);
+      break;
+    case 'C':
+      cmdlineparam_constraint_budget = std::stoul(optarg);
+      break;
+    case 'T':
+      cmdlineparam_time_budget = std::stoul(optarg);
+      break;
+    case 'M':
+      cmdlineparam_memory_budget = std::stoul(optarg);
+      break;
+    case 'A':
+      cmdlineparam_adaptive_disjunctions = true;
+      break;
+    case 'E':
+      cmdlineparam_escalate_disjunctions = std::stoul(optarg);
+      break;
+    case 't':
+      cmdlineparam_tiered = true;
+      break;
+    case 'S':
+      cmdlineparam_slice = true;
+      break;
+    case 'B':
+      cmdlineparam_bottom_up = true;
+      break;
+    case 'W':
+      cmdlineparam_summary_workers = std::stoul(optarg);
+      break;
+    case 'U':
+      cmdlineparam_worker_memory_budget = std::stoul(optarg);
+      break;
+    case 'N':
+      cmdlineparam_newton = true;
+      break;
+    case 'D':
+      cmdlineparam_widening_delay = std::stoul(optarg);
+      break;
+    case 'K':
+      cmdlineparam_compress_chains = true;
+      break;
+    case 'P':
+      cmdlineparam_interval_preanalysis = true;
+      break;
+    case 'G':
+      cmdlineparam_infer_signedness = true;
+      break;
+    case 'Y':
+      cmdlineparam_symbolic_bb = true;
+      break;
+    case 'O':
+      cmdlineparam_propagation_rounds = std::stoul(optarg);
+      break;
+    case 'Q':
+      cmdlineparam_affine_equalities = true;
+      break;
+    case 'L':
+      cmdlineparam_reduction_rounds = std::stoul(optarg);
+      break;
+    case 'X':
+      cmdlineparam_box_filter = true;
+      break;
+    case 'J':
+      cmdlineparam_lazy_merge_limit = std::stoul(optarg);
+      break;
+    case 'V':
+      cmdlineparam_int64_coefficients = true;
+      break;
+    case 'Z':
+      cmdlineparam_use_bd_shapes = true;
+      break;
     case 'h': 
       {
         std::cout << "Help on options:";
@@ -923,7 +2205,10 @@ int main(int argc, char* argv[])
     return 1;
   }
 
-  abstractInterp(M, cmdlineparam_max_disjunctions, cmdlineparam_filename);
+  if(cmdlineparam_tiered)
+    tieredAbstractInterp(M, cmdlineparam_filename);
+  else
+    abstractInterp(M, cmdlineparam_max_disjunctions, cmdlineparam_filename);
   std::cout << std::flush;
   return 0;
 }
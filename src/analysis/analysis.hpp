@@ -13,5 +13,34 @@ extern bool cmdlineparam_use_extrapolation;
 extern bool cmdlineparam_perform_narrowing;
 extern bool cmdlineparam_array_bounds_check;
 extern bool cmdlineparam_allow_phis;
+extern std::string cmdlineparam_incremental_fixpoint_file;
+extern std::string cmdlineparam_checkpoint_file;
+extern unsigned cmdlineparam_checkpoint_interval;
+extern std::string cmdlineparam_resume_file;
+extern unsigned cmdlineparam_function_time_budget;
+extern unsigned cmdlineparam_function_memory_budget;
+extern unsigned cmdlineparam_constraint_budget;
+extern unsigned cmdlineparam_time_budget;
+extern unsigned cmdlineparam_memory_budget;
+extern bool cmdlineparam_adaptive_disjunctions;
+extern unsigned cmdlineparam_escalate_disjunctions;
+extern bool cmdlineparam_tiered;
+extern bool cmdlineparam_slice;
+extern bool cmdlineparam_bottom_up;
+extern unsigned cmdlineparam_summary_workers;
+extern unsigned cmdlineparam_worker_memory_budget;
+extern bool cmdlineparam_newton;
+extern unsigned cmdlineparam_widening_delay;
+extern bool cmdlineparam_compress_chains;
+extern bool cmdlineparam_interval_preanalysis;
+extern bool cmdlineparam_infer_signedness;
+extern bool cmdlineparam_symbolic_bb;
+extern unsigned cmdlineparam_propagation_rounds;
+extern bool cmdlineparam_affine_equalities;
+extern unsigned cmdlineparam_reduction_rounds;
+extern bool cmdlineparam_box_filter;
+extern unsigned cmdlineparam_lazy_merge_limit;
+extern bool cmdlineparam_int64_coefficients;
+extern bool cmdlineparam_use_bd_shapes;
 
 #endif // src_analysis_analysis_hpp
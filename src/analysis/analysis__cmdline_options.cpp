@@ -31,4 +31,119 @@ bool cmdlineparam_allow_phis = false;
 
 unsigned cmdlineparam_max_disjunctions = 1;
 
+// Cmdline parameter specifying the file used to save the fixpoint for incremental analysis.
+// If the file holds the fixpoint of a previous run, the transitions of unchanged functions
+// are used to seed post*. The new fixpoint is saved to the file after post*.
+// Empty string disables incremental analysis.
+std::string cmdlineparam_incremental_fixpoint_file;
+
+// Cmdline parameter specifying the file to which post* is periodically checkpointed, so that a long run that
+// gets preempted can be continued with --resume: the procedure summaries computed by --newton between rounds,
+// and the automaton of a chaotic post* between two worklist items. A final checkpoint is written once post*
+// completes. Empty string disables checkpointing.
+std::string cmdlineparam_checkpoint_file;
+
+// Number of seconds (wall clock) between two checkpoints.
+unsigned cmdlineparam_checkpoint_interval = 600;
+
+// Cmdline parameter specifying a checkpoint to continue from. The Newton rounds continue from the saved
+// summaries, and the transitions of a final checkpoint, or the root frame transitions of a partial one, seed
+// post*. Empty string starts the analysis afresh.
+std::string cmdlineparam_resume_file;
+
+// Resource budgets. A value of 0 disables the corresponding budget.
+// Functions whose WPDS rules take longer than cmdlineparam_function_time_budget seconds or more than
+// cmdlineparam_function_memory_budget MB to build, or whose weights have more than
+// cmdlineparam_constraint_budget constraints, are analyzed with a degraded precision: fewer disjuncts,
+// then octagonal constraints, then havoc of the dimensions not used in comparisons, calls and returns.
+// The constraint budget also applies to the weights computed by post*.
+// While the analysis exceeds cmdlineparam_time_budget seconds or cmdlineparam_memory_budget MB of resident
+// memory, the work is done at the most degraded precision.
+// The degraded functions are reported in the result file.
+unsigned cmdlineparam_function_time_budget = 0;
+unsigned cmdlineparam_function_memory_budget = 0;
+unsigned cmdlineparam_constraint_budget = 0;
+unsigned cmdlineparam_time_budget = 0;
+unsigned cmdlineparam_memory_budget = 0;
+
+// Cmdline parameter specifying whether to use adaptive disjunct limits during post*: only the loop heads
+// and latches and the points near assertions keep max_disjunctions disjuncts, the rest of the program uses one.
+bool cmdlineparam_adaptive_disjunctions = false;
+
+// Cmdline parameter specifying the number of disjuncts up to which the adaptive limits are escalated.
+// While some assertions remain unproved, the limits at the points relevant to them are doubled and
+// post* is rerun. Only the widening points go beyond max_disjunctions. 0 disables escalation. A non-zero
+// value implies adaptive disjunct limits.
+unsigned cmdlineparam_escalate_disjunctions = 0;
+
+// Cmdline parameter specifying whether to perform a tiered analysis: a cheap analysis with octagons and a
+// single disjunct is done first, and the configured domain is only used for the assertions it did not prove.
+bool cmdlineparam_tiered = false;
+
+// Cmdline parameter specifying whether to slice the program with respect to its assertions before building
+// the WPDS: the blocks that cannot lead to an assertion get no rules, and the dimensions no assertion
+// depends on are projected out of the weights.
+bool cmdlineparam_slice = false;
+
+// Cmdline parameter specifying whether to compute the summaries of the call graph SCCs bottom-up before
+// post*. The SCCs which do not depend on each other are summarized in parallel by
+// cmdlineparam_summary_workers worker processes (0 uses one worker per core). The workers exchange the
+// summaries through the main process, and a worker whose resident memory grew by more than
+// cmdlineparam_worker_memory_budget MB since it started is replaced (0 never replaces a worker).
+bool cmdlineparam_bottom_up = false;
+unsigned cmdlineparam_summary_workers = 0;
+unsigned cmdlineparam_worker_memory_budget = 0;
+
+// Cmdline parameter specifying whether to solve the program WPDS with Newton rounds instead of a single
+// chaotic post*. Each round solves the linearization of the procedure summaries, and widens it into them.
+bool cmdlineparam_newton = false;
+
+// Cmdline parameter specifying the number of times the weight at a widening point is only joined before
+// widening is applied. Widening is applied right away with 0.
+unsigned cmdlineparam_widening_delay = 0;
+
+// Cmdline parameter specifying whether to fuse the straight-line chains of rules of the WPDS before post*,
+// keeping only the keys of the call sites, returns, entries, exits, widening points and assertions.
+bool cmdlineparam_compress_chains = false;
+
+// Cmdline parameter specifying whether to run a cheap interval analysis before building the WPDS, to find the
+// variables and values that provably stay in range. Wrapping them only adds their bounding constraints.
+bool cmdlineparam_interval_preanalysis = false;
+
+// Cmdline parameter specifying whether to infer the signedness of the variables from the comparisons,
+// divisions, shifts and extensions that use them, instead of starting with every variable signed.
+bool cmdlineparam_infer_signedness = false;
+
+// Cmdline parameter specifying whether to execute the straight-line affine instructions of each BasicBlock
+// symbolically, and apply them to its abstract transformer as one parallel assignment.
+bool cmdlineparam_symbolic_bb = false;
+
+// Cmdline parameter specifying the number of rounds of bound propagation of the non-octagonal constraints
+// onto the octagons. With 0, the octagons drop these constraints.
+unsigned cmdlineparam_propagation_rounds = 0;
+
+// Cmdline parameter specifying whether the reduced product of octagons uses the affine equality domain
+// AffineEqualityAv instead of equalities-only polyhedra.
+bool cmdlineparam_affine_equalities = false;
+
+// Cmdline parameter specifying the number of rounds of the incremental reduction of the reduced product, which
+// only exchanges the facts on the dimensions changed since the last reduction. With 0, each reduction is complete.
+unsigned cmdlineparam_reduction_rounds = 0;
+
+// Cmdline parameter specifying whether the meet, entailment and equality of the pointset powersets skip the pairs
+// of disjuncts by comparing their bounding boxes first.
+bool cmdlineparam_box_filter = false;
+
+// Cmdline parameter specifying the hard limit on the number of disjuncts that a join of pointset powersets appends
+// before merging them. Below it, the merge is deferred until the value is compared, widened or extended. With 0,
+// each join merges.
+unsigned cmdlineparam_lazy_merge_limit = 0;
+
+// Cmdline parameter specifying whether the octagons use int64_t coefficients instead of mpz_class ones. The analysis
+// falls back to mpz_class coefficients for the modules with integers wider than 32 bits, whose bounds would overflow.
+bool cmdlineparam_int64_coefficients = false;
+
+// Cmdline parameter specifying whether to use BD shapes with int64_t coefficients in place of the octagons.
+bool cmdlineparam_use_bd_shapes = false;
+
 std::string cmdlineparam_filename;
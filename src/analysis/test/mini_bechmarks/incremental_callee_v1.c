@@ -0,0 +1,13 @@
+// Regression test for the incremental analysis (--incremental), together with incremental_callee_v2.c
+// Analyze this version first, saving the fixpoint: the assertion in main holds.
+#include <assert.h>
+
+int scale (int x) {
+  return x;
+}
+
+int main () {
+  int y = scale(3);
+  assert (y < 5);
+  return 0;
+}
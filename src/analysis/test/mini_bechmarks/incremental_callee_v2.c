@@ -0,0 +1,14 @@
+// Regression test for the incremental analysis (--incremental), together with incremental_callee_v1.c
+// Analyze this version second, from the fixpoint saved for incremental_callee_v1.c. Only scale changed,
+// but main calls it, so the transitions of main must be recomputed: the assertion in main fails.
+#include <assert.h>
+
+int scale (int x) {
+  return 2 * x;
+}
+
+int main () {
+  int y = scale(3);
+  assert (y < 5);
+  return 0;
+}
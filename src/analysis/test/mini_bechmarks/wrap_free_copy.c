@@ -0,0 +1,22 @@
+// Regression test for the interval pre-analysis (--interval_preanalysis)
+// y is assigned a product that wraps once r > 647483647, and copied to x in another block. The value stored
+// in y is held unwrapped, so the load of y is not wrap-free, and x has to be wrapped rather than only bounded.
+// The assertion fails for r = 1000000000, it must not be proved.
+#include <stdlib.h>
+#include <assert.h>
+
+int main () {
+  unsigned int r = (unsigned int)rand();
+  unsigned int y, x;
+  if (r > 1000000000u)
+    return 0;
+
+  y = r * 2u + 3000000000u;
+  if (rand())
+    x = y;
+  else
+    x = 4000000000u;
+
+  assert (x >= 3000000000u);
+  return 0;
+}
@@ -0,0 +1,449 @@
+#include "src/reinterp/wrapped_domain/IntervalPreAnalysis.hpp"
+
+#include <deque>
+
+#include "llvm/IR/CFG.h"
+#include "llvm/IR/CallSite.h"
+#include "llvm/IR/Constants.h"
+
+using namespace llvm;
+using namespace abstract_domain;
+
+namespace {
+  typedef llvm_abstract_transformer::IntervalPreAnalysis::Interval Interval;
+
+  // Number of times a value used across BasicBlocks can grow before it is widened
+  const unsigned value_widening_delay = 2;
+
+  // Only the integer types that have a corresponding utils::Bitsize are analyzed
+  bool GetAnalyzedWidth(const Type* t, unsigned& width) {
+    const IntegerType* it = dyn_cast<IntegerType>(t);
+    if(!it)
+      return false;
+    width = it->getBitWidth();
+    return (width == 8 || width == 16 || width == 32 || width == 64);
+  }
+
+  bool Contains(const Interval& outer, const Interval& inner) {
+    if(inner.is_bottom)
+      return true;
+    if(outer.is_bottom)
+      return false;
+    return (outer.lo <= inner.lo && inner.hi <= outer.hi);
+  }
+
+  Interval Join(const Interval& a, const Interval& b) {
+    if(a.is_bottom)
+      return b;
+    if(b.is_bottom)
+      return a;
+    return Interval(a.lo < b.lo ? a.lo : b.lo, a.hi > b.hi ? a.hi : b.hi);
+  }
+
+  Interval Meet(const Interval& a, const Interval& b) {
+    if(a.is_bottom || b.is_bottom)
+      return Interval();
+    return Interval(a.lo > b.lo ? a.lo : b.lo, a.hi < b.hi ? a.hi : b.hi);
+  }
+
+  // The bounds of new_i that grew past old_i are moved to the bounds of range
+  Interval Widen(const Interval& old_i, const Interval& new_i, const Interval& range) {
+    if(old_i.is_bottom || new_i.is_bottom)
+      return Join(old_i, new_i);
+    return Interval(new_i.lo < old_i.lo ? range.lo : old_i.lo, new_i.hi > old_i.hi ? range.hi : old_i.hi);
+  }
+
+  Interval Add(const Interval& a, const Interval& b) {
+    if(a.is_bottom || b.is_bottom)
+      return Interval();
+    return Interval(a.lo + b.lo, a.hi + b.hi);
+  }
+
+  Interval Sub(const Interval& a, const Interval& b) {
+    if(a.is_bottom || b.is_bottom)
+      return Interval();
+    return Interval(a.lo - b.hi, a.hi - b.lo);
+  }
+
+  Interval Mul(const Interval& a, const Interval& b) {
+    if(a.is_bottom || b.is_bottom)
+      return Interval();
+    mpz_class p[4] = {a.lo * b.lo, a.lo * b.hi, a.hi * b.lo, a.hi * b.hi};
+    mpz_class lo = p[0], hi = p[0];
+    for(unsigned i = 1; i < 4; i++) {
+      if(p[i] < lo) lo = p[i];
+      if(p[i] > hi) hi = p[i];
+    }
+    return Interval(lo, hi);
+  }
+}
+
+namespace llvm_abstract_transformer {
+
+  bool IntervalPreAnalysis::Interval::operator==(const Interval& that) const {
+    if(is_bottom || that.is_bottom)
+      return (is_bottom == that.is_bottom);
+    return (lo == that.lo && hi == that.hi);
+  }
+
+  IntervalPreAnalysis::IntervalPreAnalysis(Function* f,
+                                           bool is_signed,
+                                           const AllocaMap& alloca_map,
+                                           const DataLayout& TD,
+                                           const std::set<const BasicBlock*>& widening_points,
+                                           const std::set<const Argument*>& wrap_free_args) :
+    f_(f), is_signed_(is_signed), alloca_map_(alloca_map), TD_(TD), widening_points_(widening_points),
+    wrap_free_args_(wrap_free_args) {
+  }
+
+  // An alloca is tracked if it is an integer variable only used as the address of loads and stores of its size.
+  // Its contents can then only change through these stores.
+  void IntervalPreAnalysis::CollectTrackedAllocas() {
+    for(AllocaMap::const_iterator it = alloca_map_.begin(); it != alloca_map_.end(); it++) {
+      const AllocaInst* ai = dyn_cast<AllocaInst>(it->first);
+      unsigned width;
+      if(!ai || ai->isArrayAllocation() || !GetAnalyzedWidth(ai->getAllocatedType(), width))
+        continue;
+      if(TD_.getTypeStoreSize(ai->getAllocatedType()) != it->second.second)
+        continue;
+
+      bool is_tracked = true;
+      for(Value::const_user_iterator uit = ai->user_begin(); uit != ai->user_end() && is_tracked; uit++) {
+        const User* u = *uit;
+        if(const LoadInst* li = dyn_cast<LoadInst>(u)) {
+          is_tracked = (li->getType() == ai->getAllocatedType());
+        } else if(const StoreInst* si = dyn_cast<StoreInst>(u)) {
+          is_tracked = (si->getPointerOperand() == ai && si->getValueOperand()->getType() == ai->getAllocatedType());
+        } else {
+          is_tracked = false;
+        }
+      }
+      if(is_tracked) {
+        tracked_allocas_[ai] = width;
+        no_wrap_allocas_.insert(ai);
+      }
+    }
+  }
+
+  IntervalPreAnalysis::Interval IntervalPreAnalysis::Range(unsigned width) const {
+    mpz_class two_pow_w = mpz_class(1) << width;
+    if(is_signed_) {
+      mpz_class half = two_pow_w / 2;
+      return Interval(-half, half - 1);
+    }
+    return Interval(mpz_class(0), two_pow_w - 1);
+  }
+
+  IntervalPreAnalysis::Interval IntervalPreAnalysis::Wrapped(const Interval& i, unsigned width) const {
+    Interval range = Range(width);
+    if(Contains(range, i))
+      return i;
+    return range;
+  }
+
+  IntervalPreAnalysis::Interval IntervalPreAnalysis::GetValue(const Value* v, const ValueIntervals& local) const {
+    unsigned width;
+    if(!GetAnalyzedWidth(v->getType(), width))
+      return Interval();
+
+    if(const ConstantInt* ci = dyn_cast<ConstantInt>(v)) {
+      mpz_class c(ci->getValue().toString(10, is_signed_));
+      return Interval(c, c);
+    }
+    ValueIntervals::const_iterator lit = local.find(v);
+    if(lit != local.end())
+      return lit->second;
+    ValueIntervals::const_iterator vit = values_.find(v);
+    if(vit != values_.end())
+      return vit->second;
+    return Range(width);
+  }
+
+  // Constants are represented by their unsigned bit-pattern. The arguments are held as the values passed by the
+  // callers, hence only the ones in wrap_free_args_ are wrap-free.
+  bool IntervalPreAnalysis::IsWrapFree(const Value* v, const std::map<const Value*, bool>& local_wrap_free) const {
+    if(const ConstantInt* ci = dyn_cast<ConstantInt>(v))
+      return (!is_signed_ || !ci->getValue().isNegative());
+    if(const Argument* arg = dyn_cast<Argument>(v))
+      return (wrap_free_args_.find(arg) != wrap_free_args_.end());
+    std::map<const Value*, bool>::const_iterator it = local_wrap_free.find(v);
+    return (it != local_wrap_free.end() && it->second);
+  }
+
+  void IntervalPreAnalysis::Transfer(const BasicBlock* bb, CellState& state, ValueIntervals& local, bool record) {
+    // Wrap-freedom of the values computed in bb, and of the last value stored to each alloca in bb
+    std::map<const Value*, bool> local_wrap_free;
+    std::map<const Value*, bool> stored_wrap_free;
+
+    for(BasicBlock::const_iterator iit = bb->begin(); iit != bb->end(); iit++) {
+      const Instruction* I = iit;
+      unsigned width;
+      bool has_width = GetAnalyzedWidth(I->getType(), width);
+      bool wrap_free = false;
+
+      if(const StoreInst* si = dyn_cast<StoreInst>(I)) {
+        const Value* ptr = si->getPointerOperand();
+        if(tracked_allocas_.find(ptr) == tracked_allocas_.end())
+          continue;
+        state[ptr] = GetValue(si->getValueOperand(), local);
+        if(record) {
+          bool value_wrap_free = IsWrapFree(si->getValueOperand(), local_wrap_free);
+          stored_wrap_free[ptr] = value_wrap_free;
+          if(!value_wrap_free)
+            no_wrap_allocas_.erase(ptr);
+        }
+        continue;
+      }
+
+      if(record && (isa<CallInst>(I) || isa<InvokeInst>(I))) {
+        ImmutableCallSite cs(I);
+        const Function* callee = cs.getCalledFunction();
+        if(callee != NULL && !callee->isDeclaration()) {
+          Function::const_arg_iterator ait = callee->arg_begin();
+          for(unsigned i = 0; i < cs.arg_size() && ait != callee->arg_end(); i++, ait++) {
+            if(!IsWrapFree(cs.getArgument(i), local_wrap_free))
+              wrapping_args_.insert(ait);
+          }
+        }
+      }
+
+      if(tracked_allocas_.find(I) != tracked_allocas_.end()) {
+        // Fresh memory is uninitialized
+        state[I] = Range(tracked_allocas_[I]);
+        continue;
+      }
+
+      if(!has_width)
+        continue;
+
+      Interval result = Range(width);
+      if(const LoadInst* li = dyn_cast<LoadInst>(I)) {
+        const Value* ptr = li->getPointerOperand();
+        if(tracked_allocas_.find(ptr) != tracked_allocas_.end()) {
+          result = state[ptr];
+          // Before the first store in bb, the alloca holds the values stored by the other BasicBlocks
+          std::map<const Value*, bool>::const_iterator sit = stored_wrap_free.find(ptr);
+          if(sit != stored_wrap_free.end())
+            wrap_free = sit->second;
+          else
+            wrap_free = (no_wrap_allocas_.find(ptr) != no_wrap_allocas_.end());
+        }
+      } else if(const BinaryOperator* bo = dyn_cast<BinaryOperator>(I)) {
+        Interval a = GetValue(bo->getOperand(0), local);
+        Interval b = GetValue(bo->getOperand(1), local);
+        Interval math;
+        bool is_linear = true;
+        switch(bo->getOpcode()) {
+        case Instruction::Add: math = Add(a, b); break;
+        case Instruction::Sub: math = Sub(a, b); break;
+        case Instruction::Mul: math = Mul(a, b); break;
+        case Instruction::Shl: {
+          const ConstantInt* ci = dyn_cast<ConstantInt>(bo->getOperand(1));
+          if(ci && ci->getValue().ult(width)) {
+            mpz_class p = mpz_class(1) << (unsigned)ci->getZExtValue();
+            math = Mul(a, Interval(p, p));
+          } else {
+            is_linear = false;
+          }
+          break;
+        }
+        default:
+          is_linear = false;
+        }
+        if(is_linear) {
+          result = Wrapped(math, width);
+          wrap_free = (Contains(Range(width), math) &&
+                       IsWrapFree(bo->getOperand(0), local_wrap_free) &&
+                       (bo->getOpcode() == Instruction::Shl || IsWrapFree(bo->getOperand(1), local_wrap_free)));
+        }
+      } else if(const PHINode* phi = dyn_cast<PHINode>(I)) {
+        result = Interval();
+        for(unsigned i = 0; i < phi->getNumIncomingValues(); i++) {
+          if(entry_states_.find(phi->getIncomingBlock(i)) != entry_states_.end())
+            result = Join(result, GetValue(phi->getIncomingValue(i), ValueIntervals()));
+        }
+      } else if(const SelectInst* sel = dyn_cast<SelectInst>(I)) {
+        result = Join(GetValue(sel->getTrueValue(), local), GetValue(sel->getFalseValue(), local));
+      } else if(const CastInst* ci = dyn_cast<CastInst>(I)) {
+        unsigned src_width;
+        if(GetAnalyzedWidth(ci->getSrcTy(), src_width)) {
+          Interval src = GetValue(ci->getOperand(0), local);
+          if(ci->getOpcode() == Instruction::Trunc ||
+             (ci->getOpcode() == Instruction::SExt && is_signed_) ||
+             (ci->getOpcode() == Instruction::ZExt && (!is_signed_ || (!src.is_bottom && src.lo >= 0))))
+            result = Wrapped(src, width);
+        }
+      }
+
+      local[I] = result;
+      if(record) {
+        local_wrap_free[I] = wrap_free;
+        if(wrap_free)
+          wrap_free_values_.insert(I);
+      }
+    }
+  }
+
+  bool IntervalPreAnalysis::RefineEdge(const BasicBlock* bb, const BasicBlock* succ, const ValueIntervals& local, CellState& state) const {
+    const BranchInst* bi = dyn_cast<BranchInst>(bb->getTerminator());
+    if(!bi || !bi->isConditional() || bi->getSuccessor(0) == bi->getSuccessor(1))
+      return true;
+    const ICmpInst* cmp = dyn_cast<ICmpInst>(bi->getCondition());
+    if(!cmp || cmp->getParent() != bb)
+      return true;
+
+    CmpInst::Predicate pred = (succ == bi->getSuccessor(0)) ? cmp->getPredicate() : cmp->getInversePredicate();
+    if(pred == CmpInst::ICMP_NE || (CmpInst::isSigned(pred) && !is_signed_) || (CmpInst::isUnsigned(pred) && is_signed_))
+      return true;
+
+    for(unsigned op = 0; op < 2; op++) {
+      const LoadInst* li = dyn_cast<LoadInst>(cmp->getOperand(op));
+      if(!li || li->getParent() != bb)
+        continue;
+      const Value* ptr = li->getPointerOperand();
+      if(tracked_allocas_.find(ptr) == tracked_allocas_.end())
+        continue;
+
+      // The loaded value is only the contents of ptr if it is not stored to afterwards
+      bool is_stored_after = false;
+      BasicBlock::const_iterator iit = li;
+      for(iit++; iit != bb->end(); iit++) {
+        const StoreInst* si = dyn_cast<StoreInst>(iit);
+        if(si && si->getPointerOperand() == ptr)
+          is_stored_after = true;
+      }
+      if(is_stored_after)
+        continue;
+
+      Interval y = GetValue(cmp->getOperand(1 - op), local);
+      if(y.is_bottom)
+        continue;
+      Interval& x = state[ptr];
+      switch(op == 0 ? pred : CmpInst::getSwappedPredicate(pred)) {
+      case CmpInst::ICMP_SLT: case CmpInst::ICMP_ULT: x = Meet(x, Interval(x.lo, y.hi - 1)); break;
+      case CmpInst::ICMP_SLE: case CmpInst::ICMP_ULE: x = Meet(x, Interval(x.lo, y.hi)); break;
+      case CmpInst::ICMP_SGT: case CmpInst::ICMP_UGT: x = Meet(x, Interval(y.lo + 1, x.hi)); break;
+      case CmpInst::ICMP_SGE: case CmpInst::ICMP_UGE: x = Meet(x, Interval(y.lo, x.hi)); break;
+      case CmpInst::ICMP_EQ: x = Meet(x, y); break;
+      default: break;
+      }
+      if(x.is_bottom)
+        return false;
+    }
+    return true;
+  }
+
+  void IntervalPreAnalysis::Run() {
+    CollectTrackedAllocas();
+
+    const BasicBlock* entry = &f_->getEntryBlock();
+    CellState init;
+    for(std::map<const Value*, unsigned>::const_iterator it = tracked_allocas_.begin(); it != tracked_allocas_.end(); it++) {
+      init[it->first] = Range(it->second);
+    }
+    entry_states_[entry] = init;
+
+    std::deque<const BasicBlock*> worklist;
+    std::set<const BasicBlock*> in_worklist;
+    worklist.push_back(entry);
+    in_worklist.insert(entry);
+    while(!worklist.empty()) {
+      const BasicBlock* bb = worklist.front();
+      worklist.pop_front();
+      in_worklist.erase(bb);
+
+      CellState state = entry_states_[bb];
+      ValueIntervals local;
+      Transfer(bb, state, local, false);
+
+      // Propagate the values used outside of bb
+      for(ValueIntervals::const_iterator lit = local.begin(); lit != local.end(); lit++) {
+        const Instruction* I = cast<Instruction>(lit->first);
+        bool is_used_outside = false;
+        for(Value::const_user_iterator uit = I->user_begin(); uit != I->user_end(); uit++) {
+          const Instruction* u = dyn_cast<Instruction>(*uit);
+          if(u && (u->getParent() != bb || isa<PHINode>(u)))
+            is_used_outside = true;
+        }
+        if(!is_used_outside)
+          continue;
+
+        ValueIntervals::iterator vit = values_.find(I);
+        Interval updated = (vit == values_.end()) ? lit->second : Join(vit->second, lit->second);
+        if(vit != values_.end() && updated == vit->second)
+          continue;
+        unsigned width;
+        GetAnalyzedWidth(I->getType(), width);
+        if(value_updates_[I]++ >= value_widening_delay)
+          updated = Widen(vit->second, updated, Range(width));
+        values_[I] = updated;
+
+        for(Value::const_user_iterator uit = I->user_begin(); uit != I->user_end(); uit++) {
+          const Instruction* u = dyn_cast<Instruction>(*uit);
+          if(u && entry_states_.find(u->getParent()) != entry_states_.end() &&
+             in_worklist.insert(u->getParent()).second)
+            worklist.push_back(u->getParent());
+        }
+      }
+
+      for(succ_const_iterator sit = succ_begin(bb); sit != succ_end(bb); sit++) {
+        const BasicBlock* succ = *sit;
+        CellState edge_state = state;
+        if(!RefineEdge(bb, succ, local, edge_state))
+          continue;
+
+        std::map<const BasicBlock*, CellState>::iterator eit = entry_states_.find(succ);
+        bool changed = false;
+        if(eit == entry_states_.end()) {
+          entry_states_[succ] = edge_state;
+          changed = true;
+        } else {
+          bool is_widening_point = (widening_points_.find(succ) != widening_points_.end());
+          for(CellState::iterator cit = eit->second.begin(); cit != eit->second.end(); cit++) {
+            Interval updated = Join(cit->second, edge_state[cit->first]);
+            if(is_widening_point)
+              updated = Widen(cit->second, updated, Range(tracked_allocas_[cit->first]));
+            if(updated != cit->second) {
+              cit->second = updated;
+              changed = true;
+            }
+          }
+        }
+        if(changed && in_worklist.insert(succ).second)
+          worklist.push_back(succ);
+      }
+    }
+
+    // Find the wrap-free values with the final intervals. A load depends on the no-wrap allocas, which only
+    // shrink, so this is repeated until they are stable.
+    size_t num_no_wrap_allocas;
+    do {
+      num_no_wrap_allocas = no_wrap_allocas_.size();
+      wrap_free_values_.clear();
+      wrapping_args_.clear();
+      for(std::map<const BasicBlock*, CellState>::const_iterator eit = entry_states_.begin(); eit != entry_states_.end(); eit++) {
+        CellState state = eit->second;
+        ValueIntervals local;
+        Transfer(eit->first, state, local, true);
+      }
+    } while(no_wrap_allocas_.size() != num_no_wrap_allocas);
+  }
+
+  Vocabulary IntervalPreAnalysis::GetNoWrapVocabulary() const {
+    Vocabulary voc;
+    for(std::set<const Value*>::const_iterator it = no_wrap_allocas_.begin(); it != no_wrap_allocas_.end(); it++) {
+      AllocaMap::const_iterator ait = alloca_map_.find(const_cast<Value*>(*it));
+      voc.insert(ait->second.first);
+    }
+    return voc;
+  }
+
+  const std::set<const Value*>& IntervalPreAnalysis::GetWrapFreeValues() const {
+    return wrap_free_values_;
+  }
+
+  const std::set<const Argument*>& IntervalPreAnalysis::GetWrappingArguments() const {
+    return wrapping_args_;
+  }
+
+} // End llvm_abstract_transformer namespace
@@ -0,0 +1,107 @@
+#ifndef src_reinterp_wrapped_domain_IntervalPreAnalysis_hpp
+#define src_reinterp_wrapped_domain_IntervalPreAnalysis_hpp
+
+#include <map>
+#include <set>
+
+#include "llvm/IR/BasicBlock.h"
+#include "llvm/IR/DataLayout.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/Instructions.h"
+
+#include "src/AbstractDomain/common/dimension.hpp"
+
+namespace llvm_abstract_transformer {
+
+  // IntervalPreAnalysis
+  //
+  // A cheap non-relational analysis of a function, run before its abstract transformers are created.
+  // The integers are read as signed or unsigned bit-vectors (depending on is_signed), and each machine value
+  // is over-approximated by an interval. Memory is only tracked for the allocas whose address does not escape,
+  // which covers the local variables after reg2mem. The intervals of these allocas are refined by the branch
+  // conditions on the values loaded from them, and widened at the given widening points.
+  //
+  // The abstract transformers represent the result of an add, sub, mul or shl by a constant without wrapping
+  // it. Such a result is wrap-free when its operands are wrap-free and it stays within the range of its type.
+  // Wrapping a wrap-free value does not change it, so it is enough to add its bounding constraints:
+  //  - GetNoWrapVocabulary returns the dimensions of the tracked allocas that are only assigned wrap-free values.
+  //  - GetWrapFreeValues returns the instructions of the function that are wrap-free.
+  // Since the wrapping is lazy, a value stored in an alloca or passed to a call is held unwrapped. A load is
+  // thus only wrap-free if every store to its alloca is (the no-wrap allocas are a greatest fixpoint), and an
+  // argument only if it is in wrap_free_args, which the caller computes over the call sites of the module (see
+  // GetWrappingArguments).
+  class IntervalPreAnalysis {
+  public:
+    typedef std::map<llvm::Value*, std::pair<abstract_domain::DimensionKey, unsigned> > AllocaMap;
+
+    // An interval [lo, hi] of machine values, it is empty when is_bottom is set
+    struct Interval {
+      bool is_bottom;
+      mpz_class lo;
+      mpz_class hi;
+
+      Interval() : is_bottom(true) {}
+      Interval(const mpz_class& l, const mpz_class& h) : is_bottom(l > h), lo(l), hi(h) {}
+
+      bool operator==(const Interval& that) const;
+      bool operator!=(const Interval& that) const {
+        return !(*this == that);
+      }
+    };
+
+    IntervalPreAnalysis(llvm::Function* f,
+                        bool is_signed,
+                        const AllocaMap& alloca_map,
+                        const llvm::DataLayout& TD,
+                        const std::set<const llvm::BasicBlock*>& widening_points,
+                        const std::set<const llvm::Argument*>& wrap_free_args);
+
+    void Run();
+
+    abstract_domain::Vocabulary GetNoWrapVocabulary() const;
+    const std::set<const llvm::Value*>& GetWrapFreeValues() const;
+    // The arguments of the callees that a call in the function passes a value that is not wrap-free
+    const std::set<const llvm::Argument*>& GetWrappingArguments() const;
+
+  private:
+    // Maps each tracked alloca to the interval of its contents
+    typedef std::map<const llvm::Value*, Interval> CellState;
+    typedef std::map<const llvm::Value*, Interval> ValueIntervals;
+
+    void CollectTrackedAllocas();
+
+    Interval Range(unsigned width) const;
+    Interval Wrapped(const Interval& i, unsigned width) const;
+    Interval GetValue(const llvm::Value* v, const ValueIntervals& local) const;
+    bool IsWrapFree(const llvm::Value* v, const std::map<const llvm::Value*, bool>& local_wrap_free) const;
+
+    // Abstractly executes bb from state. When record is set, it also finds the wrap-free values, the allocas
+    // assigned a value that is not wrap-free and the arguments passed a value that is not wrap-free.
+    void Transfer(const llvm::BasicBlock* bb, CellState& state, ValueIntervals& local, bool record);
+
+    // Refines state with the branch condition of the edge bb->succ, returns false if the edge is infeasible
+    bool RefineEdge(const llvm::BasicBlock* bb, const llvm::BasicBlock* succ, const ValueIntervals& local, CellState& state) const;
+
+    llvm::Function* f_;
+    bool is_signed_;
+    const AllocaMap& alloca_map_;
+    const llvm::DataLayout& TD_;
+    const std::set<const llvm::BasicBlock*>& widening_points_;
+    const std::set<const llvm::Argument*>& wrap_free_args_;
+
+    // Bitwidth of each tracked alloca
+    std::map<const llvm::Value*, unsigned> tracked_allocas_;
+    std::map<const llvm::BasicBlock*, CellState> entry_states_;
+
+    // Intervals of the values used outside of their BasicBlock, and the number of times they have grown
+    ValueIntervals values_;
+    std::map<const llvm::Value*, unsigned> value_updates_;
+
+    std::set<const llvm::Value*> no_wrap_allocas_;
+    std::set<const llvm::Value*> wrap_free_values_;
+    std::set<const llvm::Argument*> wrapping_args_;
+  };
+
+} // End llvm_abstract_transformer namespace
+
+#endif // src_reinterp_wrapped_domain_IntervalPreAnalysis_hpp
@@ -0,0 +1,24 @@
+#ifndef src_reinterp_wrapped_domain_RuleCollector_hpp
+#define src_reinterp_wrapped_domain_RuleCollector_hpp
+
+#include <vector>
+
+#include "wali/wpds/RuleFunctor.hpp"
+
+namespace wali {
+  namespace wpds {
+
+    // Collects the rules of a WPDS, so that they can be iterated again after the WPDS is rebuilt
+    class RuleCollector : public ConstRuleFunctor
+    {
+    public:
+      std::vector<rule_t> rules_;
+      virtual void operator()( const rule_t & r) {
+        rules_.push_back(r);
+      }
+    };
+
+  } // end namespace wpds
+} // end namespace wali
+
+#endif // src_reinterp_wrapped_domain_RuleCollector_hpp
@@ -0,0 +1,150 @@
+#include "src/reinterp/wrapped_domain/SignednessInference.hpp"
+
+#include "llvm/IR/CallSite.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/GlobalVariable.h"
+#include "llvm/IR/Instructions.h"
+
+using namespace llvm;
+
+namespace llvm_abstract_transformer {
+
+  SignednessInference::SignednessInference(Module* m) : m_(m) {
+  }
+
+  const Value* SignednessInference::Find(const Value* v) const {
+    std::map<const Value*, const Value*>::iterator it = parent_.find(v);
+    if(it == parent_.end())
+      return v;
+    const Value* root = Find(it->second);
+    it->second = root; // Path compression
+    return root;
+  }
+
+  void SignednessInference::Union(const Value* a, const Value* b) {
+    if(!IsClassified(a) || !IsClassified(b))
+      return;
+    const Value* root_a = Find(a);
+    const Value* root_b = Find(b);
+    if(root_a == root_b)
+      return;
+    parent_[root_b] = root_a;
+    std::map<const Value*, int>::iterator vit = votes_.find(root_b);
+    if(vit != votes_.end()) {
+      votes_[root_a] += vit->second;
+      votes_.erase(vit);
+    }
+  }
+
+  void SignednessInference::Vote(const Value* v, bool is_signed) {
+    if(!IsClassified(v))
+      return;
+    votes_[Find(v)] += (is_signed ? 1 : -1);
+  }
+
+  bool SignednessInference::IsClassified(const Value* v) const {
+    return (v->getType()->isIntegerTy() || isa<AllocaInst>(v) || isa<GlobalVariable>(v) || isa<Function>(v));
+  }
+
+  bool SignednessInference::GetSignedness(const Value* v, bool& is_signed) const {
+    std::map<const Value*, int>::const_iterator vit = votes_.find(Find(v));
+    if(vit == votes_.end() || vit->second == 0)
+      return false;
+    is_signed = (vit->second > 0);
+    return true;
+  }
+
+  void SignednessInference::VisitInstruction(const Instruction* I) {
+    if(const StoreInst* si = dyn_cast<StoreInst>(I)) {
+      const Value* ptr = si->getPointerOperand();
+      if(isa<AllocaInst>(ptr) || isa<GlobalVariable>(ptr))
+        Union(ptr, si->getValueOperand());
+    } else if(const LoadInst* li = dyn_cast<LoadInst>(I)) {
+      const Value* ptr = li->getPointerOperand();
+      if(isa<AllocaInst>(ptr) || isa<GlobalVariable>(ptr))
+        Union(ptr, li);
+    } else if(const BinaryOperator* bo = dyn_cast<BinaryOperator>(I)) {
+      switch(bo->getOpcode()) {
+      case Instruction::SDiv: case Instruction::SRem:
+        Vote(bo->getOperand(0), true);
+        Vote(bo->getOperand(1), true);
+        break;
+      case Instruction::UDiv: case Instruction::URem:
+        Vote(bo->getOperand(0), false);
+        Vote(bo->getOperand(1), false);
+        break;
+      case Instruction::AShr:
+        Vote(bo->getOperand(0), true);
+        break;
+      case Instruction::LShr:
+        Vote(bo->getOperand(0), false);
+        break;
+      default:
+        break;
+      }
+      Union(bo, bo->getOperand(0));
+      // The shift amount is unrelated to the shifted value
+      if(!bo->isShift())
+        Union(bo, bo->getOperand(1));
+    } else if(const ICmpInst* cmp = dyn_cast<ICmpInst>(I)) {
+      Union(cmp->getOperand(0), cmp->getOperand(1));
+      if(cmp->isSigned())
+        Vote(cmp->getOperand(0), true);
+      else if(cmp->isUnsigned())
+        Vote(cmp->getOperand(0), false);
+    } else if(const CastInst* ci = dyn_cast<CastInst>(I)) {
+      switch(ci->getOpcode()) {
+      case Instruction::SExt: case Instruction::SIToFP:
+        Vote(ci->getOperand(0), true);
+        break;
+      case Instruction::ZExt: case Instruction::UIToFP:
+        Vote(ci->getOperand(0), false);
+        break;
+      case Instruction::FPToSI:
+        Vote(ci, true);
+        break;
+      case Instruction::FPToUI:
+        Vote(ci, false);
+        break;
+      default:
+        break;
+      }
+      Union(ci, ci->getOperand(0));
+    } else if(const PHINode* phi = dyn_cast<PHINode>(I)) {
+      for(unsigned i = 0; i < phi->getNumIncomingValues(); i++) {
+        Union(phi, phi->getIncomingValue(i));
+      }
+    } else if(const SelectInst* sel = dyn_cast<SelectInst>(I)) {
+      Union(sel, sel->getTrueValue());
+      Union(sel, sel->getFalseValue());
+    } else if(const ReturnInst* ri = dyn_cast<ReturnInst>(I)) {
+      if(ri->getReturnValue() != NULL && ri->getReturnValue()->getType()->isIntegerTy())
+        Union(ri->getParent()->getParent(), ri->getReturnValue());
+    } else if(isa<CallInst>(I) || isa<InvokeInst>(I)) {
+      ImmutableCallSite cs(I);
+      const Function* callee = cs.getCalledFunction();
+      if(callee == NULL || callee->isDeclaration())
+        return;
+      if(I->getType()->isIntegerTy())
+        Union(callee, I);
+      Function::const_arg_iterator ait = callee->arg_begin();
+      for(unsigned i = 0; i < cs.arg_size() && ait != callee->arg_end(); i++, ait++) {
+        Union(ait, cs.getArgument(i));
+      }
+    }
+  }
+
+  void SignednessInference::Run() {
+    for(Module::iterator fit = m_->begin(); fit != m_->end(); fit++) {
+      const Function* f = fit;
+      if(f->isDeclaration())
+        continue;
+      for(Function::const_iterator bbit = f->begin(); bbit != f->end(); bbit++) {
+        for(BasicBlock::const_iterator iit = bbit->begin(); iit != bbit->end(); iit++) {
+          VisitInstruction(iit);
+        }
+      }
+    }
+  }
+
+} // End llvm_abstract_transformer namespace
@@ -0,0 +1,45 @@
+#ifndef src_reinterp_wrapped_domain_SignednessInference_hpp
+#define src_reinterp_wrapped_domain_SignednessInference_hpp
+
+#include <map>
+
+#include "llvm/IR/Module.h"
+#include "llvm/IR/Value.h"
+
+namespace llvm_abstract_transformer {
+
+  // SignednessInference
+  //
+  // Infers whether the integer values of a module are used as signed or unsigned numbers.
+  // The values that flow into each other (through arithmetic, phis, selects, casts, calls, returns, and the
+  // loads and stores of allocas and globals) are put in the same class. Each class collects a vote from the
+  // comparisons, divisions, remainders, right shifts and extensions that read one of its values with a sign.
+  // A class is signed or unsigned depending on the majority of its votes.
+  class SignednessInference {
+  public:
+    explicit SignednessInference(llvm::Module* m);
+
+    void Run();
+
+    // Returns false if no use of the class of v has a sign, otherwise sets is_signed to the sign of the class
+    bool GetSignedness(const llvm::Value* v, bool& is_signed) const;
+
+  private:
+    const llvm::Value* Find(const llvm::Value* v) const;
+    void Union(const llvm::Value* a, const llvm::Value* b);
+    void Vote(const llvm::Value* v, bool is_signed);
+
+    // Only integers and the memory of allocas and globals are classified
+    bool IsClassified(const llvm::Value* v) const;
+    void VisitInstruction(const llvm::Instruction* I);
+
+    llvm::Module* m_;
+
+    // Union-find over the values, the votes are kept at the roots. A positive vote is signed.
+    mutable std::map<const llvm::Value*, const llvm::Value*> parent_;
+    std::map<const llvm::Value*, int> votes_;
+  };
+
+} // End llvm_abstract_transformer namespace
+
+#endif // src_reinterp_wrapped_domain_SignednessInference_hpp
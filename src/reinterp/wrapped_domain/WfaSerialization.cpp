@@ -0,0 +1,84 @@
+#include "src/reinterp/wrapped_domain/WfaSerialization.hpp"
+
+#include "wali/KeyContainer.hpp"
+#include "wali/KeyPairSource.hpp"
+#include "wali/wfa/TransFunctor.hpp"
+#include "wali/wfa/ITrans.hpp"
+
+using namespace abstract_domain;
+
+namespace {
+  // Collects the transitions of a WFA so that they can be counted before being written
+  class TransCollector : public wali::wfa::ConstTransFunctor {
+  public:
+    std::vector<const wali::wfa::ITrans*> trans_;
+    virtual void operator()(const wali::wfa::ITrans* t) {
+      trans_.push_back(t);
+    }
+  };
+}
+
+namespace llvm_abstract_transformer {
+
+  void SerializeKey(std::ostream& out, wali::Key k) {
+    if(k == wali::WALI_EPSILON) {
+      out << "E ";
+      return;
+    }
+    wali::KeyPairSource* kps = dynamic_cast<wali::KeyPairSource*>(wali::getKeySource(k));
+    if(kps != NULL) {
+      out << "P ";
+      SerializeKey(out, kps->first());
+      SerializeKey(out, kps->second());
+    } else {
+      out << "S ";
+      SerializeString(out, wali::key2str(k));
+    }
+  }
+
+  wali::Key DeserializeKey(std::istream& in) {
+    std::string kind;
+    in >> kind;
+    if(kind == "E")
+      return wali::WALI_EPSILON;
+    if(kind == "P") {
+      wali::Key first = DeserializeKey(in);
+      wali::Key second = DeserializeKey(in);
+      return wali::getKey(first, second);
+    }
+    assert(kind == "S");
+    return wali::getKey(DeserializeString(in));
+  }
+
+  void SerializeWfaTransitions(std::ostream& out, const wali::wfa::WFA& fa) {
+    TransCollector tc;
+    fa.for_each(tc);
+    out << tc.trans_.size() << "\n";
+    for(std::vector<const wali::wfa::ITrans*>::const_iterator it = tc.trans_.begin(); it != tc.trans_.end(); it++) {
+      const wali::wfa::ITrans* t = *it;
+      SerializeKey(out, t->from());
+      SerializeKey(out, t->stack());
+      SerializeKey(out, t->to());
+      const AvSemiring* w = dynamic_cast<const AvSemiring*>(t->weight().get_ptr());
+      assert(w != NULL);
+      w->Serialize(out);
+      out << "\n";
+    }
+  }
+
+  std::vector<SerializedTrans> DeserializeWfaTransitions(std::istream& in, const ref_ptr<AvSemiring>& prototype) {
+    std::vector<SerializedTrans> ret;
+    size_t num_trans = 0;
+    in >> num_trans;
+    for(size_t i = 0; i < num_trans && in.good(); i++) {
+      SerializedTrans st;
+      st.from = DeserializeKey(in);
+      st.stack = DeserializeKey(in);
+      st.to = DeserializeKey(in);
+      st.weight = prototype->Deserialize(in);
+      ret.push_back(st);
+    }
+    return ret;
+  }
+
+} // End llvm_abstract_transformer namespace
@@ -0,0 +1,35 @@
+#ifndef src_reinterp_wrapped_domain_WfaSerialization_hpp
+#define src_reinterp_wrapped_domain_WfaSerialization_hpp
+
+#include <iostream>
+#include <vector>
+
+#include "wali/Key.hpp"
+#include "wali/wfa/WFA.hpp"
+#include "src/AbstractDomain/common/AvSemiring.hpp"
+
+namespace llvm_abstract_transformer {
+
+  // A transition read back from a serialized WFA
+  struct SerializedTrans {
+    wali::Key from;
+    wali::Key stack;
+    wali::Key to;
+    ref_ptr<AvSemiring> weight;
+  };
+
+  // Keys are written by their string form. States generated by post* are pairs
+  // of keys, so they are written recursively to get back the same key on reading.
+  void SerializeKey(std::ostream& out, wali::Key k);
+  wali::Key DeserializeKey(std::istream& in);
+
+  // Write all the transitions of fa along with their AvSemiring weights
+  void SerializeWfaTransitions(std::ostream& out, const wali::wfa::WFA& fa);
+
+  // Read the transitions written by SerializeWfaTransitions. The weights are rebuilt
+  // by calling Deserialize on prototype.
+  std::vector<SerializedTrans> DeserializeWfaTransitions(std::istream& in, const ref_ptr<AvSemiring>& prototype);
+
+} // End llvm_abstract_transformer namespace
+
+#endif // src_reinterp_wrapped_domain_WfaSerialization_hpp
@@ -30,8 +30,10 @@
 using namespace llvm;
 using namespace abstract_domain;
 
+extern bool cmdlineparam_symbolic_bb;
+
 namespace llvm_abstract_transformer {
-  WrappedDomainBBAbsTransCreator::WrappedDomainBBAbsTransCreator(std::unique_ptr<Module> M, ref_ptr<AbstractValue> av, bool add_array_bounds_check) : ExecutionEngine(std::move(M)), TD(Modules.back().get()), av_prevoc_(av->Top()), add_array_bounds_check_(add_array_bounds_check) {
+  WrappedDomainBBAbsTransCreator::WrappedDomainBBAbsTransCreator(std::unique_ptr<Module> M, ref_ptr<AbstractValue> av, bool add_array_bounds_check) : ExecutionEngine(std::move(M)), TD(Modules.back().get()), av_prevoc_(av->Top()), add_array_bounds_check_(add_array_bounds_check), symbolic_execution_(false) {
     setDataLayout(&TD);
     IL = new IntrinsicLowering(TD);
   }
@@ -211,6 +213,13 @@ namespace llvm_abstract_transformer {
         found_terminator = true;
         break;
       default:
+        // The affine instructions are executed symbolically, and the other instructions first apply them to state_
+        if(cmdlineparam_symbolic_bb) {
+          Vocabulary ins_state_voc = GetInstructionStateVocabulary(*I, insLiveBeforeMap, insLiveAfterMap, pre_post_voc);
+          if(SymbolicExecuteInst(*I, ins_state_voc))
+            break;
+          FlushSymbolicStore();
+        }
         abstractExecuteInst(*I, insLiveBeforeMap, insLiveAfterMap, pre_post_voc);
       }
 
@@ -227,6 +236,7 @@ namespace llvm_abstract_transformer {
 
       DEBUG_PRINTING(DBG_PRINT_OVERVIEW, std::cout << iss.str() << inst_timer.elapsed(););
     }
+    FlushSymbolicStore();
 
     DEBUG_PRINTING(DBG_PRINT_OVERVIEW, std::cout << ss.str() << bb_timer.elapsed(););
   }
@@ -239,26 +249,10 @@ namespace llvm_abstract_transformer {
      DEBUG_PRINTING(DBG_PRINT_DETAILS, 
                     std::cout << "\nAbstract execute instruction " << getName(&I) << ":" << std::flush;);
 
-     // All voc is one, since varaible access and update work on voc 1
-     Vocabulary ins_live_before = insLiveBeforeMap.at(&I);
-     ins_live_before = abstract_domain::replaceVersion(ins_live_before, 0, 1);
-     Vocabulary ins_live_after = insLiveAfterMap.at(&I);
-     ins_live_after = abstract_domain::replaceVersion(ins_live_after, 0, 1);
-     Vocabulary ins_live;
-     UnionVocabularies(ins_live_before, ins_live_after, ins_live);
-     Vocabulary ins_voc = GetInstructionVocabulary(&I, *(I.getParent()->getParent()), TD, instr_value_to_dim_, alloca_map_);
-     Vocabulary state_voc, temp_voc;
-     UnionVocabularies(pre_post_voc, ins_live, temp_voc);
-     UnionVocabularies(temp_voc, ins_voc, state_voc);
+     Vocabulary state_voc = GetInstructionStateVocabulary(I, insLiveBeforeMap, insLiveAfterMap, pre_post_voc);
      state_->AddVocabulary(state_voc);
      state_->Project(state_voc);
      
-     DEBUG_PRINTING(DBG_PRINT_DETAILS, 
-                    abstract_domain::print(std::cout << "\nins_live_before:", ins_live_before);
-                    abstract_domain::print(std::cout << "\nins_live_after:", ins_live_after);
-                    abstract_domain::print(std::cout << "\nins_voc:", ins_live_after);
-                    abstract_domain::print(std::cout << "\nstate_voc:", ins_live_after););
-     
 
      switch (I.getOpcode()) {
      default: llvm_unreachable("Unknown instruction type encountered!");
@@ -273,6 +267,96 @@ namespace llvm_abstract_transformer {
                     state_->print(std::cout) << std::endl;);
   }
 
+   Vocabulary WrappedDomainBBAbsTransCreator::GetInstructionStateVocabulary
+   (Instruction& I, 
+    const std::map<Instruction *, Vocabulary>& insLiveBeforeMap, 
+    const std::map<Instruction *, Vocabulary>& insLiveAfterMap, 
+    const Vocabulary& pre_post_voc) const {
+     // All voc is one, since varaible access and update work on voc 1
+     Vocabulary ins_live_before = insLiveBeforeMap.at(&I);
+     ins_live_before = abstract_domain::replaceVersion(ins_live_before, 0, 1);
+     Vocabulary ins_live_after = insLiveAfterMap.at(&I);
+     ins_live_after = abstract_domain::replaceVersion(ins_live_after, 0, 1);
+     Vocabulary ins_live;
+     UnionVocabularies(ins_live_before, ins_live_after, ins_live);
+     Vocabulary ins_voc = GetInstructionVocabulary(&I, *(I.getParent()->getParent()), TD, instr_value_to_dim_, alloca_map_);
+     Vocabulary state_voc, temp_voc;
+     UnionVocabularies(pre_post_voc, ins_live, temp_voc);
+     UnionVocabularies(temp_voc, ins_voc, state_voc);
+
+     DEBUG_PRINTING(DBG_PRINT_DETAILS, 
+                    abstract_domain::print(std::cout << "\nins_live_before:", ins_live_before);
+                    abstract_domain::print(std::cout << "\nins_live_after:", ins_live_after);
+                    abstract_domain::print(std::cout << "\nins_voc:", ins_voc);
+                    abstract_domain::print(std::cout << "\nstate_voc:", state_voc););
+     return state_voc;
+   }
+
+   // Only the add, sub, mul by a constant, integer casts, loads and stores that are affine in the values of
+   // state_ are executed symbolically. All the other instructions (comparisons, non-linear operations, calls,
+   // phis, ...) go through abstractExecuteInst after the symbolic store is flushed.
+   bool WrappedDomainBBAbsTransCreator::SymbolicExecuteInst(Instruction& I, const Vocabulary& ins_state_voc) {
+     symbolic_execution_ = true;
+     bool executed = false;
+     switch(I.getOpcode()) {
+     case Instruction::Add:
+     case Instruction::Sub:
+     case Instruction::Mul:
+       executed = !I.getType()->isVectorTy() && GetBitsizeFromType(I.getType()) != utils::one
+         && AssignLinearOperation(cast<BinaryOperator>(I));
+       break;
+     case Instruction::Trunc:
+     case Instruction::SExt:
+     case Instruction::ZExt:
+       executed = AssignIntegerCast(cast<CastInst>(I));
+       break;
+     case Instruction::Load:
+       executed = !cast<LoadInst>(I).isVolatile() && AssignLoad(cast<LoadInst>(I));
+       break;
+     case Instruction::Store:
+       executed = AssignStore(cast<StoreInst>(I));
+       break;
+     default:
+       break;
+     }
+     symbolic_execution_ = false;
+
+     if(executed)
+       symbolic_last_voc_ = ins_state_voc;
+     DEBUG_PRINTING(DBG_PRINT_DETAILS, 
+                    std::cout << "\nSymbolic execution of instruction " << getName(&I) << ":" << executed << std::flush;);
+     return executed;
+   }
+
+   // Only the dimensions still in the vocabulary after the last symbolically executed instruction are assigned.
+   // The assigned dimensions are then wrapped in one batch, see BitpreciseWrappedAbstractValue::WrapWithInferredSignedness.
+   void WrappedDomainBBAbsTransCreator::FlushSymbolicStore() {
+     if(symbolic_store_.empty())
+       return;
+
+     std::vector<AbstractValue::assignment_type> as;
+     Vocabulary modified_voc;
+     for(std::map<DimensionKey, AbstractValue::affexp_type>::const_iterator it = symbolic_store_.begin(); it != symbolic_store_.end(); it++) {
+       if(symbolic_last_voc_.count(it->first)) {
+         as.push_back(*it);
+         modified_voc.insert(it->first);
+       }
+     }
+     state_->AddVocabulary(symbolic_last_voc_);
+     if(!as.empty()) {
+       state_->AssignAffineParallel(as);
+       // One wrap step per modified dimension, instead of one at each of its later uses
+       state_->WrapWithInferredSignedness(modified_voc);
+     }
+     state_->Project(symbolic_last_voc_);
+
+     DEBUG_PRINTING(DBG_PRINT_DETAILS, 
+                    std::cout << "\nFlushed " << as.size() << " symbolic assignments";
+                    print(std::cout << "\nstate_ after flush:"););
+     symbolic_store_.clear();
+     symbolic_last_voc_.clear();
+   }
+
   //===----------------------------------------------------------------------===//
   //                     Terminator Instruction Implementations
   //===----------------------------------------------------------------------===//
@@ -370,6 +454,17 @@ namespace llvm_abstract_transformer {
     return false;
   }
 
+  void WrappedDomainBBAbsTransCreator::SetWrapFreeValues
+  (const std::set<const Value*>& signed_values, const std::set<const Value*>& unsigned_values) {
+    wrap_free_signed_values_ = signed_values;
+    wrap_free_unsigned_values_ = unsigned_values;
+  }
+
+  bool WrappedDomainBBAbsTransCreator::IsWrapFree(const Value* v, bool is_signed) const {
+    const std::set<const Value*>& wrap_free_values = is_signed ? wrap_free_signed_values_ : wrap_free_unsigned_values_;
+    return (wrap_free_values.find(v) != wrap_free_values.end());
+  }
+
 
   // Creates the merge function for non-model functions
   wali::IMergeFn* WrappedDomainBBAbsTransCreator::obtainMergeFunc(llvm::CallSite& cs) {
@@ -595,6 +690,9 @@ namespace llvm_abstract_transformer {
     }
 
     
+    if(!Ty->isVectorTy() && GetBitsizeFromType(Ty) != utils::one && AssignLinearOperation(I))
+      return;
+
     WrappedDomain_Int Src1 = getOperandValue(I.getOperand(0));
     WrappedDomain_Int Src2 = getOperandValue(I.getOperand(1));
     WrappedDomain_Int R = WrappedDomain_Int(GetBitsizeFromType(Ty), av_prevoc_);
@@ -634,8 +732,9 @@ namespace llvm_abstract_transformer {
   abstractExecuteICMP_EQ(WrappedDomain_Int& Src1, WrappedDomain_Int& Src2, Type *Ty) {
     std::pair<ref_ptr<BitpreciseWrappedAbstractValue>, ref_ptr<BitpreciseWrappedAbstractValue> > ret;
     // Avoid multiple calls to wrap, only added for performance
-    Src1.wrap(true/*is_signed*/);
-    Src2.wrap(true/*is_signed*/);
+    bool is_signed = Src1.preferred_signedness(Src2);
+    Src1.wrap(is_signed);
+    Src2.wrap(is_signed);
 
     ret.first = Src1.abs_equal(Src2); // True case
     ret.second = Src1.abs_not_equal(Src2); // False case
@@ -646,8 +745,9 @@ namespace llvm_abstract_transformer {
   abstractExecuteICMP_NE(WrappedDomain_Int& Src1, WrappedDomain_Int& Src2, Type *Ty) {
     std::pair<ref_ptr<BitpreciseWrappedAbstractValue>, ref_ptr<BitpreciseWrappedAbstractValue> > ret;
     // Avoid multiple calls to wrap, only added for performance
-    Src1.wrap(true/*is_signed*/);
-    Src2.wrap(true/*is_signed*/);
+    bool is_signed = Src1.preferred_signedness(Src2);
+    Src1.wrap(is_signed);
+    Src2.wrap(is_signed);
 
     ret.first = Src1.abs_not_equal(Src2); // True case
     ret.second = Src1.abs_equal(Src2); // False case
@@ -757,6 +857,13 @@ namespace llvm_abstract_transformer {
     WrappedDomain_Int Src1 = getOperandValue(I.getOperand(0));
     WrappedDomain_Int Src2 = getOperandValue(I.getOperand(1));
     std::pair<ref_ptr<BitpreciseWrappedAbstractValue>, ref_ptr<BitpreciseWrappedAbstractValue> > R;   // Result
+
+    // Equalities are wrapped with the preferred signedness by abstractExecuteICMP_EQ and abstractExecuteICMP_NE
+    bool is_signed = I.isEquality() ? Src1.preferred_signedness(Src2) : I.isSigned();
+    if(IsWrapFree(I.getOperand(0), is_signed))
+      Src1.assume_wrapped(is_signed);
+    if(IsWrapFree(I.getOperand(1), is_signed))
+      Src2.assume_wrapped(is_signed);
   
     switch (I.getPredicate()) {
     case ICmpInst::ICMP_EQ:  R = abstractExecuteICMP_EQ(Src1,  Src2, Ty); break;
@@ -966,6 +1073,8 @@ namespace llvm_abstract_transformer {
       const unsigned LoadBytes = TD.getTypeStoreSize(Ty);
       // Number of bytes match, it is okay to load this value as a WrappedDomain_Int
       if(LoadBytes == p.second) {
+        if(AssignLoad(I))
+          return;
         WrappedDomain_Int Result = WrappedDomain_Int::of_variable(state_, abstract_domain::replaceVersion(p.first, 0, 1), av_prevoc_->GetVocabulary());
         SetValue(&I, Result);
       }
@@ -979,7 +1088,6 @@ namespace llvm_abstract_transformer {
   }
 
   void WrappedDomainBBAbsTransCreator::abstractExecuteStore(StoreInst &I) {
-    WrappedDomain_Int Val = getOperandValue(I.getValueOperand());
     Value* PtrDest = I.getPointerOperand();
 
     std::map<Value*, std::pair<DimensionKey, unsigned> >::iterator it = alloca_map_.find(PtrDest);
@@ -991,6 +1099,9 @@ namespace llvm_abstract_transformer {
       std::pair<DimensionKey, unsigned> p = it->second;
       // Number of bytes match, it is okay to load this value as a WrappedDomain_Int
       if(StoreBytes == p.second) {
+        if(AssignStore(I))
+          return;
+        WrappedDomain_Int Val = getOperandValue(I.getValueOperand());
         SetDimensionInState(abstract_domain::replaceVersion(p.first, 0, 1), Val);
       } else {
         // Set this key to top as the number of bytes updated don't match
@@ -1195,14 +1306,20 @@ namespace llvm_abstract_transformer {
   }
 
   void WrappedDomainBBAbsTransCreator::abstractExecuteTrunc(TruncInst &I) {
+    if(AssignIntegerCast(I))
+      return;
     SetValue(&I, abstractExecuteTrunc(I.getOperand(0), I.getType()));
   }
 
   void WrappedDomainBBAbsTransCreator::abstractExecuteSExt(SExtInst &I) {
+    if(AssignIntegerCast(I))
+      return;
     SetValue(&I, abstractExecuteSExt(I.getOperand(0), I.getType()));
   }
 
   void WrappedDomainBBAbsTransCreator::abstractExecuteZExt(ZExtInst &I) {
+    if(AssignIntegerCast(I))
+      return;
     SetValue(&I, abstractExecuteZExt(I.getOperand(0), I.getType()));
   }
 
@@ -1434,6 +1551,149 @@ namespace llvm_abstract_transformer {
     return WrappedDomain_Int(GetBitsizeFromType(v->getType()), av_prevoc_);
   }
 
+  // Sets e to v if v is an integer constant (as its unsigned bit-pattern, like getConstantValue), to the
+  // expression of v in symbolic_store_, or to the dimension of v if it is in state_
+  bool WrappedDomainBBAbsTransCreator::GetAffineForm(Value* v, AbstractValue::affexp_type& e) const {
+    if(ConstantInt* ci = dyn_cast<ConstantInt>(v)) {
+      unsigned width = ci->getBitWidth();
+      if(width != 1 && width != 8 && width != 16 && width != 32 && width != 64)
+        return false;
+      e = AbstractValue::affexp_type(AbstractValue::linexp_type(), mpz_class(ci->getValue().toString(10, false/*signed*/)));
+      return true;
+    }
+
+    value_to_dim_t::const_iterator vec_it = findByValue(instr_value_to_dim_, v);
+    if(vec_it == instr_value_to_dim_.end())
+      return false;
+    DimensionKey k_prime = abstract_domain::replaceVersion(vec_it->second, 0, 1);
+    std::map<DimensionKey, AbstractValue::affexp_type>::const_iterator sit = symbolic_store_.find(k_prime);
+    if(sit != symbolic_store_.end()) {
+      e = sit->second;
+      return true;
+    }
+    if(!state_->GetVocabulary().count(k_prime))
+      return false;
+    AbstractValue::linexp_type le; le.insert(AbstractValue::linexp_type::value_type(k_prime, mpz_class(1)));
+    e = AbstractValue::affexp_type(le, mpz_class(0));
+    return true;
+  }
+
+  bool WrappedDomainBBAbsTransCreator::AssignAffineInState(DimensionKey k, const AbstractValue::affexp_type& e) {
+    DimensionKey k_prime = abstract_domain::replaceVersion(k, 0, 1);
+    if(symbolic_execution_) {
+      symbolic_store_[k_prime] = e;
+      return true;
+    }
+    if(!state_->GetVocabulary().count(k_prime))
+      return false;
+    state_->AssignAffine(k_prime, e);
+    DEBUG_PRINTING(DBG_PRINT_EVERYTHING,
+                   abstract_domain::print(std::cout << "\nAssigned affine expression to ", k_prime);
+                   print(std::cout << "\nstate_ after assignment:"););
+    return true;
+  }
+
+  bool WrappedDomainBBAbsTransCreator::AssignAffineValue(Value* v, const AbstractValue::affexp_type& e) {
+    value_to_dim_t::const_iterator vec_it = findByValue(instr_value_to_dim_, v);
+    if(vec_it == instr_value_to_dim_.end())
+      return false;
+    return AssignAffineInState(vec_it->second, e);
+  }
+
+  // Handles add, sub and mul by a constant the same way as WrappedDomain_Int::plus, minus and times,
+  // that is without wrapping the result
+  bool WrappedDomainBBAbsTransCreator::AssignLinearOperation(BinaryOperator& I) {
+    AbstractValue::affexp_type e1, e2;
+    if(!GetAffineForm(I.getOperand(0), e1) || !GetAffineForm(I.getOperand(1), e2))
+      return false;
+
+    AbstractValue::affexp_type e;
+    switch(I.getOpcode()) {
+    case Instruction::Add:
+    case Instruction::Sub: {
+      mpz_class sign = (I.getOpcode() == Instruction::Add) ? mpz_class(1) : mpz_class(-1);
+      e = e1;
+      for(AbstractValue::linexp_type::const_iterator it = e2.first.begin(); it != e2.first.end(); it++) {
+        e.first[it->first] += sign * it->second;
+      }
+      e.second += sign * e2.second;
+      break;
+    }
+    case Instruction::Mul: {
+      // One of the operands has to be a constant
+      if(!e2.first.empty())
+        std::swap(e1, e2);
+      if(!e2.first.empty())
+        return false;
+      e = e1;
+      for(AbstractValue::linexp_type::iterator it = e.first.begin(); it != e.first.end(); it++) {
+        it->second *= e2.second;
+      }
+      e.second *= e2.second;
+      break;
+    }
+    default:
+      return false;
+    }
+    return AssignAffineValue(&I, e);
+  }
+
+  // Trunc does not change the value. Extensions do not change values that are in range for their signedness,
+  // that is constants, or dimensions already wrapped with the signedness in state_.
+  bool WrappedDomainBBAbsTransCreator::AssignIntegerCast(CastInst& I) {
+    Value* src = I.getOperand(0);
+    if(!src->getType()->isIntegerTy() || !I.getType()->isIntegerTy() || GetBitsizeFromType(src->getType()) == utils::one)
+      return false;
+    AbstractValue::affexp_type e;
+    if(!GetAffineForm(src, e))
+      return false;
+
+    if(I.getOpcode() == Instruction::SExt || I.getOpcode() == Instruction::ZExt) {
+      bool is_signed = (I.getOpcode() == Instruction::SExt);
+      if(e.first.empty()) {
+        ConstantInt* ci = cast<ConstantInt>(src);
+        e.second = mpz_class(ci->getValue().toString(10, is_signed));
+      } else {
+        // Only a copy of a dimension wrapped to the range of src
+        bool wrapped_is_signed;
+        if(e.second != 0 || e.first.size() != 1 || e.first.begin()->second != 1
+           || e.first.begin()->first.GetBitsize() != GetBitsizeFromType(src->getType())
+           || !state_->IsWrapped(e.first.begin()->first, wrapped_is_signed) || wrapped_is_signed != is_signed)
+          return false;
+      }
+    } else if(I.getOpcode() != Instruction::Trunc) {
+      return false;
+    }
+    return AssignAffineValue(&I, e);
+  }
+
+  // A load of an alloca of the same size copies its dimension
+  bool WrappedDomainBBAbsTransCreator::AssignLoad(LoadInst& I) {
+    std::map<Value*, std::pair<DimensionKey, unsigned> >::const_iterator it = alloca_map_.find(I.getPointerOperand());
+    if(it == alloca_map_.end() || TD.getTypeStoreSize(I.getType()) != it->second.second)
+      return false;
+    DimensionKey p_prime = abstract_domain::replaceVersion(it->second.first, 0, 1);
+    AbstractValue::affexp_type e;
+    std::map<DimensionKey, AbstractValue::affexp_type>::const_iterator sit = symbolic_store_.find(p_prime);
+    if(sit != symbolic_store_.end()) {
+      e = sit->second;
+    } else {
+      if(!state_->GetVocabulary().count(p_prime))
+        return false;
+      AbstractValue::linexp_type le; le.insert(AbstractValue::linexp_type::value_type(p_prime, mpz_class(1)));
+      e = AbstractValue::affexp_type(le, mpz_class(0));
+    }
+    return AssignAffineValue(&I, e);
+  }
+
+  bool WrappedDomainBBAbsTransCreator::AssignStore(StoreInst& I) {
+    std::map<Value*, std::pair<DimensionKey, unsigned> >::const_iterator it = alloca_map_.find(I.getPointerOperand());
+    if(it == alloca_map_.end() || TD.getTypeStoreSize(I.getValueOperand()->getType()) != it->second.second)
+      return false;
+    AbstractValue::affexp_type e;
+    return GetAffineForm(I.getValueOperand(), e) && AssignAffineInState(it->second.first, e);
+  }
+
   // Perform vanilla meet of state with val 
   void WrappedDomainBBAbsTransCreator::Meet(const ref_ptr<BitpreciseWrappedAbstractValue>& val) {
     state_->VanillaMeet(val.get_ptr());
@@ -86,6 +86,18 @@ namespace llvm_abstract_transformer {
     ref_ptr<abstract_domain::BitpreciseWrappedAbstractValue> state_;
 
     bool add_array_bounds_check_;
+
+    // Values found by IntervalPreAnalysis to be in the signed (resp. unsigned) range of their type.
+    // Comparisons only add the bounding constraints on them instead of wrapping them.
+    std::set<const llvm::Value*> wrap_free_signed_values_;
+    std::set<const llvm::Value*> wrap_free_unsigned_values_;
+
+    // Symbolic execution of the straight-line affine instructions of a BasicBlock (see abstractExecuteBasicBlock).
+    // symbolic_store_ maps the dimensions assigned so far to their affine expressions over the values in state_,
+    // and symbolic_last_voc_ is the vocabulary state_ has after the last instruction executed symbolically.
+    bool symbolic_execution_;
+    std::map<abstract_domain::DimensionKey, abstract_domain::AbstractValue::affexp_type> symbolic_store_;
+    abstract_domain::Vocabulary symbolic_last_voc_;
   public:
     // av is used to create initial state
     explicit WrappedDomainBBAbsTransCreator(std::unique_ptr<llvm::Module> M, ref_ptr<abstract_domain::AbstractValue> av, bool add_array_bounds_check);
@@ -100,6 +112,9 @@ namespace llvm_abstract_transformer {
 
     const llvm::DataLayout& getDataLayout() const {return TD;}
 
+    void SetWrapFreeValues(const std::set<const llvm::Value*>& signed_values, const std::set<const llvm::Value*>& unsigned_values);
+    bool IsWrapFree(const llvm::Value* v, bool is_signed) const;
+
     bool isModel(const llvm::Function* f) const;
     wali::IMergeFn* obtainMergeFunc(llvm::CallSite& cs);
 
@@ -123,6 +138,18 @@ namespace llvm_abstract_transformer {
      const std::map<llvm::Instruction *, abstract_domain::Vocabulary>& insLiveAfterMap,
      const abstract_domain::Vocabulary& pre_post_voc);
 
+    // The vocabulary of state_ while executing I: pre_post_voc, the live variables around I and the vocabulary of I
+    abstract_domain::Vocabulary GetInstructionStateVocabulary
+    (llvm::Instruction& I, 
+     const std::map<llvm::Instruction *, abstract_domain::Vocabulary>& insLiveBeforeMap,
+     const std::map<llvm::Instruction *, abstract_domain::Vocabulary>& insLiveAfterMap,
+     const abstract_domain::Vocabulary& pre_post_voc) const;
+
+    // Records the assignment of I in symbolic_store_ if it is affine, and returns false otherwise.
+    // FlushSymbolicStore applies the recorded assignments to state_ as one parallel assignment.
+    bool SymbolicExecuteInst(llvm::Instruction& I, const abstract_domain::Vocabulary& ins_state_voc);
+    void FlushSymbolicStore();
+
     // Opcode Implementations
     // All of these instructions should be the end of this BasicBlock as they have multiple
     // successor or perform call, branch or return
@@ -288,6 +315,17 @@ private:  // Helper functions
 
     WrappedDomain_Int GetValue(llvm::Value* v) const;
 
+    // In-place assignments of the values that are affine in the dimensions of state_. These avoid the copies
+    // and the meet of SetDimensionInState, they return false when the assignment is not affine.
+    // During symbolic execution, the assignments are recorded in symbolic_store_ instead.
+    bool GetAffineForm(llvm::Value* v, abstract_domain::AbstractValue::affexp_type& e) const;
+    bool AssignAffineInState(abstract_domain::DimensionKey k, const abstract_domain::AbstractValue::affexp_type& e);
+    bool AssignAffineValue(llvm::Value* v, const abstract_domain::AbstractValue::affexp_type& e);
+    bool AssignLinearOperation(llvm::BinaryOperator& I);
+    bool AssignIntegerCast(llvm::CastInst& I);
+    bool AssignLoad(llvm::LoadInst& I);
+    bool AssignStore(llvm::StoreInst& I);
+
     // Perform meet of state with val (val might have wrapped vocabulary, 
     // so this function tries to preserv precision by soundly adding 
     // BoundingConstraints on Meet if it can
@@ -13,7 +13,24 @@
 #include "llvm/Transforms/Scalar.h"
 
 #include "llvm/Analysis/LazyCallGraph.h"
+#include "llvm/Analysis/CallGraph.h"
+#include "llvm/ADT/SCCIterator.h"
+#include "llvm/IR/CFG.h"
+#include "llvm/Support/raw_ostream.h"
 #include "utils/timer/timer.hpp"
+#include "src/reinterp/wrapped_domain/WfaSerialization.hpp"
+#include "src/reinterp/wrapped_domain/IntervalPreAnalysis.hpp"
+#include "src/reinterp/wrapped_domain/SignednessInference.hpp"
+#include "src/reinterp/wrapped_domain/RuleCollector.hpp"
+#include "wali/wfa/TransFunctor.hpp"
+#include "wali/wfa/ITrans.hpp"
+#include "wali/wpds/RuleFunctor.hpp"
+#include "wali/wpds/ewpds/ERule.hpp"
+
+#include <fstream>
+#include <algorithm>
+#include <climits>
+#include <stdint.h>
 
 using namespace llvm;
 using namespace abstract_domain;
@@ -21,6 +38,15 @@ using namespace llvm_abstract_transformer;
 
 extern const char* cmdlineparam__filename;
 extern bool cmdlineparam_allow_phis;
+extern unsigned cmdlineparam_function_time_budget;
+extern unsigned cmdlineparam_function_memory_budget;
+extern unsigned cmdlineparam_constraint_budget;
+extern unsigned cmdlineparam_time_budget;
+extern unsigned cmdlineparam_memory_budget;
+extern bool cmdlineparam_slice;
+extern bool cmdlineparam_compress_chains;
+extern bool cmdlineparam_interval_preanalysis;
+extern bool cmdlineparam_infer_signedness;
 
 // Register live variable pass
 namespace {
@@ -86,6 +112,14 @@ WrappedDomainWPDSCreator::WrappedDomainWPDSCreator(std::unique_ptr<Module> M, re
   // State keys
   program_ = wali::getKey("program");
   min_max_voc_size = std::make_pair(100000u, 0u);
+  start_time_ = utils::myclock();
+  crt_func_ = NULL;
+  crt_func_start_time_ = start_time_;
+  crt_func_start_memory_ = 0;
+  slice_stats_.num_funcs = slice_stats_.num_bbs = slice_stats_.num_dims = 0;
+  num_compressed_keys_ = 0;
+  num_no_wrap_dims_ = 0;
+  num_shared_weight_values_ = 0;
 }
 
 WrappedDomainWPDSCreator::~WrappedDomainWPDSCreator() {
@@ -121,7 +155,16 @@ wali::Key WrappedDomainWPDSCreator::mk_wpds_key(BasicBlock::iterator start, Basi
   std::string func_name = getName(f);
   std::string bb_name = getName(bb);
   std::string ins_name = getName(start_ins);
-  return wali::getKey(func_name + "_" + bb_name + "_" + ins_name);
+  wali::Key key = wali::getKey(func_name + "_" + bb_name + "_" + ins_name);
+  key_to_func_[key] = func_name;
+  return key;
+}
+
+wali::Key WrappedDomainWPDSCreator::mk_bb_entry_key(BasicBlock* bb) {
+  BasicBlock::iterator first_non_phi_iter = bb->begin();
+  while(first_non_phi_iter != bb->end() && first_non_phi_iter->getOpcode() == Instruction::PHI)
+    first_non_phi_iter++;
+  return mk_wpds_key(first_non_phi_iter, bb, bb->getParent());
 }
 
 wali::Key WrappedDomainWPDSCreator::mk_unique_wpds_key(BasicBlock* bb) {
@@ -130,50 +173,114 @@ wali::Key WrappedDomainWPDSCreator::mk_unique_wpds_key(BasicBlock* bb) {
   std::string func_name = getName(bb->getParent());
   std::string bb_name = getName(bb);
   std::stringstream ss; ss << unique_id;
-  return wali::getKey(func_name + "_" + bb_name + "_" + ss.str());
+  wali::Key key = wali::getKey(func_name + "_" + bb_name + "_" + ss.str());
+  key_to_func_[key] = func_name;
+  return key;
 }
 
 wali::Key WrappedDomainWPDSCreator::mk_wpds_unreachable_key(const CallSite& CS) {
   std::string func_name = getName(CS.getInstruction()->getParent()->getParent());
   std::string bb_name = getName(CS.getInstruction()->getParent());
   std::string cs_name = getName(CS.getInstruction());
-  return wali::getKey("unreachable__" + func_name + "_" + bb_name + "_" + cs_name);
+  wali::Key key = wali::getKey("unreachable__" + func_name + "_" + bb_name + "_" + cs_name);
+  key_to_func_[key] = func_name;
+  return key;
 }
 
 wali::Key WrappedDomainWPDSCreator::mk_exit_wpds_key(Function* f) {
-  return wali::getKey("funcexit_" + getName(f));
+  wali::Key key = wali::getKey("funcexit_" + getName(f));
+  key_to_func_[key] = getName(f);
+  return key;
 }
 
 wali::Key WrappedDomainWPDSCreator::mk_exit_wpds_dummy_key(Function* f, llvm::CallInst* ci) {
-  return wali::getKey("funcexit_" + getName(f) + "_dummy_" + getName(ci));
+  wali::Key key = wali::getKey("funcexit_" + getName(f) + "_dummy_" + getName(ci));
+  key_to_func_[key] = getName(f);
+  return key;
 }
 
-bool is_loop_llvm_backedge(const Loop* L, const BasicBlock* bb, const BasicBlock* succ) {
-  // (bb, succ) is a backedge for L if succ is the loop header of Land bb is in Loop L
-  if(succ == L->getHeader() && L->contains(bb)) {
-    DEBUG_PRINTING(DBG_PRINT_OVERVIEW, 
-                   std::cout << "Found llvm backedge (bb,succ): (" << getName(bb) << "," << 
-                   getName(succ) << ")" << std::endl;);
-    return true;
+namespace {
+// Bourdoncle's algorithm for the weak topological order of a CFG ("Efficient chaotic iteration strategies
+// with widenings", FMPA'93). Only the heads of the components and the heads enclosing each basic block are
+// recorded, which is all that is needed to place the widening points.
+class WtoBuilder {
+private:
+  std::map<const BasicBlock*, unsigned> dfn_;
+  std::vector<const BasicBlock*> stack_;
+  std::vector<const BasicBlock*> crt_heads_;
+  unsigned num_;
+  std::set<const BasicBlock*>& heads_;
+  std::map<const BasicBlock*, std::vector<const BasicBlock*> >& enclosing_heads_;
+
+  unsigned visit(const BasicBlock* v) {
+    stack_.push_back(v);
+    num_++;
+    dfn_[v] = num_;
+    unsigned head = num_;
+    bool loop = false;
+    for(succ_const_iterator sit = succ_begin(v); sit != succ_end(v); sit++) {
+      const BasicBlock* w = *sit;
+      unsigned min = (dfn_[w] == 0) ? visit(w) : dfn_[w];
+      if(min <= head) {
+        head = min;
+        loop = true;
+      }
+    }
+
+    if(head == dfn_[v]) {
+      dfn_[v] = UINT_MAX;
+      const BasicBlock* element = stack_.back();
+      stack_.pop_back();
+      if(loop) {
+        while(element != v) {
+          dfn_[element] = 0;
+          element = stack_.back();
+          stack_.pop_back();
+        }
+        component(v);
+      } else {
+        enclosing_heads_[v] = crt_heads_;
+      }
+    }
+    return head;
   }
 
-  // Look into the subloops to see if it is a backedge for any of them
-  const std::vector<Loop*> subs = L->getSubLoops();
-  for(std::vector<Loop*>::const_iterator it = subs.begin(); it != subs.end(); it++) {
-    if(is_loop_llvm_backedge(*it, bb, succ))
-      return true;
+  void component(const BasicBlock* v) {
+    heads_.insert(v);
+    enclosing_heads_[v] = crt_heads_;
+    crt_heads_.push_back(v);
+    for(succ_const_iterator sit = succ_begin(v); sit != succ_end(v); sit++) {
+      if(dfn_[*sit] == 0)
+        visit(*sit);
+    }
+    crt_heads_.pop_back();
   }
-  return false;
-}
 
-bool WrappedDomainWPDSCreator::is_llvm_backedge(const BasicBlock* bb, const BasicBlock* succ) {
-  std::shared_ptr<llvm::LoopInfo> linfo = func_loop_infos_.at(bb->getParent());
-  for(LoopInfo::iterator lit = linfo->begin(); lit != linfo->end(); lit++) {
-    const Loop* L = *lit;
-    if(is_loop_llvm_backedge(L, bb, succ))
-      return true;    
+public:
+  WtoBuilder(std::set<const BasicBlock*>& heads, std::map<const BasicBlock*, std::vector<const BasicBlock*> >& enclosing_heads) 
+    : num_(0), heads_(heads), enclosing_heads_(enclosing_heads) {}
+
+  void build(const Function* f) {
+    visit(&f->getEntryBlock());
   }
-  return false;
+};
+}
+
+void WrappedDomainWPDSCreator::ComputeWto(Function* f) {
+  WtoBuilder wto(wto_heads_, wto_enclosing_heads_);
+  wto.build(f);
+}
+
+// (bb, succ) closes a cycle of the weak topological order if succ is the head of a component containing bb
+bool WrappedDomainWPDSCreator::is_wto_backedge(const BasicBlock* bb, const BasicBlock* succ) {
+  if(wto_heads_.find(succ) == wto_heads_.end())
+    return false;
+  if(bb == succ)
+    return true;
+  std::map<const BasicBlock*, std::vector<const BasicBlock*> >::const_iterator eh_it = wto_enclosing_heads_.find(bb);
+  if(eh_it == wto_enclosing_heads_.end())
+    return false;
+  return std::find(eh_it->second.begin(), eh_it->second.end(), succ) != eh_it->second.end();
 }
 
 // This is a call basic block if the first instruction is a call instruction
@@ -235,7 +342,10 @@ void WrappedDomainWPDSCreator::AddRuleToPds(ref_ptr<AbstractValue> state_cp, wal
   // bb_abs_trans_cr_.Reduce(state_cp);
   ref_ptr<BitpreciseWrappedAbstractValue> state_cp_bpw =
     bb_abs_trans_cr_.GetBitpreciseWrappedState(state_cp);
-  state_cp_bpw->Project(voc);
+  Vocabulary sliced_voc = SliceVocabulary(voc);
+  state_cp_bpw->Project(sliced_voc);
+  EnforceBudget(state_cp_bpw);
+  state_cp_bpw = HashConsWeightValue(state_cp_bpw);
   ref_ptr<AvSemiring> w = 
     new AvSemiring(state_cp_bpw.get_ptr(), wali::key2str(from_key), wali::key2str(to_key), wty);
   DEBUG_PRINTING(DBG_PRINT_OVERVIEW, 
@@ -243,14 +353,17 @@ void WrappedDomainWPDSCreator::AddRuleToPds(ref_ptr<AbstractValue> state_cp, wal
                  "," << wali::key2str(to_key) << ") is :";);
   DEBUG_PRINTING(DBG_PRINT_OVERVIEW, w->print(std::cout) << std::endl;);
   pds_->add_rule(program_, from_key, program_, to_key, w.get_ptr());
-  UpdateMinMaxVocabularySize(voc.size());
+  UpdateMinMaxVocabularySize(sliced_voc.size());
 }
 
 void WrappedDomainWPDSCreator::AddDelta0RuleToPds(ref_ptr<AbstractValue> state_cp, wali::Key from_key, WideningType wty, Vocabulary& voc) {
   // bb_abs_trans_cr_.Reduce(state_cp);
   ref_ptr<BitpreciseWrappedAbstractValue> state_cp_bpw =
     bb_abs_trans_cr_.GetBitpreciseWrappedState(state_cp);
-  state_cp_bpw->Project(voc);
+  Vocabulary sliced_voc = SliceVocabulary(voc);
+  state_cp_bpw->Project(sliced_voc);
+  EnforceBudget(state_cp_bpw);
+  state_cp_bpw = HashConsWeightValue(state_cp_bpw);
   ref_ptr<AvSemiring> w = 
     new AvSemiring(state_cp_bpw.get_ptr(), wali::key2str(from_key), std::string("NULL"), wty);
   DEBUG_PRINTING(DBG_PRINT_OVERVIEW, 
@@ -258,14 +371,17 @@ void WrappedDomainWPDSCreator::AddDelta0RuleToPds(ref_ptr<AbstractValue> state_c
                  ",NULL) is :";);
   DEBUG_PRINTING(DBG_PRINT_OVERVIEW, w->print(std::cout) << std::endl;);
   pds_->add_rule(program_, from_key, program_, w.get_ptr());
-  UpdateMinMaxVocabularySize(voc.size());
+  UpdateMinMaxVocabularySize(sliced_voc.size());
 }
 
 void WrappedDomainWPDSCreator::AddDelta2RuleToPds(ref_ptr<AbstractValue> state_cp, wali::Key from_key, wali::Key callee_entry_key, wali::Key to_key, WideningType wty, Vocabulary& voc, wali::IMergeFn* cf) {
   // bb_abs_trans_cr_.Reduce(state_cp);
   ref_ptr<BitpreciseWrappedAbstractValue> state_cp_bpw =
     bb_abs_trans_cr_.GetBitpreciseWrappedState(state_cp);
-  state_cp_bpw->Project(voc);
+  Vocabulary sliced_voc = SliceVocabulary(voc);
+  state_cp_bpw->Project(sliced_voc);
+  EnforceBudget(state_cp_bpw);
+  state_cp_bpw = HashConsWeightValue(state_cp_bpw);
 
   ref_ptr<AvSemiring> w_delta2 = new AvSemiring(state_cp_bpw, wali::key2str(from_key), wali::key2str(to_key) );
 
@@ -276,7 +392,8 @@ void WrappedDomainWPDSCreator::AddDelta2RuleToPds(ref_ptr<AbstractValue> state_c
   
   wali::wpds::ewpds::EWPDS* ewpds = dynamic_cast<wali::wpds::ewpds::EWPDS*>(pds_);
   if(ewpds) {
-    ewpds->add_rule(program_, from_key, program_, callee_entry_key, to_key, w_delta2.get_ptr(), cf); } else {
+    ewpds->add_rule(program_, from_key, program_, callee_entry_key, to_key, w_delta2.get_ptr(), cf);
+  } else {
     wali::wpds::fwpds::FWPDS* fwpds = dynamic_cast<wali::wpds::fwpds::FWPDS*>(pds_);
     fwpds->add_rule(program_, from_key, program_, callee_entry_key, to_key, w_delta2.get_ptr(), cf);
   }
@@ -325,7 +442,7 @@ void WrappedDomainWPDSCreator::abstractExecuteBasicBlock
   assert(first_non_phi_inst != NULL);
 
   BasicBlock::iterator end_iter;
-  wali::Key from_key = mk_wpds_key(crt_iter, bb, f);
+  wali::Key from_key = mk_bb_entry_key(bb);
   bool add_delta2_rule = false;
   bool initialize_state = true;
   llvm::CallInst* ci;
@@ -380,6 +497,7 @@ void WrappedDomainWPDSCreator::abstractExecuteBasicBlock
 
         // Add this key to the list of unreachable keys
         unreachable_keys_.insert(unreachable_key);
+        func_disjunct_relevant_keys_[getName(f)].insert(from_key);
       }
 
       if(add_delta2_rule && (end_iter != bb->end() && (Instruction*)end_iter != t_inst)) {
@@ -556,16 +674,16 @@ void WrappedDomainWPDSCreator::abstractExecuteBasicBlock
         }
       }
 
-      // Widening Type is WIDENING_RULE if (bb, succ) is a backedge
+      // Widening Type is WIDENING_RULE if (bb, succ) is a backedge of the weak topological order
       WideningType wty = REGULAR_WEIGHT;
-      if(is_llvm_backedge(bb, succ)) {
+      if(is_wto_backedge(bb, succ)) {
         wty = WIDENING_RULE;
         DEBUG_PRINTING(DBG_PRINT_OVERVIEW, 
                        std::cout << "Making this rule WIDENING_RULE as succ is:" << getName(succ) << std::endl;);
       }
 
       ref_ptr<AbstractValue> state = bb_abs_trans_cr_.GetState();
-      wali::Key succ_key = mk_wpds_key(succ_first_non_phi_iter, succ, f);
+      wali::Key succ_key = mk_bb_entry_key(succ);
 
       // Handle special case where succ contains unreachable
       // If it does create a unique id associated with succ
@@ -613,7 +731,7 @@ wali::wpds::WPDS* WrappedDomainWPDSCreator::createWPDS(bool is_fwpds) {
     PM.run(*getModule());
   }
 
-  // Step 1: Find loops in the program so that widening weights can be added accordingly
+  // Step 1: Find loops in the program and the widening points of the functions
   legacy::PassManager PM;
   LoopInfoWrapperPass* loopinfopass = new LoopInfoWrapperPass();
   PM.add(loopinfopass);
@@ -623,6 +741,16 @@ wali::wpds::WPDS* WrappedDomainWPDSCreator::createWPDS(bool is_fwpds) {
 
   func_loop_infos_ = collectloopinfo->getFunctionToLoopInfoMap();
 
+  // The widening points are the heads of the components of the weak topological order of each function.
+  // Unlike the LLVM loops, these also cut the cycles of irreducible CFGs.
+  for(Module::FunctionListType::iterator fit = getModule()->getFunctionList().begin(); fit != getModule()->getFunctionList().end(); fit++) {
+    Function* f = fit;
+    if (!f || (f && f->isDeclaration()))
+      continue;
+    ComputeWto(f);
+  }
+  DEBUG_PRINTING(DBG_PRINT_OVERVIEW, std::cout << "\nNumber of widening points:" << wto_heads_.size(););
+
   // Step 2: Perform live variable analysis
   llvm::DataLayout TD = bb_abs_trans_cr_.getDataLayout();
   legacy::PassManager PMLV;
@@ -631,22 +759,819 @@ wali::wpds::WPDS* WrappedDomainWPDSCreator::createWPDS(bool is_fwpds) {
   PMLV.add(lva);
   PMLV.run(*getModule());
 
+  // Step 3: Find the signedness of the dimensions, and the dimensions and values that never wrap. The
+  // signedness comes first, as it is the one the arguments are bounded with by GetStartingState.
+  BitpreciseWrappedAbstractValue::inferred_signedness.clear();
+  if(cmdlineparam_infer_signedness) {
+    ComputeInferredSignedness(lva);
+  }
+  BitpreciseWrappedAbstractValue::no_wrap_signed_voc.clear();
+  BitpreciseWrappedAbstractValue::no_wrap_unsigned_voc.clear();
+  if(cmdlineparam_interval_preanalysis) {
+    ComputeNoWrapInformation(lva);
+  }
+
+  // Step 4: Slice the program with respect to its assertions
+  if(cmdlineparam_slice) {
+    ComputeSlice(lva);
+  }
 
   for(Module::FunctionListType::iterator fit = getModule()->getFunctionList().begin(); fit != getModule()->getFunctionList().end(); fit++) {
     Function* f = fit;
     if (!f || (f && f->isDeclaration()))
       continue;
 
+    crt_func_ = f;
+    crt_func_start_time_ = utils::myclock();
+    if(cmdlineparam_function_memory_budget != 0)
+      crt_func_start_memory_ = utils::getResidentMemory();
+    crt_func_essential_voc_ = GetEssentialVocabulary(f, lva);
+    CollectDisjunctRelevantKeys(f);
+
     for(Function::BasicBlockListType::iterator bbit = fit->getBasicBlockList().begin(); bbit != fit->getBasicBlockList().end(); bbit++) {
       BasicBlock* bb = bbit;
+      if(sliced_bbs_.find(bb) != sliced_bbs_.end()) {
+        DEBUG_PRINTING(DBG_PRINT_OVERVIEW,
+                       std::cout << "\nSkipping sliced BB:" << getName(bb););
+        continue;
+      }
       DEBUG_PRINTING(DBG_PRINT_OVERVIEW,
                      std::cout << "\nAnalyzing BB:" << getName(bb););
       abstractExecuteBasicBlock(bb, lva);
     }
   }
+  crt_func_ = NULL;
+  DEBUG_PRINTING(DBG_PRINT_OVERVIEW, std::cout << "\nHash-consing shared " << num_shared_weight_values_ << " rule weights";);
+  weight_values_.clear();
+
+  // Step 5: Fuse the straight-line chains of rules
+  if(cmdlineparam_compress_chains) {
+    CompressRuleChains();
+  }
   return pds_;
 }
 
+std::string WrappedDomainWPDSCreator::GetFunctionName(wali::Key key) const {
+  std::map<wali::Key, std::string>::const_iterator kf_it = key_to_func_.find(key);
+  if(kf_it == key_to_func_.end())
+    return "";
+  return kf_it->second;
+}
+
+void WrappedDomainWPDSCreator::DegradeOutsideCallChains(const std::set<std::string>& funcs, DegradationLevel level) {
+  // Collect the callers and the callees of each function
+  std::map<std::string, std::set<std::string> > callers, callees;
+  for(Module::FunctionListType::iterator fit = getModule()->getFunctionList().begin(); fit != getModule()->getFunctionList().end(); fit++) {
+    Function* f = fit;
+    if (!f || (f && f->isDeclaration()))
+      continue;
+    for(Function::BasicBlockListType::iterator bbit = f->getBasicBlockList().begin(); bbit != f->getBasicBlockList().end(); bbit++) {
+      for(BasicBlock::iterator iit = bbit->begin(); iit != bbit->end(); iit++) {
+        CallInst* ci = dyn_cast<CallInst>(iit);
+        if(ci && ci->getCalledFunction()) {
+          callers[getName(ci->getCalledFunction())].insert(getName(f));
+          callees[getName(f)].insert(getName(ci->getCalledFunction()));
+        }
+      }
+    }
+  }
+
+  // Find the functions on the call chains leading to funcs
+  std::set<std::string> relevant_funcs;
+  std::vector<std::string> worklist(funcs.begin(), funcs.end());
+  while(worklist.size() != 0) {
+    std::string func_name = worklist.back();
+    worklist.pop_back();
+    if(!relevant_funcs.insert(func_name).second)
+      continue;
+    const std::set<std::string>& func_callers = callers[func_name];
+    worklist.insert(worklist.end(), func_callers.begin(), func_callers.end());
+  }
+
+  // The summaries of the functions transitively called by funcs decide the values at their assertions,
+  // so they are relevant as well
+  std::set<std::string> callee_funcs;
+  worklist.assign(funcs.begin(), funcs.end());
+  while(worklist.size() != 0) {
+    std::string func_name = worklist.back();
+    worklist.pop_back();
+    if(!callee_funcs.insert(func_name).second)
+      continue;
+    relevant_funcs.insert(func_name);
+    const std::set<std::string>& func_callees = callees[func_name];
+    worklist.insert(worklist.end(), func_callees.begin(), func_callees.end());
+  }
+
+  for(Module::FunctionListType::iterator fit = getModule()->getFunctionList().begin(); fit != getModule()->getFunctionList().end(); fit++) {
+    Function* f = fit;
+    if (!f || (f && f->isDeclaration()) || isModel(f))
+      continue;
+    if(relevant_funcs.find(getName(f)) == relevant_funcs.end())
+      call_chain_degraded_funcs_[getName(f)] = level;
+  }
+}
+
+void CollectLoopHeadsAndLatches(const Loop* L, std::set<BasicBlock*>& bbs) {
+  bbs.insert(L->getHeader());
+  SmallVector<BasicBlock*, 4> latches;
+  L->getLoopLatches(latches);
+  bbs.insert(latches.begin(), latches.end());
+
+  const std::vector<Loop*> subs = L->getSubLoops();
+  for(std::vector<Loop*>::const_iterator it = subs.begin(); it != subs.end(); it++) {
+    CollectLoopHeadsAndLatches(*it, bbs);
+  }
+}
+
+void WrappedDomainWPDSCreator::CollectDisjunctRelevantKeys(Function* f) {
+  std::set<BasicBlock*> relevant_bbs;
+  std::shared_ptr<llvm::LoopInfo> linfo = func_loop_infos_.at(f);
+  for(LoopInfo::iterator lit = linfo->begin(); lit != linfo->end(); lit++) {
+    CollectLoopHeadsAndLatches(*lit, relevant_bbs);
+  }
+
+  for(Function::BasicBlockListType::iterator bbit = f->getBasicBlockList().begin(); bbit != f->getBasicBlockList().end(); bbit++) {
+    BasicBlock* bb = bbit;
+    for(BasicBlock::iterator iit = bb->begin(); iit != bb->end(); iit++) {
+      CallInst* ci = dyn_cast<CallInst>(iit);
+      if(ci && ci->getCalledFunction() && ci->getCalledFunction()->getName() == "__VERIFIER_assert") {
+        relevant_bbs.insert(bb);
+        for(pred_iterator pit = pred_begin(bb); pit != pred_end(bb); pit++) {
+          relevant_bbs.insert(*pit);
+        }
+        break;
+      }
+    }
+  }
+
+  std::set<wali::Key>& relevant_keys = func_disjunct_relevant_keys_[getName(f)];
+  for(std::set<BasicBlock*>::const_iterator it = relevant_bbs.begin(); it != relevant_bbs.end(); it++) {
+    BasicBlock* bb = *it;
+    relevant_keys.insert(mk_bb_entry_key(bb));
+  }
+}
+
+std::set<wali::Key> WrappedDomainWPDSCreator::GetDisjunctRelevantKeys() const {
+  std::set<wali::Key> relevant_keys;
+  for(std::map<std::string, std::set<wali::Key> >::const_iterator it = func_disjunct_relevant_keys_.begin(); it != func_disjunct_relevant_keys_.end(); it++) {
+    relevant_keys.insert(it->second.begin(), it->second.end());
+  }
+  return relevant_keys;
+}
+
+std::set<wali::Key> WrappedDomainWPDSCreator::GetDisjunctRelevantKeys(const std::set<wali::Key>& unreachable_keys) const {
+  std::set<wali::Key> relevant_keys;
+  for(std::set<wali::Key>::const_iterator it = unreachable_keys.begin(); it != unreachable_keys.end(); it++) {
+    std::map<wali::Key, std::string>::const_iterator kf_it = key_to_func_.find(*it);
+    if(kf_it == key_to_func_.end())
+      continue;
+    std::map<std::string, std::set<wali::Key> >::const_iterator fr_it = func_disjunct_relevant_keys_.find(kf_it->second);
+    if(fr_it != func_disjunct_relevant_keys_.end())
+      relevant_keys.insert(fr_it->second.begin(), fr_it->second.end());
+  }
+  return relevant_keys;
+}
+
+bool containsCallToAssert(BasicBlock* bb) {
+  for(BasicBlock::iterator iit = bb->begin(); iit != bb->end(); iit++) {
+    CallInst* ci = dyn_cast<CallInst>(iit);
+    if(ci && ci->getCalledFunction() && ci->getCalledFunction()->getName() == "__VERIFIER_assert")
+      return true;
+  }
+  return false;
+}
+
+bool containsCallToOneOf(BasicBlock* bb, const std::set<Function*>& funcs) {
+  for(BasicBlock::iterator iit = bb->begin(); iit != bb->end(); iit++) {
+    CallInst* ci = dyn_cast<CallInst>(iit);
+    if(ci && ci->getCalledFunction() && funcs.find(ci->getCalledFunction()) != funcs.end())
+      return true;
+  }
+  return false;
+}
+
+void MarkSliceRelevant(Value* v, std::set<Value*>& relevant, std::vector<Value*>& worklist) {
+  if(!isa<Instruction>(v) && !isa<Argument>(v) && !isa<GlobalVariable>(v))
+    return;
+  if(relevant.insert(v).second)
+    worklist.push_back(v);
+}
+
+// Collect the stores through ptr, or through a pointer derived from it. Return false if ptr
+// escapes (it is stored or passed to a call), as the stores through it can then be anywhere.
+bool CollectStoresThrough(Value* ptr, std::set<Value*>& visited, std::vector<StoreInst*>& stores) {
+  if(!visited.insert(ptr).second)
+    return true;
+  bool found_all = true;
+  for(Value::user_iterator uit = ptr->user_begin(); uit != ptr->user_end(); uit++) {
+    User* u = *uit;
+    if(StoreInst* si = dyn_cast<StoreInst>(u)) {
+      if(si->getPointerOperand() == ptr)
+        stores.push_back(si);
+      else
+        found_all = false;
+    } else if(isa<GetElementPtrInst>(u) || isa<CastInst>(u) || isa<ConstantExpr>(u) || isa<PHINode>(u) || isa<SelectInst>(u)) {
+      found_all = CollectStoresThrough(u, visited, stores) && found_all;
+    } else if(isa<CallInst>(u) || isa<InvokeInst>(u)) {
+      found_all = false;
+    }
+  }
+  return found_all;
+}
+
+void AddSlicedDimension(const DimensionKey& k, Vocabulary& voc) {
+  voc.insert(k);
+  voc.insert(DimensionKey(k.name, Version(0), k.bitsize));
+  voc.insert(DimensionKey(k.name, Version(1), k.bitsize));
+}
+
+// Compute the blocks which get no rules and the dimensions which are projected out of the weights of
+// each function, see GetSliceStats. Only the reachability of the assertions decides which blocks are
+// kept, so sliced_bbs_ is exact for the queries; the value dependences only decide precision.
+void WrappedDomainWPDSCreator::ComputeSlice(LiveVariableAnalysis* lva) {
+  utils::Timer slice_timer("slicing", std::cout, true);
+
+  // Collect the analyzed functions and the call sites of each of them
+  std::vector<Function*> funcs;
+  std::map<Function*, std::vector<CallInst*> > call_sites;
+  for(Module::FunctionListType::iterator fit = getModule()->getFunctionList().begin(); fit != getModule()->getFunctionList().end(); fit++) {
+    Function* f = fit;
+    if (!f || (f && f->isDeclaration()) || isModel(f))
+      continue;
+    funcs.push_back(f);
+  }
+  for(std::vector<Function*>::const_iterator fit = funcs.begin(); fit != funcs.end(); fit++) {
+    for(Function::iterator bbit = (*fit)->begin(); bbit != (*fit)->end(); bbit++) {
+      for(BasicBlock::iterator iit = bbit->begin(); iit != bbit->end(); iit++) {
+        CallInst* ci = dyn_cast<CallInst>(iit);
+        Function* callee = ci ? ci->getCalledFunction() : NULL;
+        if(callee && !callee->isDeclaration() && !isModel(callee))
+          call_sites[callee].push_back(ci);
+      }
+    }
+  }
+
+  // Step 1: Find the functions from whose entry an assertion can be reached
+  std::set<Function*> assert_funcs;
+  for(std::vector<Function*>::const_iterator fit = funcs.begin(); fit != funcs.end(); fit++) {
+    for(Function::iterator bbit = (*fit)->begin(); bbit != (*fit)->end(); bbit++) {
+      BasicBlock* bb = bbit;
+      if(containsCallToAssert(bb) || (add_array_bounds_check_ && containsCallToTrap(bb)))
+        assert_funcs.insert(*fit);
+    }
+  }
+  bool changed = true;
+  while(changed) {
+    changed = false;
+    for(std::map<Function*, std::vector<CallInst*> >::const_iterator it = call_sites.begin(); it != call_sites.end(); it++) {
+      if(assert_funcs.find(it->first) == assert_funcs.end())
+        continue;
+      for(std::vector<CallInst*>::const_iterator cit = it->second.begin(); cit != it->second.end(); cit++) {
+        if(assert_funcs.insert((*cit)->getParent()->getParent()).second)
+          changed = true;
+      }
+    }
+  }
+
+  // Step 2: Find the blocks from which an assertion can be reached. The exits of a function are
+  // relevant once the function is called from a relevant block, as an assertion may follow the call.
+  std::set<Function*> returning_funcs;
+  std::set<const BasicBlock*> relevant_bbs;
+  changed = true;
+  while(changed) {
+    changed = false;
+    relevant_bbs.clear();
+    for(std::vector<Function*>::const_iterator fit = funcs.begin(); fit != funcs.end(); fit++) {
+      bool is_returning = returning_funcs.find(*fit) != returning_funcs.end();
+      std::vector<BasicBlock*> worklist;
+      for(Function::iterator bbit = (*fit)->begin(); bbit != (*fit)->end(); bbit++) {
+        BasicBlock* bb = bbit;
+        if(containsCallToAssert(bb) || (add_array_bounds_check_ && containsCallToTrap(bb)) ||
+           containsCallToOneOf(bb, assert_funcs) || (is_returning && isa<ReturnInst>(bb->getTerminator())))
+          worklist.push_back(bb);
+      }
+      while(worklist.size() != 0) {
+        BasicBlock* bb = worklist.back();
+        worklist.pop_back();
+        if(!relevant_bbs.insert(bb).second)
+          continue;
+        for(pred_iterator pit = pred_begin(bb); pit != pred_end(bb); pit++) {
+          worklist.push_back(*pit);
+        }
+      }
+    }
+
+    for(std::map<Function*, std::vector<CallInst*> >::const_iterator it = call_sites.begin(); it != call_sites.end(); it++) {
+      if(returning_funcs.find(it->first) != returning_funcs.end())
+        continue;
+      for(std::vector<CallInst*>::const_iterator cit = it->second.begin(); cit != it->second.end(); cit++) {
+        if(relevant_bbs.find((*cit)->getParent()) != relevant_bbs.end()) {
+          returning_funcs.insert(it->first);
+          changed = true;
+          break;
+        }
+      }
+    }
+  }
+
+  // Step 3: Find the values the assertions depend on. The seeds are the asserted values and the
+  // conditions of the relevant blocks (as they decide whether an assertion is reached).
+  std::set<Value*> relevant;
+  std::vector<Value*> worklist;
+  for(std::vector<Function*>::const_iterator fit = funcs.begin(); fit != funcs.end(); fit++) {
+    for(Function::iterator bbit = (*fit)->begin(); bbit != (*fit)->end(); bbit++) {
+      BasicBlock* bb = bbit;
+      if(relevant_bbs.find(bb) == relevant_bbs.end())
+        continue;
+      for(BasicBlock::iterator iit = bb->begin(); iit != bb->end(); iit++) {
+        CallInst* ci = dyn_cast<CallInst>(iit);
+        if(ci && ci->getCalledFunction() && ci->getCalledFunction()->getName() == "__VERIFIER_assert")
+          MarkSliceRelevant(ci->getArgOperand(0), relevant, worklist);
+      }
+      TerminatorInst* t_inst = bb->getTerminator();
+      if(BranchInst* bi = dyn_cast<BranchInst>(t_inst)) {
+        if(bi->isConditional())
+          MarkSliceRelevant(bi->getCondition(), relevant, worklist);
+      } else if(SwitchInst* si = dyn_cast<SwitchInst>(t_inst)) {
+        MarkSliceRelevant(si->getCondition(), relevant, worklist);
+      } else if(IndirectBrInst* ibi = dyn_cast<IndirectBrInst>(t_inst)) {
+        MarkSliceRelevant(ibi->getAddress(), relevant, worklist);
+      }
+    }
+  }
+
+  // If the stores to a relevant memory location cannot be found, all the stores are relevant
+  bool all_stores_relevant = false, all_stores_marked = false;
+  while(true) {
+    while(worklist.size() != 0) {
+      Value* v = worklist.back();
+      worklist.pop_back();
+
+      // An argument depends on the actual parameters of the call sites
+      if(Argument* arg = dyn_cast<Argument>(v)) {
+        std::vector<CallInst*>& arg_call_sites = call_sites[arg->getParent()];
+        for(std::vector<CallInst*>::const_iterator cit = arg_call_sites.begin(); cit != arg_call_sites.end(); cit++) {
+          if(arg->getArgNo() < (*cit)->getNumArgOperands())
+            MarkSliceRelevant((*cit)->getArgOperand(arg->getArgNo()), relevant, worklist);
+        }
+        continue;
+      }
+
+      // A memory location depends on the values stored to it
+      if(isa<AllocaInst>(v) || isa<GlobalVariable>(v)) {
+        std::set<Value*> visited;
+        std::vector<StoreInst*> stores;
+        if(!CollectStoresThrough(v, visited, stores))
+          all_stores_relevant = true;
+        for(std::vector<StoreInst*>::const_iterator sit = stores.begin(); sit != stores.end(); sit++) {
+          MarkSliceRelevant((*sit)->getValueOperand(), relevant, worklist);
+        }
+        if(isa<GlobalVariable>(v))
+          continue;
+      }
+
+      // The result of a call depends on the values returned by the callee
+      Instruction* I = cast<Instruction>(v);
+      CallInst* ci = dyn_cast<CallInst>(I);
+      Function* callee = ci ? ci->getCalledFunction() : NULL;
+      if(callee && !callee->isDeclaration() && !isModel(callee)) {
+        for(Function::iterator bbit = callee->begin(); bbit != callee->end(); bbit++) {
+          ReturnInst* ri = dyn_cast<ReturnInst>(bbit->getTerminator());
+          if(ri && ri->getReturnValue())
+            MarkSliceRelevant(ri->getReturnValue(), relevant, worklist);
+        }
+        continue;
+      }
+
+      for(unsigned i = 0; i < I->getNumOperands(); i++) {
+        MarkSliceRelevant(I->getOperand(i), relevant, worklist);
+      }
+    }
+
+    if(!all_stores_relevant || all_stores_marked)
+      break;
+    all_stores_marked = true;
+    for(std::vector<Function*>::const_iterator fit = funcs.begin(); fit != funcs.end(); fit++) {
+      for(Function::iterator bbit = (*fit)->begin(); bbit != (*fit)->end(); bbit++) {
+        for(BasicBlock::iterator iit = bbit->begin(); iit != bbit->end(); iit++) {
+          StoreInst* si = dyn_cast<StoreInst>(iit);
+          if(si) {
+            MarkSliceRelevant(si->getValueOperand(), relevant, worklist);
+            MarkSliceRelevant(si->getPointerOperand(), relevant, worklist);
+          }
+        }
+      }
+    }
+  }
+
+  // Step 4: Record the sliced blocks and dimensions of each function
+  for(std::vector<Function*>::const_iterator fit = funcs.begin(); fit != funcs.end(); fit++) {
+    Function* f = *fit;
+    bool is_sliced_func = true;
+    for(Function::iterator bbit = f->begin(); bbit != f->end(); bbit++) {
+      BasicBlock* bb = bbit;
+      if(relevant_bbs.find(bb) == relevant_bbs.end()) {
+        sliced_bbs_.insert(bb);
+        slice_stats_.num_bbs++;
+      } else {
+        is_sliced_func = false;
+      }
+    }
+    if(is_sliced_func) {
+      DEBUG_PRINTING(DBG_PRINT_OVERVIEW, std::cout << "\nSliced function:" << getName(f););
+      slice_stats_.num_funcs++;
+      continue;
+    }
+
+    Vocabulary& sliced_voc = sliced_voc_[f];
+    const LiveVariableAnalysis::value_to_dim_t& valueToDimMap = lva->valueToDimMapMap[f];
+    for(LiveVariableAnalysis::value_to_dim_t::const_iterator it = valueToDimMap.begin(); it != valueToDimMap.end(); it++) {
+      if(relevant.find(it->first) == relevant.end())
+        AddSlicedDimension(it->second, sliced_voc);
+    }
+    const LiveVariableAnalysis::AllocaMap& allocaMap = lva->allocaMapMap[f];
+    for(LiveVariableAnalysis::AllocaMap::const_iterator it = allocaMap.begin(); it != allocaMap.end(); it++) {
+      if(relevant.find(it->first) == relevant.end())
+        AddSlicedDimension(it->second.first, sliced_voc);
+    }
+    slice_stats_.num_dims += getVocabularySubset(sliced_voc, Version(0)).size();
+    DEBUG_PRINTING(DBG_PRINT_OVERVIEW, abstract_domain::print(std::cout << "\nSliced dimensions of " << getName(f) << ":", sliced_voc););
+  }
+
+  std::cout << "\nSlicing removed " << slice_stats_.num_funcs << " functions, " << slice_stats_.num_bbs 
+            << " basic blocks and " << slice_stats_.num_dims << " dimensions";
+}
+
+// Remove the sliced dimensions of the current function from voc
+Vocabulary WrappedDomainWPDSCreator::SliceVocabulary(const Vocabulary& voc) const {
+  if(crt_func_ == NULL)
+    return voc;
+  std::map<const Function*, Vocabulary>::const_iterator sv_it = sliced_voc_.find(crt_func_);
+  if(sv_it == sliced_voc_.end())
+    return voc;
+  Vocabulary sliced_voc;
+  SubtractVocabularies(voc, sv_it->second, sliced_voc);
+  return sliced_voc;
+}
+
+SliceStats WrappedDomainWPDSCreator::GetSliceStats() const {
+  return slice_stats_;
+}
+
+// A key is removed if it is only a link of a chain: it has a single incoming and a single outgoing rule, both
+// delta1 rules, and it is neither a call site, return point, entry, exit, widening point nor one of the keys
+// whose transitions are looked up after post* (the assertions and the disjunct relevant points). Chains between
+// the kept keys are then fused into a single rule, whose weight is the extend of the weights of the chain.
+void WrappedDomainWPDSCreator::CompressRuleChains() {
+  wali::wpds::RuleCollector rc;
+  pds_->for_each(rc);
+
+  std::map<wali::Key, unsigned> in_degree, out_degree;
+  std::map<wali::Key, wali::wpds::rule_t> out_rule;
+  std::set<wali::Key> kept_keys(unreachable_keys_);
+  kept_keys.insert(unreachable_array_bounds_check_keys_.begin(), unreachable_array_bounds_check_keys_.end());
+  std::set<wali::Key> relevant_keys = GetDisjunctRelevantKeys();
+  kept_keys.insert(relevant_keys.begin(), relevant_keys.end());
+  for(std::vector<wali::wpds::rule_t>::const_iterator it = rc.rules_.begin(); it != rc.rules_.end(); it++) {
+    const wali::wpds::rule_t& r = *it;
+    out_degree[r->from_stack()]++;
+    out_rule[r->from_stack()] = r;
+    if(r->to_stack1() == wali::WALI_EPSILON) {
+      kept_keys.insert(r->from_stack());
+      continue;
+    }
+    in_degree[r->to_stack1()]++;
+    if(r->to_stack2() != wali::WALI_EPSILON) {
+      in_degree[r->to_stack2()]++;
+      kept_keys.insert(r->from_stack());
+      kept_keys.insert(r->to_stack1());
+      kept_keys.insert(r->to_stack2());
+    }
+    AvSemiring* w = dynamic_cast<AvSemiring*>(r->weight().get_ptr());
+    if(w->getWideningType() == WIDENING_RULE)
+      kept_keys.insert(r->to_stack1());
+  }
+
+  // Rebuild the WPDS, starting the chains at the rules leaving the kept keys
+  wali::wpds::WPDS* old_pds = pds_;
+  if(is_fwpds_)
+    pds_ = new wali::wpds::fwpds::FWPDS();
+  else
+    pds_ = new wali::wpds::ewpds::EWPDS();
+  std::set<wali::Key> removed_keys;
+  for(std::vector<wali::wpds::rule_t>::const_iterator it = rc.rules_.begin(); it != rc.rules_.end(); it++) {
+    const wali::wpds::rule_t& r = *it;
+    wali::Key from_key = r->from_stack();
+    bool is_link = (kept_keys.find(from_key) == kept_keys.end() && in_degree[from_key] == 1 && out_degree[from_key] == 1);
+    if(is_link)
+      continue;
+
+    if(r->to_stack2() != wali::WALI_EPSILON) {
+      const wali::wpds::ewpds::ERule* erule = dynamic_cast<const wali::wpds::ewpds::ERule*>(r.get_ptr());
+      assert(erule != NULL);
+      wali::wpds::ewpds::EWPDS* ewpds = dynamic_cast<wali::wpds::ewpds::EWPDS*>(pds_);
+      if(ewpds) {
+        ewpds->add_rule(program_, from_key, program_, r->to_stack1(), r->to_stack2(), r->weight(), erule->merge_fn());
+      } else {
+        wali::wpds::fwpds::FWPDS* fwpds = dynamic_cast<wali::wpds::fwpds::FWPDS*>(pds_);
+        fwpds->add_rule(program_, from_key, program_, r->to_stack1(), r->to_stack2(), r->weight(), erule->merge_fn());
+      }
+      continue;
+    }
+    if(r->to_stack1() == wali::WALI_EPSILON) {
+      pds_->add_rule(program_, from_key, program_, r->weight());
+      continue;
+    }
+
+    sem_elem_t w = r->weight();
+    WideningType wty = dynamic_cast<AvSemiring*>(w.get_ptr())->getWideningType();
+    wali::Key to_key = r->to_stack1();
+    while(kept_keys.find(to_key) == kept_keys.end() && in_degree[to_key] == 1 && out_degree[to_key] == 1) {
+      const wali::wpds::rule_t& next = out_rule[to_key];
+      removed_keys.insert(to_key);
+      w = w->extend(next->weight().get_ptr());
+      wty = dynamic_cast<AvSemiring*>(next->weight().get_ptr())->getWideningType();
+      to_key = next->to_stack1();
+    }
+    if(wty == WIDENING_RULE) {
+      // extend may return one of its operands, which is still the weight of another rule, so the
+      // widening type is set on a copy
+      ref_ptr<AvSemiring> av_w = new AvSemiring(*dynamic_cast<AvSemiring*>(w.get_ptr()));
+      av_w->setWideningType(WIDENING_RULE);
+      w = av_w.get_ptr();
+    }
+    pds_->add_rule(program_, from_key, program_, to_key, w);
+  }
+  rc.rules_.clear();
+  out_rule.clear();
+  delete old_pds;
+
+  num_compressed_keys_ = removed_keys.size();
+  DEBUG_PRINTING(DBG_PRINT_OVERVIEW, std::cout << "\nRule chain compression removed " << num_compressed_keys_ << " keys";);
+}
+
+// Runs IntervalPreAnalysis on each function for both signedness. The dimensions that never wrap are only
+// bounded when wrapped by BitpreciseWrappedAbstractValue, and the wrap-free values are only bounded by the
+// comparisons of bb_abs_trans_cr_.
+void WrappedDomainWPDSCreator::ComputeNoWrapInformation(LiveVariableAnalysis* lva) {
+  Vocabulary no_wrap_signed_voc, no_wrap_unsigned_voc;
+  std::set<const Value*> wrap_free_signed_values, wrap_free_unsigned_values;
+  ComputeNoWrapInformation(lva, true/*is_signed*/, no_wrap_signed_voc, wrap_free_signed_values);
+  ComputeNoWrapInformation(lva, false/*is_signed*/, no_wrap_unsigned_voc, wrap_free_unsigned_values);
+  BitpreciseWrappedAbstractValue::no_wrap_signed_voc = no_wrap_signed_voc;
+  BitpreciseWrappedAbstractValue::no_wrap_unsigned_voc = no_wrap_unsigned_voc;
+  bb_abs_trans_cr_.SetWrapFreeValues(wrap_free_signed_values, wrap_free_unsigned_values);
+
+  Vocabulary no_wrap_voc;
+  UnionVocabularies(no_wrap_signed_voc, no_wrap_unsigned_voc, no_wrap_voc);
+  num_no_wrap_dims_ = no_wrap_voc.size();
+  DEBUG_PRINTING(DBG_PRINT_OVERVIEW,
+                 std::cout << "\nInterval pre-analysis found " << num_no_wrap_dims_ << " no-wrap dimensions and "
+                           << wrap_free_signed_values.size() + wrap_free_unsigned_values.size() << " wrap-free values";);
+}
+
+// An argument is wrap-free if every call passes it a wrap-free value, and if GetStartingState bounds it with
+// is_signed (each function is also analyzed from its starting state). The wrap-free arguments are a greatest
+// fixpoint: they start as the arguments of the functions that are only called directly, and the arguments
+// passed a value that is not wrap-free are removed until none is.
+void WrappedDomainWPDSCreator::ComputeNoWrapInformation(LiveVariableAnalysis* lva, bool is_signed, Vocabulary& no_wrap_voc, std::set<const Value*>& wrap_free_values) {
+  llvm::DataLayout TD = bb_abs_trans_cr_.getDataLayout();
+  std::set<const Argument*> wrap_free_args;
+  for(Module::FunctionListType::iterator fit = getModule()->getFunctionList().begin(); fit != getModule()->getFunctionList().end(); fit++) {
+    Function* f = fit;
+    if (!f || (f && f->isDeclaration()))
+      continue;
+
+    bool is_only_called_directly = true;
+    for(Value::user_iterator uit = f->user_begin(); uit != f->user_end() && is_only_called_directly; uit++) {
+      Instruction* u = dyn_cast<Instruction>(*uit);
+      is_only_called_directly = (u != NULL && (isa<CallInst>(u) || isa<InvokeInst>(u)) && CallSite(u).getCalledFunction() == f);
+    }
+    if(!is_only_called_directly)
+      continue;
+
+    const LiveVariableAnalysis::value_to_dim_t& valueToDimMap = lva->valueToDimMapMap[f];
+    for(Function::arg_iterator ait = f->arg_begin(); ait != f->arg_end(); ait++) {
+      bool start_is_signed = true;
+      LiveVariableAnalysis::value_to_dim_t::const_iterator vit = valueToDimMap.find(ait);
+      if(vit != valueToDimMap.end())
+        BitpreciseWrappedAbstractValue::GetInferredSignedness(vit->second, start_is_signed);
+      if(start_is_signed == is_signed)
+        wrap_free_args.insert(ait);
+    }
+  }
+
+  bool changed;
+  do {
+    changed = false;
+    no_wrap_voc.clear();
+    wrap_free_values.clear();
+    std::set<const Argument*> wrapping_args;
+    for(Module::FunctionListType::iterator fit = getModule()->getFunctionList().begin(); fit != getModule()->getFunctionList().end(); fit++) {
+      Function* f = fit;
+      if (!f || (f && f->isDeclaration()))
+        continue;
+
+      const LiveVariableAnalysis::AllocaMap& allocaMap = lva->allocaMapMap[f];
+      IntervalPreAnalysis ipa(f, is_signed, allocaMap, TD, wto_heads_, wrap_free_args);
+      ipa.Run();
+      Vocabulary f_voc = ipa.GetNoWrapVocabulary();
+      no_wrap_voc.insert(f_voc.begin(), f_voc.end());
+      wrap_free_values.insert(ipa.GetWrapFreeValues().begin(), ipa.GetWrapFreeValues().end());
+      wrapping_args.insert(ipa.GetWrappingArguments().begin(), ipa.GetWrappingArguments().end());
+
+      DEBUG_PRINTING(DBG_PRINT_DETAILS,
+                     std::cout << "\nNo-wrap dimensions of " << f->getName().str() << (is_signed ? " (signed):" : " (unsigned):");
+                     abstract_domain::print(std::cout, f_voc););
+    }
+    for(std::set<const Argument*>::const_iterator it = wrapping_args.begin(); it != wrapping_args.end(); it++) {
+      if(wrap_free_args.erase(*it) > 0)
+        changed = true;
+    }
+  } while(changed);
+}
+
+// Runs SignednessInference on the module and records the signedness of the dimensions of each function,
+// by their pre-vocabulary key, in BitpreciseWrappedAbstractValue::inferred_signedness
+void WrappedDomainWPDSCreator::ComputeInferredSignedness(LiveVariableAnalysis* lva) {
+  SignednessInference si(getModule());
+  si.Run();
+
+  BitpreciseWrappedAbstractValue::VocabularySignedness inferred_signedness;
+  unsigned num_unsigned = 0;
+  for(Module::FunctionListType::iterator fit = getModule()->getFunctionList().begin(); fit != getModule()->getFunctionList().end(); fit++) {
+    Function* f = fit;
+    if (!f || (f && f->isDeclaration()))
+      continue;
+
+    std::vector<std::pair<const Value*, DimensionKey> > value_dims;
+    const LiveVariableAnalysis::value_to_dim_t& valueToDimMap = lva->valueToDimMapMap[f];
+    for(value_to_dim_t::const_iterator it = valueToDimMap.begin(); it != valueToDimMap.end(); it++) {
+      value_dims.push_back(std::make_pair(it->first, it->second));
+    }
+    const LiveVariableAnalysis::AllocaMap& allocaMap = lva->allocaMapMap[f];
+    for(LiveVariableAnalysis::AllocaMap::const_iterator it = allocaMap.begin(); it != allocaMap.end(); it++) {
+      value_dims.push_back(std::make_pair(it->first, it->second.first));
+    }
+
+    for(std::vector<std::pair<const Value*, DimensionKey> >::const_iterator it = value_dims.begin(); it != value_dims.end(); it++) {
+      bool is_signed;
+      if(!si.GetSignedness(it->first, is_signed))
+        continue;
+      DimensionKey k = it->second;
+      if(k.ver != UNVERSIONED_VERSION)
+        k.ver = 0;
+      if(inferred_signedness.insert(std::make_pair(k, is_signed)).second && !is_signed)
+        num_unsigned++;
+    }
+  }
+  BitpreciseWrappedAbstractValue::inferred_signedness = inferred_signedness;
+  DEBUG_PRINTING(DBG_PRINT_OVERVIEW, std::cout << "\nSignedness inference found " << num_unsigned << " unsigned dimensions out of " << inferred_signedness.size(););
+}
+
+unsigned WrappedDomainWPDSCreator::GetNumNoWrapDims() const {
+  return num_no_wrap_dims_;
+}
+
+unsigned WrappedDomainWPDSCreator::GetNumCompressedKeys() const {
+  return num_compressed_keys_;
+}
+
+// Rule weights are never modified once they are in the WPDS, so structurally identical values can be shared.
+// Sharing lets AvSemiring::isEqual compare them by pointer. The values are bucketed by AbstractValue::Hash,
+// and a value is only shared if it is structurally equal, as equal values with different representations
+// (eg. powersets with different disjuncts) can give different results once widened or merged.
+ref_ptr<BitpreciseWrappedAbstractValue> WrappedDomainWPDSCreator::HashConsWeightValue(const ref_ptr<BitpreciseWrappedAbstractValue>& av) {
+  std::vector<ref_ptr<BitpreciseWrappedAbstractValue> >& bucket = weight_values_[av->Hash()];
+  for(std::vector<ref_ptr<BitpreciseWrappedAbstractValue> >::const_iterator it = bucket.begin(); it != bucket.end(); it++) {
+    if((*it)->StructurallyEqual(*av)) {
+      num_shared_weight_values_++;
+      return *it;
+    }
+  }
+  bucket.push_back(av);
+  return av;
+}
+
+bool WrappedDomainWPDSCreator::GlobalBudgetExceeded() const {
+  if(cmdlineparam_time_budget != 0 && (utils::myclock() - start_time_) > (long)cmdlineparam_time_budget * 1000000)
+    return true;
+
+  // The current resident set size rather than its peak, so that the budget is no longer exceeded once
+  // memory is freed
+  if(cmdlineparam_memory_budget != 0 && utils::getResidentMemory() > (long)cmdlineparam_memory_budget)
+    return true;
+  return false;
+}
+
+std::map<std::string, DegradationLevel> WrappedDomainWPDSCreator::GetDegradedFunctions() const {
+  return degraded_funcs_;
+}
+
+std::map<std::string, DegradationLevel> WrappedDomainWPDSCreator::GetCallChainDegradedFunctions() const {
+  return call_chain_degraded_funcs_;
+}
+
+// The essential vocabulary of f is the vocabulary of the instructions that decide control flow
+// (comparisons, branches and switches), and that pass values across functions (calls and returns)
+Vocabulary WrappedDomainWPDSCreator::GetEssentialVocabulary(Function* f, LiveVariableAnalysis* lva) {
+  llvm::DataLayout TD = bb_abs_trans_cr_.getDataLayout();
+  LiveVariableAnalysis::AllocaMap& allocaMap = lva->allocaMapMap[f];
+  LiveVariableAnalysis::value_to_dim_t& valueToDimMap = lva->valueToDimMapMap[f];
+
+  Vocabulary essential_voc = CreateReturnVocabulary(f, Version(1));
+  for(Function::BasicBlockListType::iterator bbit = f->getBasicBlockList().begin(); bbit != f->getBasicBlockList().end(); bbit++) {
+    for(BasicBlock::iterator iit = bbit->begin(); iit != bbit->end(); iit++) {
+      Instruction* I = iit;
+      switch(I->getOpcode()) {
+      case Instruction::ICmp:
+      case Instruction::Br:
+      case Instruction::Switch:
+      case Instruction::Call:
+      case Instruction::Ret:
+        {
+          Vocabulary I_voc = GetInstructionVocabulary(I, *f, TD, valueToDimMap, allocaMap);
+          essential_voc.insert(I_voc.begin(), I_voc.end());
+        }
+        break;
+      default: break;
+      }
+    }
+  }
+  return essential_voc;
+}
+
+// Raise the degradation level of the current function if it exceeded its budgets, and coarsen
+// state accordingly. The per-function time and memory budgets raise the level by one for each elapsed
+// budget. The constraint budget raises the level until state fits in it.
+void WrappedDomainWPDSCreator::EnforceBudget(ref_ptr<BitpreciseWrappedAbstractValue>& state) {
+  if(crt_func_ == NULL)
+    return;
+
+  std::string func_name = getName(crt_func_);
+  // A function off the call chains starts at the level set by DegradeOutsideCallChains, only the levels
+  // above it are due to the budgets
+  DegradationLevel min_level = NO_DEGRADATION;
+  std::map<std::string, DegradationLevel>::const_iterator cc_it = call_chain_degraded_funcs_.find(func_name);
+  if(cc_it != call_chain_degraded_funcs_.end())
+    min_level = cc_it->second;
+  DegradationLevel level = min_level;
+  std::map<std::string, DegradationLevel>::const_iterator df_it = degraded_funcs_.find(func_name);
+  if(df_it != degraded_funcs_.end() && df_it->second > level)
+    level = df_it->second;
+
+  if(GlobalBudgetExceeded()) {
+    level = HAVOC_NON_ESSENTIAL;
+  } else {
+    long num_budgets_elapsed = 0;
+    if(cmdlineparam_function_time_budget != 0)
+      num_budgets_elapsed = (utils::myclock() - crt_func_start_time_) / ((long)cmdlineparam_function_time_budget * 1000000);
+    if(cmdlineparam_function_memory_budget != 0) {
+      long num_memory_budgets_elapsed = (utils::getResidentMemory() - crt_func_start_memory_) / (long)cmdlineparam_function_memory_budget;
+      if(num_memory_budgets_elapsed > num_budgets_elapsed)
+        num_budgets_elapsed = num_memory_budgets_elapsed;
+    }
+    if(num_budgets_elapsed > (long)HAVOC_NON_ESSENTIAL)
+      num_budgets_elapsed = HAVOC_NON_ESSENTIAL;
+    if(num_budgets_elapsed > (long)level)
+      level = (DegradationLevel)num_budgets_elapsed;
+  }
+
+  DegradationLevel applied_level = NO_DEGRADATION;
+  while(true) {
+    while(applied_level < level) {
+      applied_level = (DegradationLevel)(applied_level + 1);
+      switch(applied_level) {
+      case FEWER_DISJUNCTS:
+        state->Coarsen(1, false/*use_octagons*/);
+        break;
+      case OCTAGONAL_CONSTRAINTS:
+        state->Coarsen(1, true/*use_octagons*/);
+        break;
+      case HAVOC_NON_ESSENTIAL:
+        {
+          Vocabulary non_essential_voc;
+          SubtractVocabularies(state->GetVocabulary(), crt_func_essential_voc_, non_essential_voc);
+          state = static_cast<BitpreciseWrappedAbstractValue*>(state->Havoc(non_essential_voc).get_ptr());
+        }
+        break;
+      default: assert(false); break;
+      }
+    }
+
+    if(cmdlineparam_constraint_budget == 0 || level == HAVOC_NON_ESSENTIAL || state->NumConstraints() <= cmdlineparam_constraint_budget)
+      break;
+    level = (DegradationLevel)(level + 1);
+  }
+
+  if(level > min_level) {
+    if(df_it == degraded_funcs_.end() || df_it->second != level) {
+      std::cout << "\nDegrading the precision of function " << func_name << " to " << DegradationLevelName(level);
+    }
+    degraded_funcs_[func_name] = level;
+  }
+}
+
 // Return the query automaton (input to poststar)
 wali::wfa::WFA* WrappedDomainWPDSCreator::BuildAutomaton(bool is_backward, std::ostream * os) {
   wali::wfa::WFA* fa_prog = new wali::wfa::WFA(wali::wfa::WFA::INORDER, NULL);
@@ -712,6 +1637,258 @@ wali::wfa::WFA* WrappedDomainWPDSCreator::BuildAutomaton(bool is_backward, std::
   return fa_prog;
 }
 
+std::vector<CallGraphSCC> WrappedDomainWPDSCreator::GetCallGraphSCCs() {
+  std::vector<CallGraphSCC> sccs;
+  std::map<const Function*, unsigned> func_to_scc;
+  CallGraph callgraph(*getModule());
+
+  // scc_iterator visits an SCC only after all the SCCs it calls
+  for(scc_iterator<CallGraph*> sccit = scc_begin(&callgraph); !sccit.isAtEnd(); ++sccit) {
+    const std::vector<CallGraphNode*>& nodes = *sccit;
+    CallGraphSCC scc;
+    scc.level = 0;
+    for(std::vector<CallGraphNode*>::const_iterator nit = nodes.begin(); nit != nodes.end(); nit++) {
+      Function* f = (*nit)->getFunction();
+      if (!f || (f && f->isDeclaration()) || isModel(f))
+        continue;
+      scc.funcs.push_back(f);
+      func_to_scc[f] = sccs.size();
+    }
+    if(scc.funcs.size() == 0)
+      continue;
+
+    for(std::vector<CallGraphNode*>::const_iterator nit = nodes.begin(); nit != nodes.end(); nit++) {
+      for(CallGraphNode::iterator cit = (*nit)->begin(); cit != (*nit)->end(); cit++) {
+        std::map<const Function*, unsigned>::const_iterator fs_it = func_to_scc.find(cit->second->getFunction());
+        if(fs_it == func_to_scc.end() || fs_it->second == sccs.size())
+          continue;
+        scc.callees.insert(fs_it->second);
+        if(sccs[fs_it->second].level + 1 > scc.level)
+          scc.level = sccs[fs_it->second].level + 1;
+      }
+    }
+    sccs.push_back(scc);
+  }
+  return sccs;
+}
+
+wali::wfa::WFA* WrappedDomainWPDSCreator::BuildSummaryAutomaton(const std::vector<Function*>& funcs) {
+  wali::wfa::WFA* fa_summary = new wali::wfa::WFA(wali::wfa::WFA::INORDER, NULL);
+
+  ref_ptr<AvSemiring> st = new AvSemiring(bb_abs_trans_cr_.GetState(), "", "", REGULAR_WEIGHT);
+  fa_summary->addState(program_, st->zero());
+  fa_summary->setInitialState(program_);
+
+  for(std::vector<Function*>::const_iterator it = funcs.begin(); it != funcs.end(); it++) {
+    Function* f = *it;
+    wali::Key entry_key = mk_wpds_key(f->getEntryBlock().begin(), &(f->getEntryBlock()), f);
+    // post* generates the state (program, entry_key) for the calls to f
+    wali::Key call_state = wali::getKey(program_, entry_key);
+    fa_summary->addState(call_state, st->zero());
+    fa_summary->addFinalState(call_state);
+    fa_summary->addTrans(program_, entry_key, call_state, st->one());
+  }
+  return fa_summary;
+}
+
+namespace {
+  // Copies the transitions of a summary to another WFA, see SaveSummary
+  class SummaryTransCopier : public wali::wfa::ConstTransFunctor {
+  public:
+    const std::set<std::string>& funcs_;
+    const std::set<wali::Key>& call_states_;
+    const std::map<wali::Key, std::string>& key_to_func_;
+    wali::wfa::WFA& fa_;
+    SummaryTransCopier(const std::set<std::string>& funcs, const std::set<wali::Key>& call_states, 
+                       const std::map<wali::Key, std::string>& key_to_func, wali::wfa::WFA& fa) :
+      funcs_(funcs), call_states_(call_states), key_to_func_(key_to_func), fa_(fa) {}
+    virtual void operator()(const wali::wfa::ITrans* t) {
+      std::map<wali::Key, std::string>::const_iterator kf_it = key_to_func_.find(t->stack());
+      bool is_func_trans = (kf_it != key_to_func_.end() && funcs_.find(kf_it->second) != funcs_.end());
+      if(is_func_trans || call_states_.find(t->to()) != call_states_.end())
+        fa_.addTrans(t->from(), t->stack(), t->to(), t->weight());
+    }
+  };
+}
+
+void WrappedDomainWPDSCreator::SaveSummary(std::ostream& out, const wali::wfa::WFA& fa, const std::string& config, const std::vector<Function*>& funcs) {
+  std::set<std::string> func_names;
+  std::set<wali::Key> call_states;
+  for(std::vector<Function*>::const_iterator it = funcs.begin(); it != funcs.end(); it++) {
+    Function* f = *it;
+    func_names.insert(getName(f));
+    call_states.insert(wali::getKey(program_, mk_wpds_key(f->getEntryBlock().begin(), &(f->getEntryBlock()), f)));
+  }
+  wali::wfa::WFA fa_summary;
+  SummaryTransCopier stc(func_names, call_states, key_to_func_, fa_summary);
+  fa.for_each(stc);
+  SaveFixpoint(out, fa_summary, config);
+}
+
+// 64-bit FNV-1a hash of a string. Unlike std::hash, its value is fixed across
+// compilers and standard libraries, so fingerprints saved by one build of the
+// analyzer stay valid for another.
+static uint64_t Fnv1aHash(const std::string& s) {
+  uint64_t h = 14695981039346656037ULL;
+  for(std::string::const_iterator it = s.begin(); it != s.end(); it++) {
+    h ^= (unsigned char)(*it);
+    h *= 1099511628211ULL;
+  }
+  return h;
+}
+
+std::map<std::string, std::string> WrappedDomainWPDSCreator::GetFunctionFingerprints() {
+  std::map<std::string, std::string> fingerprints;
+  for(Module::FunctionListType::iterator fit = getModule()->getFunctionList().begin(); fit != getModule()->getFunctionList().end(); fit++) {
+    Function* f = fit;
+    if (!f || (f && f->isDeclaration()))
+      continue;
+
+    std::string f_ir;
+    llvm::raw_string_ostream f_ir_os(f_ir);
+    f->print(f_ir_os);
+    f_ir_os.flush();
+
+    std::stringstream ss; ss << std::hex << Fnv1aHash(f_ir);
+    fingerprints[getName(f)] = ss.str();
+  }
+  return fingerprints;
+}
+
+// Fixpoint file layout:
+//   config string
+//   number of functions, followed by (function name, fingerprint) pairs
+//   the post* transitions as written by SerializeWfaTransitions
+void WrappedDomainWPDSCreator::SaveFixpoint(const wali::wfa::WFA& fa, const std::string& config, const std::string& fixpoint_filename) {
+  std::ofstream out(fixpoint_filename);
+  if(!out.good()) {
+    std::cout << "\nCould not open fixpoint file " << fixpoint_filename << " for writing.";
+    return;
+  }
+  SaveFixpoint(out, fa, config);
+  out.close();
+}
+
+void WrappedDomainWPDSCreator::SaveFixpoint(std::ostream& out, const wali::wfa::WFA& fa, const std::string& config) {
+  SerializeString(out, config);
+  out << "\n";
+  std::map<std::string, std::string> fingerprints = GetFunctionFingerprints();
+  out << fingerprints.size() << "\n";
+  for(std::map<std::string, std::string>::const_iterator it = fingerprints.begin(); it != fingerprints.end(); it++) {
+    SerializeString(out, it->first);
+    SerializeString(out, it->second);
+    out << "\n";
+  }
+  SerializeWfaTransitions(out, fa);
+}
+
+unsigned WrappedDomainWPDSCreator::SeedAutomatonFromFixpoint(wali::wfa::WFA* fa, const std::string& config, const std::string& fixpoint_filename) {
+  std::ifstream in(fixpoint_filename);
+  if(!in.good()) {
+    std::cout << "\nNo previous fixpoint found in " << fixpoint_filename << ", analyzing from scratch.";
+    return 0;
+  }
+  return SeedAutomatonFromFixpoint(in, fa, config, false/*keep_all*/);
+}
+
+// The functions whose weights may depend on a function in changed_funcs. A change of a callee changes the
+// return transitions of its callers, and a change of a caller changes the call contexts of its callees, so
+// the dependencies are followed along the direct calls in both directions, transitively.
+std::set<std::string> WrappedDomainWPDSCreator::GetAffectedFunctions(const std::set<std::string>& changed_funcs) {
+  std::map<std::string, std::set<std::string> > neighbors;
+  for(Module::FunctionListType::iterator fit = getModule()->getFunctionList().begin(); fit != getModule()->getFunctionList().end(); fit++) {
+    Function* f = fit;
+    if (!f || (f && f->isDeclaration()))
+      continue;
+    for(Function::iterator bbit = f->begin(); bbit != f->end(); bbit++) {
+      for(BasicBlock::iterator iit = bbit->begin(); iit != bbit->end(); iit++) {
+        Instruction* I = iit;
+        if(!isa<CallInst>(I) && !isa<InvokeInst>(I))
+          continue;
+        Function* callee = CallSite(I).getCalledFunction();
+        if(callee == NULL || callee->isDeclaration())
+          continue;
+        neighbors[getName(f)].insert(getName(callee));
+        neighbors[getName(callee)].insert(getName(f));
+      }
+    }
+  }
+
+  std::set<std::string> affected_funcs(changed_funcs);
+  std::vector<std::string> worklist(changed_funcs.begin(), changed_funcs.end());
+  while(!worklist.empty()) {
+    std::string func_name = worklist.back();
+    worklist.pop_back();
+    const std::set<std::string>& func_neighbors = neighbors[func_name];
+    for(std::set<std::string>::const_iterator it = func_neighbors.begin(); it != func_neighbors.end(); it++) {
+      if(affected_funcs.insert(*it).second)
+        worklist.push_back(*it);
+    }
+  }
+  return affected_funcs;
+}
+
+// The transitions of the functions affected by an edit (see GetAffectedFunctions) are dropped. Their saved
+// weights are stale: they may be less precise than the new fixpoint, which post* would never recover as it
+// only combines into the weights of fa, or more precise, which would be unsound.
+unsigned WrappedDomainWPDSCreator::SeedAutomatonFromFixpoint(std::istream& in, wali::wfa::WFA* fa, const std::string& config, bool keep_all) {
+  std::string saved_config = DeserializeString(in);
+  if(saved_config != config) {
+    std::cout << "\nThe saved fixpoint was computed with different options, analyzing from scratch.";
+    return 0;
+  }
+
+  // Find the functions which changed since the fixpoint was saved
+  std::map<std::string, std::string> fingerprints = GetFunctionFingerprints();
+  std::set<std::string> unchanged_funcs;
+  size_t num_funcs = 0;
+  in >> num_funcs;
+  for(size_t i = 0; i < num_funcs; i++) {
+    std::string func_name = DeserializeString(in);
+    std::string fingerprint = DeserializeString(in);
+    std::map<std::string, std::string>::const_iterator f_it = fingerprints.find(func_name);
+    if(f_it != fingerprints.end() && f_it->second == fingerprint)
+      unchanged_funcs.insert(func_name);
+  }
+  std::cout << "\nIncremental analysis: " << (fingerprints.size() - unchanged_funcs.size()) << " of " 
+            << fingerprints.size() << " functions changed.";
+  bool same_program = (unchanged_funcs.size() == fingerprints.size() && num_funcs == fingerprints.size());
+  if(keep_all && !same_program) {
+    std::cout << "\nThe saved fixpoint belongs to a different program, analyzing from scratch.";
+    return 0;
+  }
+
+  std::set<std::string> changed_funcs;
+  for(std::map<std::string, std::string>::const_iterator it = fingerprints.begin(); it != fingerprints.end(); it++) {
+    if(unchanged_funcs.find(it->first) == unchanged_funcs.end())
+      changed_funcs.insert(it->first);
+  }
+  std::set<std::string> affected_funcs = GetAffectedFunctions(changed_funcs);
+  for(std::set<std::string>::const_iterator it = affected_funcs.begin(); it != affected_funcs.end(); it++) {
+    unchanged_funcs.erase(*it);
+  }
+  std::cout << "\nIncremental analysis: " << affected_funcs.size() << " of " << fingerprints.size() << " functions affected.";
+
+  ref_ptr<AbstractValue> av_wav = new BitpreciseWrappedAbstractValue(av_->Top(), BitpreciseWrappedAbstractValue::VocabularySignedness());
+  ref_ptr<AvSemiring> prototype = new AvSemiring(av_wav);
+  std::vector<SerializedTrans> saved_trans = DeserializeWfaTransitions(in, prototype);
+
+  unsigned num_seeded = 0;
+  for(std::vector<SerializedTrans>::const_iterator it = saved_trans.begin(); it != saved_trans.end(); it++) {
+    // Keep a transition only if its stack symbol is still generated by an unchanged function
+    if(!keep_all) {
+      std::map<wali::Key, std::string>::const_iterator kf_it = key_to_func_.find(it->stack);
+      if(kf_it == key_to_func_.end() || unchanged_funcs.find(kf_it->second) == unchanged_funcs.end())
+        continue;
+    }
+
+    fa->addTrans(it->from, it->stack, it->to, it->weight.get_ptr());
+    num_seeded++;
+  }
+  std::cout << "\nIncremental analysis: reused " << num_seeded << " of " << saved_trans.size() << " transitions.";
+  return num_seeded;
+}
+
 ref_ptr<AvSemiring> WrappedDomainWPDSCreator::GetStartingState(const Vocabulary& voc, Function& f) {
   Vocabulary double_voc;
   Vocabulary post_voc = abstract_domain::replaceVersion(voc, 0, 1);
@@ -728,9 +1905,11 @@ ref_ptr<AvSemiring> WrappedDomainWPDSCreator::GetStartingState(const Vocabulary&
 
   ref_ptr<BitpreciseWrappedAbstractValue> start_wav = dynamic_cast<BitpreciseWrappedAbstractValue*>(dynamic_cast<AvSemiring*>(av->one().get_ptr())->GetAbstractValue().get_ptr());
   
-  // TODO: Get signedness information by type inference. For now, we assume everything is signed
+  // Use the signedness found by SignednessInference, the dimensions without one are assumed to be signed
   for(Vocabulary::const_iterator it = voc.begin(); it != voc.end(); it++) {
-    vocab_sign.insert(std::pair<DimensionKey, bool>(*it, true/*is_signed*/));
+    bool is_signed = true;
+    BitpreciseWrappedAbstractValue::GetInferredSignedness(*it, is_signed);
+    vocab_sign.insert(std::pair<DimensionKey, bool>(*it, is_signed));
   }
 
   start_wav->AddBoundingConstraints(vocab_sign);
@@ -9,6 +9,38 @@
 
 namespace llvm_abstract_transformer {
 
+  // Precision degradation levels used for the rules of a function that exceeds its budgets.
+  // Each level includes the coarsening of the previous levels.
+  //   FEWER_DISJUNCTS: the weights are merged into a single disjunct
+  //   OCTAGONAL_CONSTRAINTS: the weights only keep their octagonal constraints
+  //   HAVOC_NON_ESSENTIAL: the weights lose all the constraints on the dimensions which are
+  //                        not used by the comparisons, calls and returns of the function
+  enum DegradationLevel {NO_DEGRADATION, FEWER_DISJUNCTS, OCTAGONAL_CONSTRAINTS, HAVOC_NON_ESSENTIAL};
+
+  inline std::string DegradationLevelName(DegradationLevel level) {
+    switch(level) {
+    case NO_DEGRADATION: return "none";
+    case FEWER_DISJUNCTS: return "fewer_disjuncts";
+    case OCTAGONAL_CONSTRAINTS: return "octagonal_constraints";
+    case HAVOC_NON_ESSENTIAL: return "havoc_non_essential";
+    }
+    return "";
+  }
+
+  // Sizes of the parts of the program removed by the slicing of createWPDS
+  struct SliceStats {
+    unsigned num_funcs;
+    unsigned num_bbs;
+    unsigned num_dims;
+  };
+
+  // A strongly connected component of the call graph, see GetCallGraphSCCs
+  struct CallGraphSCC {
+    std::vector<llvm::Function*> funcs;
+    std::set<unsigned> callees; // Indices of the other SCCs called from this one
+    unsigned level;             // 0 if no other SCC is called, else 1 + the maximum level of the callees
+  };
+
   // WrappedDomainWPDSCreator
   //
   // This class provides methods to create WPDS from a module <
@@ -39,6 +71,42 @@ namespace llvm_abstract_transformer {
     std::pair<size_t, size_t> min_max_voc_size;
     std::map<const llvm::Function*, std::shared_ptr<llvm::LoopInfo>> func_loop_infos_;
 
+    // The heads of the components of the weak topological orders, and the heads enclosing each
+    // basic block (outermost first), see ComputeWto
+    std::set<const llvm::BasicBlock*> wto_heads_;
+    std::map<const llvm::BasicBlock*, std::vector<const llvm::BasicBlock*> > wto_enclosing_heads_;
+
+    // The name of the function each of the WPDS stack symbols belongs to.
+    // Used by incremental analysis to find the transitions affected by an edit.
+    std::map<wali::Key, std::string> key_to_func_;
+
+    // Budget information, see DegradationLevel
+    long start_time_;
+    llvm::Function* crt_func_;
+    long crt_func_start_time_;
+    long crt_func_start_memory_;
+    abstract_domain::Vocabulary crt_func_essential_voc_;
+    std::map<std::string, DegradationLevel> degraded_funcs_;
+    std::map<std::string, DegradationLevel> call_chain_degraded_funcs_;
+
+    // The program points of each function where more disjuncts pay off, see GetDisjunctRelevantKeys
+    std::map<std::string, std::set<wali::Key> > func_disjunct_relevant_keys_;
+
+    // Slicing information, see ComputeSlice
+    std::set<const llvm::BasicBlock*> sliced_bbs_;
+    std::map<const llvm::Function*, abstract_domain::Vocabulary> sliced_voc_;
+    SliceStats slice_stats_;
+
+    // Number of keys removed by CompressRuleChains
+    unsigned num_compressed_keys_;
+
+    // Number of dimensions found to never wrap, see ComputeNoWrapInformation
+    unsigned num_no_wrap_dims_;
+
+    // The distinct abstract values of the rule weights built so far, by their structural hash, see HashConsWeightValue
+    std::map<size_t, std::vector<ref_ptr<abstract_domain::BitpreciseWrappedAbstractValue> > > weight_values_;
+    unsigned num_shared_weight_values_;
+
   public:
     // av is used to create initial state
     explicit WrappedDomainWPDSCreator(std::unique_ptr<llvm::Module> M, ref_ptr<abstract_domain::AbstractValue> av, std::string& bcprinting_filename, bool add_array_bounds_check);
@@ -54,6 +122,90 @@ namespace llvm_abstract_transformer {
 
     wali::wpds::WPDS* createWPDS(bool is_fwpds);
     wali::wfa::WFA* BuildAutomaton(bool is_backward, std::ostream * os);
+
+    // Incremental analysis support
+    //
+    // A fingerprint of a function is a hash of its IR after the reg2mem/mem2reg passes of createWPDS.
+    // SaveFixpoint writes the fingerprints and the post* automaton fa to fixpoint_filename.
+    // SeedAutomatonFromFixpoint reads such a file and adds to fa every saved transition whose
+    // stack symbol belongs to a function that is not affected by a changed fingerprint, i.e. not connected
+    // to a changed function by direct calls (see GetAffectedFunctions). It returns the number of
+    // transitions added. config identifies the domain and options; a file with a different config is ignored.
+    // The stream versions are used for checkpoints: with keep_all, every saved transition (including the
+    // epsilon transitions of a partial post*) is added, provided that no function changed.
+    std::map<std::string, std::string> GetFunctionFingerprints();
+    void SaveFixpoint(const wali::wfa::WFA& fa, const std::string& config, const std::string& fixpoint_filename);
+    void SaveFixpoint(std::ostream& out, const wali::wfa::WFA& fa, const std::string& config);
+    unsigned SeedAutomatonFromFixpoint(wali::wfa::WFA* fa, const std::string& config, const std::string& fixpoint_filename);
+    unsigned SeedAutomatonFromFixpoint(std::istream& in, wali::wfa::WFA* fa, const std::string& config, bool keep_all);
+    std::set<std::string> GetAffectedFunctions(const std::set<std::string>& changed_funcs);
+
+    // Resource budgets
+    //
+    // The rules of a function whose construction takes longer than the per-function time budget, grows
+    // the memory by more than the per-function memory budget, or whose weights have more constraints
+    // than the constraint budget, are built at an increasing
+    // DegradationLevel. Once the global time or memory budget is exceeded, the rules of all the
+    // remaining functions are built at the highest level. GetDegradedFunctions reports the level
+    // reached by each degraded function.
+    bool GlobalBudgetExceeded() const;
+    std::map<std::string, DegradationLevel> GetDegradedFunctions() const;
+
+    // Tiered analysis support
+    //
+    // GetFunctionName returns the name of the function a WPDS key belongs to, or "" if unknown.
+    // DegradeOutsideCallChains sets the degradation level of the functions which neither contain one of
+    // funcs, nor transitively call one of them, nor are transitively called by one of them, so that precision
+    // is spent on the call chains leading to funcs. It must be called before createWPDS.
+    // GetCallChainDegradedFunctions reports these functions apart from the ones of GetDegradedFunctions,
+    // which only holds the functions degraded further by the budgets.
+    std::string GetFunctionName(wali::Key key) const;
+    void DegradeOutsideCallChains(const std::set<std::string>& funcs, DegradationLevel level);
+    std::map<std::string, DegradationLevel> GetCallChainDegradedFunctions() const;
+
+    // Adaptive disjunct limits
+    //
+    // The disjunct relevant points of a function are its loop heads and latches, and the points of the
+    // blocks containing an assertion and of their predecessors. GetDisjunctRelevantKeys returns these points
+    // for all the functions, or only for the functions containing one of the given unreachable keys.
+    std::set<wali::Key> GetDisjunctRelevantKeys() const;
+    std::set<wali::Key> GetDisjunctRelevantKeys(const std::set<wali::Key>& unreachable_keys) const;
+
+    // Demand-driven slicing
+    //
+    // With cmdlineparam_slice, createWPDS first computes a backward slice from the assertions (and the array
+    // bounds checks). The blocks from which no assertion can be reached, either directly, through a call, or
+    // by returning to a caller, get no rules; so a function that cannot lead to an assertion gets no rules at all.
+    // The dimensions of the values that no assertion depends on (through data, memory, control and call
+    // dependences) are projected out of the weights, which only loses constraints on them.
+    SliceStats GetSliceStats() const;
+
+    // Rule chain compression
+    //
+    // With cmdlineparam_compress_chains, createWPDS finally fuses the straight-line chains of delta1 rules
+    // into single rules, so that post* does not extend through their intermediate keys one at a time.
+    // Only the keys in the middle of a chain are removed, see CompressRuleChains.
+    unsigned GetNumCompressedKeys() const;
+
+    // Interval pre-analysis
+    //
+    // With cmdlineparam_interval_preanalysis, createWPDS runs IntervalPreAnalysis on every function before
+    // creating its rules. Wrapping the dimensions and values it proves in range only adds bounding constraints,
+    // which keeps loop counters from splitting the disjuncts.
+    unsigned GetNumNoWrapDims() const;
+
+    // Bottom-up summaries
+    //
+    // GetCallGraphSCCs returns the SCCs of the call graph in bottom-up order (callees first).
+    // BuildSummaryAutomaton returns a query automaton whose initial transitions are the ones post* adds for
+    // a call to one of funcs: they read the entry of the function and lead to the state generated for the call.
+    // Thus, the transitions saturated from it are the summaries post* computes for the calls to funcs.
+    // SaveSummary writes, in the format of SaveFixpoint, the transitions of fa which belong to funcs: the ones
+    // reading their stack symbols, and the ones leading to the states generated for the calls to them.
+    std::vector<CallGraphSCC> GetCallGraphSCCs();
+    wali::wfa::WFA* BuildSummaryAutomaton(const std::vector<llvm::Function*>& funcs);
+    void SaveSummary(std::ostream& out, const wali::wfa::WFA& fa, const std::string& config, const std::vector<llvm::Function*>& funcs);
+
     void performReg2Mem();
     void performMem2Reg();
 
@@ -68,10 +220,13 @@ namespace llvm_abstract_transformer {
     //wali::Key mk_wpds_key(llvm::BasicBlock* bb);
     wali::Key mk_wpds_key(llvm::BasicBlock::iterator start, llvm::BasicBlock* bb, llvm::Function* f);
     wali::Key mk_unique_wpds_key(llvm::BasicBlock* bb);
+    // The key of the rules leaving bb, ie. the key of its first non-phi instruction
+    wali::Key mk_bb_entry_key(llvm::BasicBlock* bb);
     wali::Key mk_wpds_unreachable_key(const llvm::CallSite& CS);
     wali::Key mk_exit_wpds_key(llvm::Function* bb);
     wali::Key mk_exit_wpds_dummy_key(llvm::Function* bb, llvm::CallInst* ci);
-    bool is_llvm_backedge(const llvm::BasicBlock* bb, const llvm::BasicBlock* succ);
+    void ComputeWto(llvm::Function* f);
+    bool is_wto_backedge(const llvm::BasicBlock* bb, const llvm::BasicBlock* succ);
 
     // Helper functions needed to build the starting automaton for poststar
     ref_ptr<AvSemiring> GetStartingState(const abstract_domain::Vocabulary& v, llvm::Function& F);
@@ -80,6 +235,16 @@ namespace llvm_abstract_transformer {
                                                 llvm::CallInst*& ci) const;
 
     void UpdateMinMaxVocabularySize(size_t voc_size);
+    abstract_domain::Vocabulary GetEssentialVocabulary(llvm::Function* f, LiveVariableAnalysis* lva);
+    void EnforceBudget(ref_ptr<abstract_domain::BitpreciseWrappedAbstractValue>& state);
+    ref_ptr<abstract_domain::BitpreciseWrappedAbstractValue> HashConsWeightValue(const ref_ptr<abstract_domain::BitpreciseWrappedAbstractValue>& av);
+    void CollectDisjunctRelevantKeys(llvm::Function* f);
+    void ComputeNoWrapInformation(LiveVariableAnalysis* lva);
+    void ComputeNoWrapInformation(LiveVariableAnalysis* lva, bool is_signed, abstract_domain::Vocabulary& no_wrap_voc, std::set<const llvm::Value*>& wrap_free_values);
+    void ComputeInferredSignedness(LiveVariableAnalysis* lva);
+    void ComputeSlice(LiveVariableAnalysis* lva);
+    abstract_domain::Vocabulary SliceVocabulary(const abstract_domain::Vocabulary& voc) const;
+    void CompressRuleChains();
     void AddRuleToPds(ref_ptr<abstract_domain::AbstractValue> state, wali::Key from_key, wali::Key to_key, WideningType wty, abstract_domain::Vocabulary& voc);
     void AddDelta2RuleToPds(ref_ptr<abstract_domain::AbstractValue> state, wali::Key from_key, wali::Key callee_entry_key, wali::Key to_key, WideningType wty, abstract_domain::Vocabulary& voc, wali::IMergeFn* cf);
     void AddDelta0RuleToPds(ref_ptr<abstract_domain::AbstractValue> state, wali::Key from_key, WideningType wty, abstract_domain::Vocabulary& voc);
@@ -14,17 +14,23 @@ DimensionKey GetTempKey(utils::Bitsize bitsize, unsigned num) {
 WrappedDomain_Int::WrappedDomain_Int
 (utils::Bitsize bitsize, 
  const wali::ref_ptr<AbstractValue>& av) 
-  : k_(GetTempKey(bitsize, 0)), wrapped_(false), wrapped_is_signed_(true) {
+  : k_(GetTempKey(bitsize, 0)), wrapped_(false), wrapped_is_signed_(true), is_const_(false), const_pending_(false) {
   wali::ref_ptr<AbstractValue> av_cp = av->Copy();
   av_cp->AddDimension(k_);
   wav_ = new BitpreciseWrappedAbstractValue(av_cp, VocabularySignedness()); // Do not wrap anything
 }
 
-WrappedDomain_Int::WrappedDomain_Int(wali::ref_ptr<BitpreciseWrappedAbstractValue> wav, DimensionKey k) : k_(k), wrapped_(false), wrapped_is_signed_(true), wav_(wav) {
+WrappedDomain_Int::WrappedDomain_Int(wali::ref_ptr<BitpreciseWrappedAbstractValue> wav, DimensionKey k) : k_(k), wrapped_(false), wrapped_is_signed_(true), is_const_(false), const_pending_(false), wav_(wav) {
 }
 
-WrappedDomain_Int::WrappedDomain_Int(const WrappedDomain_Int& that) : k_(that.k_), wrapped_(that.wrapped_), wrapped_is_signed_(that.wrapped_is_signed_)  {
-  this->wav_ = new BitpreciseWrappedAbstractValue(*(that.wav_));
+WrappedDomain_Int::WrappedDomain_Int(const WrappedDomain_Int& that) 
+  : k_(that.k_), wrapped_(that.wrapped_), wrapped_is_signed_(that.wrapped_is_signed_), 
+    is_const_(that.is_const_), const_pending_(that.const_pending_), const_val_(that.const_val_)  {
+  // A pending constant is copied when its constraint is added
+  if(const_pending_)
+    this->wav_ = that.wav_;
+  else
+    this->wav_ = new BitpreciseWrappedAbstractValue(*(that.wav_));
 }
 
 WrappedDomain_Int::~WrappedDomain_Int() {
@@ -32,14 +38,21 @@ WrappedDomain_Int::~WrappedDomain_Int() {
 
 WrappedDomain_Int& WrappedDomain_Int::operator=(const WrappedDomain_Int& that) {
   if(this != &that) {
-    this->wav_ = new BitpreciseWrappedAbstractValue(*(that.wav_));
+    if(that.const_pending_)
+      this->wav_ = that.wav_;
+    else
+      this->wav_ = new BitpreciseWrappedAbstractValue(*(that.wav_));
     this->k_ = that.k_;
     this->wrapped_ = that.wrapped_;
     this->wrapped_is_signed_ = that.wrapped_is_signed_;
+    this->is_const_ = that.is_const_;
+    this->const_pending_ = that.const_pending_;
+    this->const_val_ = that.const_val_;
   }
   return *this;
 }
 
+// top and bottom do not depend on the constraints, so they do not add the constraint of a pending constant
 WrappedDomain_Int WrappedDomain_Int::top() const {
   wali::ref_ptr<AbstractValue> tp = wav_->Top();
   wali::ref_ptr<BitpreciseWrappedAbstractValue> tp_bpwav = dynamic_cast<BitpreciseWrappedAbstractValue*>(tp.get_ptr());
@@ -52,18 +65,49 @@ WrappedDomain_Int WrappedDomain_Int::bottom() const {
   return WrappedDomain_Int(btm_bpwav, k_);
 }
 
+// The constraint k_ = c is only added by wav(), so that the constants which are only used through is_constant,
+// or folded by the numeric operations, never touch the abstract value
 WrappedDomain_Int WrappedDomain_Int::of_const(mpz_class c) const {
   WrappedDomain_Int tmp_top = top();
+  tmp_top.is_const_ = true;
+  tmp_top.const_pending_ = true;
+  tmp_top.const_val_ = c;
+  return tmp_top;
+}
 
-  // Add constraint 1*k_ = c
-  AbstractValue::linexp_type const_constr_linexp_lhs;
-  const_constr_linexp_lhs.insert(AbstractValue::linexp_type::value_type(tmp_top.k_, 1));
-  AbstractValue::affexp_type const_constr_lhs(const_constr_linexp_lhs, 0);
-  AbstractValue::affexp_type const_constr_rhs(AbstractValue::linexp_type(), c);
-  tmp_top.wav_->AddConstraint(const_constr_lhs, const_constr_rhs, AbstractValue::EQ);
+WrappedDomain_Int WrappedDomain_Int::of_const(mpz_class c, utils::Bitsize b) const {
+  DimensionKey k_b = GetTempKey(b, 0);
+  WrappedDomain_Int tmp_top = top();
+  if(k_b != k_) {
+    tmp_top.wav_->AddDimension(k_b);
+    tmp_top.wav_->RemoveDimension(k_);
+    tmp_top.k_ = k_b;
+  }
+  tmp_top.is_const_ = true;
+  tmp_top.const_pending_ = true;
+  tmp_top.const_val_ = c;
   return tmp_top;
 }
 
+const wali::ref_ptr<BitpreciseWrappedAbstractValue>& WrappedDomain_Int::wav() const {
+  if(const_pending_) {
+    const_pending_ = false;
+    wav_ = new BitpreciseWrappedAbstractValue(*wav_);
+
+    // Add constraint 1*k_ = c
+    AbstractValue::linexp_type const_constr_linexp_lhs;
+    const_constr_linexp_lhs.insert(AbstractValue::linexp_type::value_type(k_, 1));
+    AbstractValue::affexp_type const_constr_lhs(const_constr_linexp_lhs, 0);
+    AbstractValue::affexp_type const_constr_rhs(AbstractValue::linexp_type(), const_val_);
+    wav_->AddConstraint(const_constr_lhs, const_constr_rhs, AbstractValue::EQ);
+
+    // Keep the signedness of a constant folded by wrap
+    if(wrapped_)
+      wav_->wrapped_voc_[k_] = wrapped_is_signed_;
+  }
+  return wav_;
+}
+
 WrappedDomain_Int WrappedDomain_Int::of_relation(const wali::ref_ptr<BitpreciseWrappedAbstractValue>& state, utils::Bitsize bitsize) {
   DimensionKey k = GetTempKey(bitsize, 0);
   wali::ref_ptr<BitpreciseWrappedAbstractValue> state_with_k = new BitpreciseWrappedAbstractValue(*state);
@@ -120,12 +164,12 @@ WrappedDomain_Int WrappedDomain_Int::of_variable(const wali::ref_ptr<BitpreciseW
 }
 
 Vocabulary WrappedDomain_Int::GetVocabulary() const {
-  return wav_->GetVocabulary();
+  return wav()->GetVocabulary();
 }
 
 // assign_to: Return the abstract value with k_ projected out
 wali::ref_ptr<BitpreciseWrappedAbstractValue> WrappedDomain_Int::get_one_voc_relation() const {
-  wali::ref_ptr<BitpreciseWrappedAbstractValue> ret = new BitpreciseWrappedAbstractValue(*wav_);
+  wali::ref_ptr<BitpreciseWrappedAbstractValue> ret = new BitpreciseWrappedAbstractValue(*wav());
   ret->RemoveDimension(k_);
   return ret;
 }
@@ -133,7 +177,7 @@ wali::ref_ptr<BitpreciseWrappedAbstractValue> WrappedDomain_Int::get_one_voc_rel
 // assign_to: Return the abstract value with var assigned as "var := this".
 // This function is the key operation in implementing variable updates
 wali::ref_ptr<BitpreciseWrappedAbstractValue> WrappedDomain_Int::assign_to_one_voc(DimensionKey var) const {
-  wali::ref_ptr<BitpreciseWrappedAbstractValue> ret = new BitpreciseWrappedAbstractValue(*wav_);
+  wali::ref_ptr<BitpreciseWrappedAbstractValue> ret = new BitpreciseWrappedAbstractValue(*wav());
   Vocabulary voc_var; voc_var.insert(var);
   ret = dynamic_cast<BitpreciseWrappedAbstractValue*>(ret->Havoc(voc_var).get_ptr());
 
@@ -156,7 +200,7 @@ wali::ref_ptr<BitpreciseWrappedAbstractValue> WrappedDomain_Int::assign_to_one_v
 }
 
 wali::ref_ptr<BitpreciseWrappedAbstractValue> WrappedDomain_Int::assign_to_two_voc(DimensionKey var, const Vocabulary& target_voc) const {
-  wali::ref_ptr<BitpreciseWrappedAbstractValue> ret = new BitpreciseWrappedAbstractValue(*wav_);
+  wali::ref_ptr<BitpreciseWrappedAbstractValue> ret = new BitpreciseWrappedAbstractValue(*wav());
   ret->AddVocabulary(target_voc);
 
   Vocabulary voc_var; voc_var.insert(var);
@@ -184,46 +228,77 @@ wali::ref_ptr<BitpreciseWrappedAbstractValue> WrappedDomain_Int::assign_to_two_v
 // Relational Operations
 // =====================
 void WrappedDomain_Int::join(const WrappedDomain_Int& that) {
-  wav_->Join(that.wav_);
+  wav()->Join(that.wav());
+  is_const_ = false;
 }
 
 void WrappedDomain_Int::widen(const WrappedDomain_Int& that) {
-  wav_->Widen(that.wav_);
+  wav()->Widen(that.wav());
+  is_const_ = false;
 }
 
 void WrappedDomain_Int::meet(const WrappedDomain_Int& that) {
-  wav_->Meet(that.wav_);
+  wav()->Meet(that.wav());
+  is_const_ = false;
 }
 
 void WrappedDomain_Int::wrap(bool is_signed) {
   if(wrapped_ && wrapped_is_signed_ == is_signed)
     return;
 
+  // Fold the wrap of a pending constant, wav() marks k_ as wrapped when it adds the constraint
+  if(const_pending_) {
+    const_val_ = utils::convert_to_mpz(utils::convert_to_value(const_val_, k_.GetBitsize(), is_signed), is_signed);
+    wrapped_ = true;
+    wrapped_is_signed_ = is_signed;
+    return;
+  }
+
   DEBUG_PRINTING(DBG_PRINT_EVERYTHING,
                  print(std::cout << "\nCalling wrap on:"););
 
   // Add bounding constraints to the vocabulary which k_ depends on.
   // Use is_signed as the signedness of their bounding
-  Vocabulary v = wav_->GetDependentVocabulary(k_);
+  Vocabulary v = wav()->GetDependentVocabulary(k_);
   BitpreciseWrappedAbstractValue::VocabularySignedness v_sign;
   for(Vocabulary::const_iterator it = v.begin(); it != v.end(); it++) {
     v_sign.insert(std::make_pair(*it, is_signed));
   }
-  wav_->AddBoundingConstraints(v_sign);
+  wav()->AddBoundingConstraints(v_sign);
   DEBUG_PRINTING(DBG_PRINT_EVERYTHING,
                  abstract_domain::print(std::cout << "\ndependent_voc:", v);
                  print(std::cout << "\nAfter adding bounding cnstrs:"););
 
-  wav_->Wrap(k_, is_signed);
+  wav()->Wrap(k_, is_signed);
   wrapped_ = true;
   wrapped_is_signed_ = is_signed;
+  is_const_ = false;
   DEBUG_PRINTING(DBG_PRINT_EVERYTHING,
                  print(std::cout << "\nAfter wrap:"););
 }
 
+// Used instead of wrap when k_ is known to be in the range of is_signed (see IntervalPreAnalysis), so that
+// wrapping k_ cannot split the disjuncts
+void WrappedDomain_Int::assume_wrapped(bool is_signed) {
+  if(wrapped_ && wrapped_is_signed_ == is_signed)
+    return;
+
+  Vocabulary v = wav()->GetDependentVocabulary(k_);
+  v.insert(k_);
+  BitpreciseWrappedAbstractValue::VocabularySignedness v_sign;
+  for(Vocabulary::const_iterator it = v.begin(); it != v.end(); it++) {
+    v_sign.insert(std::make_pair(*it, is_signed));
+  }
+  wav()->AddBoundingConstraints(v_sign);
+  wrapped_ = true;
+  wrapped_is_signed_ = is_signed;
+  DEBUG_PRINTING(DBG_PRINT_EVERYTHING,
+                 print(std::cout << "\nAfter assume_wrapped:"););
+}
+
 // is_equal tests for *relational equality*
 bool WrappedDomain_Int::is_equal(const WrappedDomain_Int& that) const {
-  return (*wav_ == *that.wav_);
+  return (*wav() == *that.wav());
 }
 
 bool WrappedDomain_Int::operator==(const WrappedDomain_Int& that) const {
@@ -257,8 +332,16 @@ TVL_BOOL WrappedDomain_Int::is_value_equal(const WrappedDomain_Int & that) const
     }
   }
   else {
-    wali::ref_ptr<AbstractValue> m = wav_->Copy();
-    m->Meet(that.wav_.get_ptr());
+    // Values with disjoint bounds are never equal, this is found without the meet
+    AbstractValue::DimensionInterval this_itv, that_itv;
+    if(wav()->GetInterval(k_, this_itv) && that.wav()->GetInterval(that.k_, that_itv)) {
+      if((this_itv.has_ub && that_itv.has_lb && this_itv.ub < that_itv.lb) ||
+         (that_itv.has_ub && this_itv.has_lb && that_itv.ub < this_itv.lb))
+        return TVL_BOOL::ZERO;
+    }
+
+    wali::ref_ptr<AbstractValue> m = wav()->Copy();
+    m->Meet(that.wav().get_ptr());
     if(m->IsBottom()) {
       return TVL_BOOL::ZERO;
     }
@@ -268,37 +351,38 @@ TVL_BOOL WrappedDomain_Int::is_value_equal(const WrappedDomain_Int & that) const
 
 
 bool WrappedDomain_Int::is_subset(const WrappedDomain_Int & that) const {
-  return that.wav_->Overapproximates(wav_.get_ptr());
+  return that.wav()->Overapproximates(wav().get_ptr());
 }
 
 
 bool WrappedDomain_Int::is_bottom() const {
-  return wav_->IsBottom();
+  return wav()->IsBottom();
 }
 
 bool WrappedDomain_Int::is_top() const {
-  return wav_->IsTop();
+  return wav()->IsTop();
 }
 
 // True if this value has exactly one concretization.
 // Return the constant value in val if true.
 bool WrappedDomain_Int::is_constant(mpz_class& val) const {
-  if(wav_->IsBottom())
-    return false;
-
-  wali::ref_ptr<BitpreciseWrappedAbstractValue> avcopy = new BitpreciseWrappedAbstractValue(*wav_);
+  if(is_const_) {
+    val = const_val_;
+    return true;
+  }
 
-  // Project on only k
-  Vocabulary voc_k; voc_k.insert(k_);
-  avcopy->Project(voc_k);
+  // The bounds of k_ are cached in wav(), so that the queries on the same state do not project it again
+  AbstractValue::DimensionInterval itv;
+  if(!wav()->GetInterval(k_, itv))
+    return false;
 
-  return avcopy->IsConstant(val);
+  return itv.IsConstant(val);
 }
 
 // Return this having havocing k_ in av_
 WrappedDomain_Int WrappedDomain_Int::any_value() const {
   Vocabulary voc_k; voc_k.insert(k_);
-  wali::ref_ptr<BitpreciseWrappedAbstractValue> any_val_av = dynamic_cast<BitpreciseWrappedAbstractValue*>(wav_->Havoc(voc_k).get_ptr());
+  wali::ref_ptr<BitpreciseWrappedAbstractValue> any_val_av = dynamic_cast<BitpreciseWrappedAbstractValue*>(wav()->Havoc(voc_k).get_ptr());
  
   return WrappedDomain_Int(any_val_av, k_);
 }
@@ -309,11 +393,13 @@ DimensionKey WrappedDomain_Int::GetIntKey() const {
 }
 
 void WrappedDomain_Int::AddConstraint(const AbstractValue::affexp_type& ae, AbstractValue::OpType op) {
-  wav_->AddConstraintNorhs(ae, op);
+  wav()->AddConstraintNorhs(ae, op);
+  is_const_ = false;
 }
 
 void WrappedDomain_Int::AddConstraint(const AbstractValue::affexp_type& lhs, const AbstractValue::affexp_type& rhs, AbstractValue::OpType op) {
-  wav_->AddConstraint(lhs, rhs, op);
+  wav()->AddConstraint(lhs, rhs, op);
+  is_const_ = false;
 }
 
 #define MPZ_MINUS_ONE mpz_class(-1)
@@ -335,6 +421,8 @@ WrappedDomain_Int WrappedDomain_Int::plus(const WrappedDomain_Int& that) const {
 }
 
 WrappedDomain_Int WrappedDomain_Int::plus(const mpz_class& that) const {
+  if(is_const_)
+    return of_const(const_val_ + that);
   return lin_transform(MPZ_MINUS_ONE, MPZ_ONE, that);
 }
 
@@ -349,10 +437,14 @@ WrappedDomain_Int WrappedDomain_Int::minus(const WrappedDomain_Int& that) const
 }
 
 WrappedDomain_Int WrappedDomain_Int::negate() const {
+  if(is_const_)
+    return of_const(-const_val_);
   return lin_transform(MPZ_ONE, MPZ_ONE, MPZ_ZERO);
 }
 
 WrappedDomain_Int WrappedDomain_Int::minus(const mpz_class& that) const {
+  if(is_const_)
+    return of_const(const_val_ - that);
   return lin_transform(MPZ_MINUS_ONE, MPZ_ONE, MPZ_ZERO - that);
 }
 
@@ -440,16 +532,16 @@ WrappedDomain_Int WrappedDomain_Int::div_helper(const mpz_class& that_mpz, bool
   
   // Create old_k
   DimensionKey old_k = GetTempKey(b, 1);
-  ret.wav_->AddDimension(old_k);
+  ret.wav()->AddDimension(old_k);
 
   // Add assertion old_k <= that*k_ <= old_k + (that - 1)
   // The above inequality essentially assert that the integer division gives a floor value
   // of the actual rational which was obtained after divide
 
   // Add equality k_=old_k and then havoc k_, so that essentially the key k_ is replaced with old_k
-  ret.wav_->AddEquality(k_, old_k);
+  ret.wav()->AddEquality(k_, old_k);
   Vocabulary voc_k; voc_k.insert(k_);
-  ret.wav_ = dynamic_cast<BitpreciseWrappedAbstractValue*>(ret.wav_->Havoc(voc_k).get_ptr());
+  ret.wav_ = dynamic_cast<BitpreciseWrappedAbstractValue*>(ret.wav()->Havoc(voc_k).get_ptr());
 
   // Add constraint old_k <= that*k_
   AbstractValue::linexp_type le_lhs2, le_rhs2;
@@ -457,7 +549,6 @@ WrappedDomain_Int WrappedDomain_Int::div_helper(const mpz_class& that_mpz, bool
   le_rhs2.insert(std::make_pair(k_, that));
   AbstractValue::affexp_type ae_lhs2(le_lhs2, MPZ_ZERO);
   AbstractValue::affexp_type ae_rhs2(le_rhs2, MPZ_ZERO);
-  ret.wav_->AddConstraint(ae_lhs2, ae_rhs2, AbstractValue::LE);
 
   // Add constraint that*new_k <= old_k + (that - 1)
   AbstractValue::linexp_type le_lhs3, le_rhs3;
@@ -465,13 +556,18 @@ WrappedDomain_Int WrappedDomain_Int::div_helper(const mpz_class& that_mpz, bool
   le_rhs3.insert(std::make_pair(old_k, MPZ_ONE));
   AbstractValue::affexp_type ae_lhs3(le_lhs3, MPZ_ZERO);
   AbstractValue::affexp_type ae_rhs3(le_rhs3, that - MPZ_ONE);
-  ret.wav_->AddConstraint(ae_lhs3, ae_rhs3, AbstractValue::LE);
+
+  // Add both the constraints at once, so that they are reduced once
+  std::vector<AbstractValue::constraint_type> cs;
+  cs.push_back(AbstractValue::constraint_type(std::make_pair(ae_lhs2, ae_rhs2), AbstractValue::LE));
+  cs.push_back(AbstractValue::constraint_type(std::make_pair(ae_lhs3, ae_rhs3), AbstractValue::LE));
+  ret.wav()->AddConstraints(cs);
 
   // Mark k_ as wrapped
-  ret.wav_->MarkWrapped(k_, is_signed);
+  ret.wav()->MarkWrapped(k_, is_signed);
 
   // Project away old_k
-  ret.wav_->RemoveDimension(old_k);
+  ret.wav()->RemoveDimension(old_k);
   return ret;
 }
 
@@ -536,33 +632,37 @@ WrappedDomain_Int WrappedDomain_Int::mod_helper(const mpz_class& that_mpz, bool
 
   // Create old_k
   DimensionKey old_k = GetTempKey(b, 1);
-  ret.wav_->AddDimension(old_k);
+  ret.wav()->AddDimension(old_k);
 
   // Add assertion 0 <= k_ <= that - 1
 
   // Add equality k_ = old_k and then havoc k_, so that essentially the key k_ is replaced with old_k
-  ret.wav_->AddEquality(k_, old_k);
+  ret.wav()->AddEquality(k_, old_k);
   Vocabulary voc_k; voc_k.insert(k_);
-  ret.wav_ = dynamic_cast<BitpreciseWrappedAbstractValue*>(ret.wav_->Havoc(voc_k).get_ptr());
+  ret.wav_ = dynamic_cast<BitpreciseWrappedAbstractValue*>(ret.wav()->Havoc(voc_k).get_ptr());
 
   // Add constraint k_ >= 0
   AbstractValue::linexp_type le_lhs2;
   le_lhs2.insert(std::make_pair(k_, MPZ_ONE));
   AbstractValue::affexp_type ae_lhs2(le_lhs2, MPZ_ZERO);
-  ret.wav_->AddConstraintNorhs(ae_lhs2, AbstractValue::GE);
 
   // Add constraint k_ <= that - 1
   AbstractValue::linexp_type le_lhs3, le_rhs3;
   le_lhs3.insert(std::make_pair(k_, MPZ_ONE));
   AbstractValue::affexp_type ae_lhs3(le_lhs3, MPZ_ZERO);
   AbstractValue::affexp_type ae_rhs3(le_rhs3, that - MPZ_ONE);
-  ret.wav_->AddConstraint(ae_lhs3, ae_rhs3, AbstractValue::LE);
+
+  // Add both the constraints at once, so that they are reduced once
+  std::vector<AbstractValue::constraint_type> cs;
+  cs.push_back(AbstractValue::constraint_type(std::make_pair(ae_lhs2, AbstractValue::affexp_type(AbstractValue::linexp_type(), MPZ_ZERO)), AbstractValue::GE));
+  cs.push_back(AbstractValue::constraint_type(std::make_pair(ae_lhs3, ae_rhs3), AbstractValue::LE));
+  ret.wav()->AddConstraints(cs);
 
   // Mark k_ as wrapped
-  ret.wav_->MarkWrapped(k_, is_signed);
+  ret.wav()->MarkWrapped(k_, is_signed);
 
   // Project away old_k
-  ret.wav_->RemoveDimension(old_k);
+  ret.wav()->RemoveDimension(old_k);
   return ret;
 }
 
@@ -609,6 +709,8 @@ WrappedDomain_Int WrappedDomain_Int::rshift_arith(const WrappedDomain_Int& that)
       utils::Value this_val = utils::convert_to_value(c, b, true/*is_signed*/);
       mpz_class this_mpz_trunc = utils::convert_to_mpz(this_val, true/*is_signed*/);
       mpz_class rshift_result = utils::mpz_rshift_arith(this_mpz_trunc, that_mpz);
+      if(is_const_ && that.is_const_)
+        return of_const(rshift_result);
 
       WrappedDomain_Int ret = any_value();
       ret.meet(that.any_value());
@@ -626,15 +728,19 @@ WrappedDomain_Int WrappedDomain_Int::rshift_arith(const WrappedDomain_Int& that)
 
 WrappedDomain_Int WrappedDomain_Int::bitwise_and(const WrappedDomain_Int& that) const {
   utils::Bitsize b = k_.GetBitsize();
-  WrappedDomain_Int ret = any_value();
-  ret.meet(that.any_value());
-
   mpz_class this_c, that_c;
   bool is_this_cons = is_constant(this_c);
   bool is_that_cons = that.is_constant(that_c);
   mpz_class this_c_trunc = utils::convert_to_mpz(utils::convert_to_value(this_c, b, false/*is_signed*/), false/*is_signed*/);
   mpz_class that_c_trunc = utils::convert_to_mpz(utils::convert_to_value(that_c, b, false/*is_signed*/), false/*is_signed*/);
 
+  // Fold two constants, without touching their abstract values
+  if(is_const_ && that.is_const_)
+    return of_const(utils::mpz_and(this_c_trunc, that_c_trunc));
+
+  WrappedDomain_Int ret = any_value();
+  ret.meet(that.any_value());
+
   // TODO: More precision can be obtained if and was done with a non-zero constant with trailing zero bits
   // If that happens then a better lower bound on the other non-constant value can be obtained.
   // Note that this only makes sense when the values are treated as unsigned, which we currently cannot handle.
@@ -659,15 +765,19 @@ WrappedDomain_Int WrappedDomain_Int::bitwise_and(const WrappedDomain_Int& that)
 
 WrappedDomain_Int WrappedDomain_Int::bitwise_or(const WrappedDomain_Int& that) const {
   utils::Bitsize b = k_.GetBitsize();
-  WrappedDomain_Int ret = any_value();
-  ret.meet(that.any_value());
-
   mpz_class this_c, that_c;
   bool is_this_cons = is_constant(this_c);
   bool is_that_cons = that.is_constant(that_c);
   mpz_class this_c_trunc = utils::convert_to_mpz(utils::convert_to_value(this_c, b, false/*is_signed*/), false/*is_signed*/);
   mpz_class that_c_trunc = utils::convert_to_mpz(utils::convert_to_value(that_c, b, false/*is_signed*/), false/*is_signed*/);
 
+  // Fold two constants, without touching their abstract values
+  if(is_const_ && that.is_const_)
+    return of_const(utils::mpz_or(this_c_trunc, that_c_trunc));
+
+  WrappedDomain_Int ret = any_value();
+  ret.meet(that.any_value());
+
   // TODO: More precision can be obtained if or was done with a non-zero constant with leading one bits
   // If that happens then a better lower bound on the other non-constant value can be obtained
   // Note that this only makes sense when the values are treated as unsigned, which we currently cannot handle.
@@ -693,15 +803,19 @@ WrappedDomain_Int WrappedDomain_Int::bitwise_or(const WrappedDomain_Int& that) c
 
 WrappedDomain_Int WrappedDomain_Int::bitwise_xor(const WrappedDomain_Int& that) const {
   utils::Bitsize b = k_.GetBitsize();
-  WrappedDomain_Int ret = any_value();
-  ret.meet(that.any_value());
-
   mpz_class this_c, that_c;
   bool is_this_cons = is_constant(this_c);
   bool is_that_cons = that.is_constant(that_c);
   mpz_class this_c_trunc = utils::convert_to_mpz(utils::convert_to_value(this_c, b, true/*is_signed*/), true/*is_signed*/);
   mpz_class that_c_trunc = utils::convert_to_mpz(utils::convert_to_value(that_c, b, false/*is_signed*/), true/*is_signed*/);
 
+  // Fold two constants, without touching their abstract values
+  if(is_const_ && that.is_const_)
+    return of_const(utils::mpz_xor(this_c_trunc, that_c_trunc));
+
+  WrappedDomain_Int ret = any_value();
+  ret.meet(that.any_value());
+
   // Handle special constant cases (ie. when one of the operand is a constant with bits all 0 or all 1
   if(is_this_cons && this_c_trunc == MPZ_MINUS_ONE) {
     ret.meet(that.bitwise_not());
@@ -725,6 +839,9 @@ WrappedDomain_Int WrappedDomain_Int::bitwise_xor(const WrappedDomain_Int& that)
 }
 
 WrappedDomain_Int WrappedDomain_Int::bitwise_not() const {
+  if(is_const_)
+    return of_const(~const_val_);
+
   mpz_class c;
   if(is_constant(c)) { 
     WrappedDomain_Int ret = any_value();
@@ -743,25 +860,31 @@ WrappedDomain_Int WrappedDomain_Int::bitwise_not() const {
 }
 
 WrappedDomain_Int WrappedDomain_Int::zero_extend(utils::Bitsize b) const {
+  if(is_const_)
+    return of_const(utils::convert_to_mpz(utils::convert_to_value(const_val_, k_.GetBitsize(), false/*is_signed*/), false/*is_signed*/), b);
+
   // Wrapping (as unsigned) needs to be performed before zero extension can be done
   WrappedDomain_Int ret = *this;
   ret.wrap(false/*is_signed*/);
   DimensionKey k_b = GetTempKey(b, 0);
-  ret.wav_->AddDimension(k_b);
-  ret.wav_->AddEquality(k_, k_b);
-  ret.wav_->RemoveDimension(k_);
+  ret.wav()->AddDimension(k_b);
+  ret.wav()->AddEquality(k_, k_b);
+  ret.wav()->RemoveDimension(k_);
   ret.k_ = k_b;
   return ret;
 }
 
 WrappedDomain_Int WrappedDomain_Int::sign_extend(utils::Bitsize b) const {
+  if(is_const_)
+    return of_const(utils::convert_to_mpz(utils::convert_to_value(const_val_, k_.GetBitsize(), true/*is_signed*/), true/*is_signed*/), b);
+
   // Wrapping (as unsigned) needs to be performed before zero extension can be done
   WrappedDomain_Int ret = *this;
   ret.wrap(true/*is_signed*/);
   DimensionKey k_b = GetTempKey(b, 0);
-  ret.wav_->AddDimension(k_b);
-  ret.wav_->AddEquality(k_, k_b);
-  ret.wav_->RemoveDimension(k_);
+  ret.wav()->AddDimension(k_b);
+  ret.wav()->AddEquality(k_, k_b);
+  ret.wav()->RemoveDimension(k_);
   ret.k_ = k_b;
   return ret;
 }
@@ -773,28 +896,60 @@ WrappedDomain_Int WrappedDomain_Int::zero_extend_or_trunc(utils::Bitsize b) cons
 }
 
 WrappedDomain_Int WrappedDomain_Int::trunc(utils::Bitsize b) const {
+  if(is_const_)
+    return of_const(const_val_, b);
+
   WrappedDomain_Int ret = *this;
   DimensionKey k_b = GetTempKey(b, 0);
-  ret.wav_->AddDimension(k_b);
-  ret.wav_->AddEquality(k_, k_b);
-  ret.wav_->RemoveDimension(k_);
+  ret.wav()->AddDimension(k_b);
+  ret.wav()->AddEquality(k_, k_b);
+  ret.wav()->RemoveDimension(k_);
   ret.k_ = k_b;
   return ret;
 }
 
+/* preferred_signedness:
+ * Equality holds for both signed and unsigned wrapping. Pick the signedness this or that is already
+ * wrapped with, otherwise the majority signedness the vocabulary they depend on is wrapped with or inferred
+ * to have (see SignednessInference). This avoids rewrapping them with the other signedness later on.
+ * Signed is the default.
+ */
+bool WrappedDomain_Int::preferred_signedness(const WrappedDomain_Int & that) const {
+  if(wrapped_)
+    return wrapped_is_signed_;
+  if(that.wrapped_)
+    return that.wrapped_is_signed_;
+
+  Vocabulary v = wav()->GetDependentVocabulary(k_);
+  Vocabulary that_v = that.wav()->GetDependentVocabulary(that.k_);
+  v.insert(that_v.begin(), that_v.end());
+  unsigned num_signed = 0, num_unsigned = 0;
+  for(Vocabulary::const_iterator it = v.begin(); it != v.end(); it++) {
+    bool is_signed;
+    if(wav()->IsWrapped(*it, is_signed) || that.wav()->IsWrapped(*it, is_signed) ||
+       BitpreciseWrappedAbstractValue::GetInferredSignedness(*it, is_signed)) {
+      if(is_signed)
+        num_signed++;
+      else
+        num_unsigned++;
+    }
+  }
+  return (num_unsigned <= num_signed);
+}
+
 wali::ref_ptr<BitpreciseWrappedAbstractValue> WrappedDomain_Int::abs_equal(const WrappedDomain_Int & that) const {
   // Calls to copy and wrap as wrap modifies the object (and loses precision), 
   // we want to keep this and that const and intact
-  // Need to wrap both operation to either signed or unsigned. We choose signed as a matter of convention
-  // TODO: Capture if either of this or that is wrapped and pick a sign according to that
-  WrappedDomain_Int this_wrapped = *this; this_wrapped.wrap(true/*is_signed*/);
-  WrappedDomain_Int that_wrapped = that; that_wrapped.wrap(true/*is_signed*/);
+  // Need to wrap both operation to either signed or unsigned, see preferred_signedness
+  bool is_signed = preferred_signedness(that);
+  WrappedDomain_Int this_wrapped = *this; this_wrapped.wrap(is_signed);
+  WrappedDomain_Int that_wrapped = that; that_wrapped.wrap(is_signed);
 
   // Essentially saying this_wrapped=that_wrapped as the key k_ in both this_wrapped and that_wrapped are equal
   this_wrapped.meet(that_wrapped);
 
-  this_wrapped.wav_->RemoveDimension(k_);
-  return this_wrapped.wav_;
+  this_wrapped.wav()->RemoveDimension(k_);
+  return this_wrapped.wav();
 }
 
 /* abs_not_equal:
@@ -814,30 +969,31 @@ wali::ref_ptr<BitpreciseWrappedAbstractValue> WrappedDomain_Int::abs_not_equal(c
   Vocabulary voc_k; voc_k.insert(k_);
 
   // 1. Wrap both this and that into this_wrapped and that_wrapped respectively.
-  // Need to wrap both operation to either signed or unsigned. We choose signed as a matter of convention
-  WrappedDomain_Int this_wrapped = *this; this_wrapped.wrap(true/*is_signed*/);
-  WrappedDomain_Int that_wrapped = that; that_wrapped.wrap(true/*is_signed*/);
+  // Need to wrap both operation to either signed or unsigned, see preferred_signedness
+  bool is_signed = preferred_signedness(that);
+  WrappedDomain_Int this_wrapped = *this; this_wrapped.wrap(is_signed);
+  WrappedDomain_Int that_wrapped = that; that_wrapped.wrap(is_signed);
  
   // 2. Change the key k_ in this_wrapped.av_ value to temp1 and add new key k_
 
   // Add constraint 1*k_ = 1*temp1 and then havoc k_, so that essentially the key k_ is replaced with temp1
-  this_wrapped.wav_->AddDimension(temp1);
+  this_wrapped.wav()->AddDimension(temp1);
 
   AbstractValue::linexp_type le_lhs1, le_rhs1;
   le_lhs1.insert(std::make_pair(k_, MPZ_ONE));
   le_rhs1.insert(std::make_pair(temp1, MPZ_ONE));
   AbstractValue::affexp_type ae_lhs1(le_lhs1, MPZ_ZERO);
   AbstractValue::affexp_type ae_rhs1(le_rhs1, MPZ_ZERO);
-  this_wrapped.wav_->AddConstraint(ae_lhs1, ae_rhs1, AbstractValue::EQ);
+  this_wrapped.wav()->AddConstraint(ae_lhs1, ae_rhs1, AbstractValue::EQ);
 
-  this_wrapped.wav_ = dynamic_cast<BitpreciseWrappedAbstractValue*>(this_wrapped.wav_->Havoc(voc_k).get_ptr());
+  this_wrapped.wav_ = dynamic_cast<BitpreciseWrappedAbstractValue*>(this_wrapped.wav()->Havoc(voc_k).get_ptr());
 
   // 3. Add the temp1 key to that_wrapped.av_
-  that_wrapped.wav_->AddDimension(temp1);
+  that_wrapped.wav()->AddDimension(temp1);
 
   // 4. Meet the two values in m1 and make a copy in m2
-  wali::ref_ptr<BitpreciseWrappedAbstractValue> m1 = this_wrapped.wav_;
-  m1->Meet(that_wrapped.wav_.get_ptr());
+  wali::ref_ptr<BitpreciseWrappedAbstractValue> m1 = this_wrapped.wav();
+  m1->Meet(that_wrapped.wav().get_ptr());
   wali::ref_ptr<BitpreciseWrappedAbstractValue> m2 = dynamic_cast<BitpreciseWrappedAbstractValue*>(m1->Copy().get_ptr());
 
   // 5. Add constraints (k_ >= temp1 + 1) in m1, and (k_ <= temp1 - 1) in m2
@@ -933,8 +1089,8 @@ wali::ref_ptr<BitpreciseWrappedAbstractValue> WrappedDomain_Int::less_than_or_eq
 }
 
 /* less_than_or_equal_no_wrapping:
- *  1. Change the key k_ in this->wav_ value to temp1 and add new key k_
- *  2. Add the temp1 key to that.wav_
+ *  1. Change the key k_ in this->wav() value to temp1 and add new key k_
+ *  2. Add the temp1 key to that.wav()
  *  3. Meet the two values in m
  *  4. Add constraint (temp1_ <= k_) in m 
  *  5. Project away k_ and temp1
@@ -950,24 +1106,24 @@ wali::ref_ptr<BitpreciseWrappedAbstractValue> WrappedDomain_Int::less_than_or_eq
 
   Vocabulary voc_k; voc_k.insert(k_);
 
-  // 1. Change the key k_ in this->wav_ value to temp1 and add new key k_
+  // 1. Change the key k_ in this->wav() value to temp1 and add new key k_
 
   // Add constraint 1*k_ = 1*temp1 and then havoc k_, so that essentially the key k_ is replaced with temp1
-  wav_->AddDimension(temp1); // No wrapping as k_ might not be wrapped
+  wav()->AddDimension(temp1); // No wrapping as k_ might not be wrapped
   AbstractValue::linexp_type le_lhs1, le_rhs1;
   le_lhs1.insert(std::make_pair(k_, MPZ_ONE));
   le_rhs1.insert(std::make_pair(temp1, MPZ_ONE));
   AbstractValue::affexp_type ae_lhs1(le_lhs1, MPZ_ZERO);
   AbstractValue::affexp_type ae_rhs1(le_rhs1, MPZ_ZERO);
-  wav_->AddConstraint(ae_lhs1, ae_rhs1, AbstractValue::EQ);
-  wav_ = dynamic_cast<BitpreciseWrappedAbstractValue*>(wav_->Havoc(voc_k).get_ptr());
+  wav()->AddConstraint(ae_lhs1, ae_rhs1, AbstractValue::EQ);
+  wav_ = dynamic_cast<BitpreciseWrappedAbstractValue*>(wav()->Havoc(voc_k).get_ptr());
 
-  // 2. Add the temp1 key to that.wav_
-  that.wav_->AddDimension(temp1);
+  // 2. Add the temp1 key to that.wav()
+  that.wav()->AddDimension(temp1);
 
   // 3. Meet the two values in m
-  wali::ref_ptr<BitpreciseWrappedAbstractValue> m = wav_; // No need to copy wav_ as this function is non-const
-  m->Meet(that.wav_.get_ptr());
+  wali::ref_ptr<BitpreciseWrappedAbstractValue> m = wav(); // No need to copy wav() as this function is non-const
+  m->Meet(that.wav().get_ptr());
 
   // 4. Add constraint (temp1_ <= k_) in m
   AbstractValue::linexp_type le1;
@@ -1032,7 +1188,7 @@ WrappedDomain_Int WrappedDomain_Int::lin_combine (const WrappedDomain_Int& that,
 
   // 1. Change the key k_ in left value to temp1 and add new keys k_ and temp2
   // Create a copy of this_av as we will be modifying it
-  wali::ref_ptr<BitpreciseWrappedAbstractValue> this_av = dynamic_cast<BitpreciseWrappedAbstractValue*>(wav_->Copy().get_ptr());
+  wali::ref_ptr<BitpreciseWrappedAbstractValue> this_av = dynamic_cast<BitpreciseWrappedAbstractValue*>(wav()->Copy().get_ptr());
   this_av->AddVocabulary(voc_temp1_2);
 
   // Add constraint 1*k_ = 1*temp1 and then havoc k_, so that essentially the key k_ is replaced with temp1
@@ -1046,7 +1202,7 @@ WrappedDomain_Int WrappedDomain_Int::lin_combine (const WrappedDomain_Int& that,
 
   // 2. Change the key k_ in right value to temp2 and add new keys k_ and temp1
   // Create a copy of that_av as we will be modifying it
-  wali::ref_ptr<BitpreciseWrappedAbstractValue> that_av = dynamic_cast<BitpreciseWrappedAbstractValue*>(that.wav_->Copy().get_ptr());
+  wali::ref_ptr<BitpreciseWrappedAbstractValue> that_av = dynamic_cast<BitpreciseWrappedAbstractValue*>(that.wav()->Copy().get_ptr());
   that_av->AddVocabulary(voc_temp1_2);
 
   // Add constraint 1*k_ = 1*temp2 and then havoc k_, so that essentially the key k_ is replaced with temp2
@@ -1089,7 +1245,7 @@ WrappedDomain_Int WrappedDomain_Int::lin_transform (mpz_class new_coeff, mpz_cla
 
   // 1. Change the key k_ in this to old_k
   // Create a copy of this_av as we will be modifying it
-  wali::ref_ptr<BitpreciseWrappedAbstractValue> this_av = dynamic_cast<BitpreciseWrappedAbstractValue*>(wav_->Copy().get_ptr());
+  wali::ref_ptr<BitpreciseWrappedAbstractValue> this_av = dynamic_cast<BitpreciseWrappedAbstractValue*>(wav()->Copy().get_ptr());
   this_av->AddDimension(old_k);
 
   // Add constraint 1*k_ = 1*old_k and then havoc k_, so that essentially the key k_ is replaced with old_k
@@ -1114,20 +1270,24 @@ WrappedDomain_Int WrappedDomain_Int::lin_transform (mpz_class new_coeff, mpz_cla
 }
 
 void WrappedDomain_Int::UpdateIntSignedness() {
+  // The signedness of a pending constant is updated by wav() when it adds its constraint
+  if(const_pending_)
+    return;
+
   Vocabulary voc_k; voc_k.insert(k_);
-  wav_->UpdateVocabularySignedness(voc_k);
+  wav()->UpdateVocabularySignedness(voc_k);
 }
 
 // ======
 // Output
 // ======
 std::ostream & WrappedDomain_Int::print(std::ostream & out) const {
-  wav_->print(out << "WrappedDomain_Int:");
+  wav()->print(out << "WrappedDomain_Int:");
   return out;
 }
 
 std::string WrappedDomain_Int::str() const {
-  std::string ret = std::string("WrappedDomain_Int:") + wav_->ToString();
+  std::string ret = std::string("WrappedDomain_Int:") + wav()->ToString();
   return ret;
 }
 
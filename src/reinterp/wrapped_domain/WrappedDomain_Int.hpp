@@ -39,6 +39,7 @@ public:
   WrappedDomain_Int bottom() const;
 
   // of_const: Make the WrappedDomain_Int representing the value 'c'
+  // The value is only added to the abstract value when it is needed, the operations on constants are folded.
   WrappedDomain_Int of_const(mpz_class c) const;
 
   // of_relation: Make the WrappedDomain_Int holding the constraints in 'state',
@@ -74,6 +75,7 @@ public:
   void widen(const WrappedDomain_Int& that);
   void meet(const WrappedDomain_Int& that);
   void wrap(bool is_signed); // wrap on k_ depending on the sign
+  void assume_wrapped(bool is_signed); // like wrap, for a k_ known to be in range, only adds the bounding constraints
 
   // is_equal tests for *relational equality*
   bool is_equal(const WrappedDomain_Int &) const;
@@ -141,6 +143,9 @@ public:
   WrappedDomain_Int bitwise_xor(const WrappedDomain_Int & that) const;
   WrappedDomain_Int bitwise_not() const;
 
+  // Signedness to wrap this and that with, for the operations that are correct with either signedness
+  bool preferred_signedness(const WrappedDomain_Int & that) const;
+
   // abs_equal: Return an abstract boolean representing "this == that".
   wali::ref_ptr<BitpreciseWrappedAbstractValue> abs_equal(const WrappedDomain_Int & that) const;
   wali::ref_ptr<BitpreciseWrappedAbstractValue> abs_not_equal(const WrappedDomain_Int & that) const;
@@ -169,6 +174,12 @@ public:
   std::string str() const;
 
 private:
+  // Returns wav_, after adding the constraint k_ = const_val_ of a pending constant to it
+  const wali::ref_ptr<BitpreciseWrappedAbstractValue>& wav() const;
+
+  // of_const with a key of bitsize b instead of k_
+  WrappedDomain_Int of_const(mpz_class c, utils::Bitsize b) const;
+
   WrappedDomain_Int lin_combine(const WrappedDomain_Int& that, 
                                 mpz_class new_coeff, mpz_class this_coeff,
                                 mpz_class that_coeff, mpz_class constant) const;
@@ -184,7 +195,13 @@ private:
   DimensionKey k_;
   bool wrapped_;
   bool wrapped_is_signed_;
-  wali::ref_ptr<BitpreciseWrappedAbstractValue> wav_;
+
+  // Known constant value of k_ (see of_const). While const_pending_ is set, the constraint k_ = const_val_ is not
+  // in wav_ yet and wav_ can be shared by the copies of this value, wav() adds the constraint to a copy.
+  bool is_const_;
+  mutable bool const_pending_;
+  mpz_class const_val_;
+  mutable wali::ref_ptr<BitpreciseWrappedAbstractValue> wav_;
 };
 
 #endif // src_reinterp_wrapped_domain_WrappedDomain_Int_hpp
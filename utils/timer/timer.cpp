@@ -1,4 +1,7 @@
 #include "utils/timer/timer.hpp"
+#if !defined(_WIN32)
+#include <unistd.h>
+#endif
 
 namespace utils {
 
@@ -61,4 +64,21 @@ namespace utils {
 #endif
   }
 
+  long getResidentMemory()
+  {
+#if defined(_WIN32)
+    return 0;
+#else
+    FILE* statm = fopen("/proc/self/statm", "r");
+    if(statm == NULL)
+      return 0;
+    long size = 0, resident = 0;
+    int num_read = fscanf(statm, "%ld %ld", &size, &resident);
+    fclose(statm);
+    if(num_read != 2)
+      return 0;
+    return resident * sysconf(_SC_PAGESIZE) / (1024 * 1024);
+#endif
+  }
+
 } //namespace utils 
@@ -34,5 +34,9 @@ namespace utils {
 
   double getRuntime(long* end, long* start);
 
+  // The current resident set size of the process in MB, 0 if it cannot be read. Unlike the ru_maxrss
+  // peak, it goes down again when memory is freed.
+  long getResidentMemory();
+
 } // namespace utils
 #endif // utils_timer_timer_hpp